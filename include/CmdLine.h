@@ -30,6 +30,11 @@ enum StartupMode
 	STARTUP_MULTI_PLAYER,
 	STARTUP_TEST,
 	STARTUP_DEMO,
+	STARTUP_BENCH,
+	STARTUP_REPLAY,
+	STARTUP_PATH_BENCH,
+	STARTUP_PLANT_BENCH,
+	STARTUP_BLIT_TEST,
 };
 
 struct CmdLine
@@ -38,6 +43,14 @@ struct CmdLine
 	int		game_speed;
 	StartupMode	startup_mode;
 	char		*join_host;
+	char		*bench_file;
+	char		*replay_file;
+	int		bench_frames;
+	char		*profile_file;
+	char		*path_bench_file;
+	char		*path_log_file;
+	int		plant_bench_days;
+	int		map_size;		// the width and height of the maps of new single player games, 0 for the standard size
 
 	CmdLine();
 	~CmdLine();
@@ -80,10 +80,12 @@ public:
 
 	// vga settings
 	char			vga_allow_highdpi;
+	char			vga_frame_interpolation;
 	char			vga_full_screen;
 	char			vga_keep_aspect_ratio;
 	char			vga_pause_on_focus_loss;
 
+	int			vga_render_threads;		// no. of threads drawing the zoom view besides the main one, -1 for one per extra core
 	int			vga_window_width;
 	int			vga_window_height;
 
@@ -30,6 +30,10 @@
 
 extern "C"
 {
+#ifndef USE_ASM
+	extern int IMGreferenceFlag;		// 1 to make the C versions draw pixel by pixel, for -blittest
+#endif
+
 	// not used : void IMGcall IMGinit(int,int);
 	void IMGcall IMGbar(char*,int pitch,int,int,int,int,int);
 	void IMGcall IMGread(char*,int pitch,int,int,int,int,char*);
@@ -0,0 +1,88 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OBANDRND.H
+//Description : Header file of Object BandRender, worker threads drawing horizontal bands of an area
+
+#ifndef __OBANDRND_H
+#define __OBANDRND_H
+
+#include <SDL.h>
+
+//----------- Define constants -----------//
+
+#define MAX_BAND_THREAD		7			// max. no. of worker threads, the main thread draws a band too
+
+//------- Define type BandDrawFunc -------//
+//
+// Draw the rows from row1 to row2 of an area. The function must only
+// write to the rows given to it and must not change any shared state.
+//
+typedef void (*BandDrawFunc)(void* drawPara, int row1, int row2);
+
+//------- Define struct BandThread -------//
+
+class BandRender;
+
+struct BandThread
+{
+	BandRender*	owner;
+	SDL_Thread*	thread;
+	SDL_sem*		start_sem;				// posted by run() when there is a band to draw
+	int			row1, row2;
+};
+
+//--------- Define class BandRender ---------//
+//
+// A pool of worker threads for drawing the bands of an area at the same
+// time. The threads are created on the first call of run(). If there
+// is only one core, or the threads cannot be created, run() draws the
+// whole area on the main thread.
+//
+class BandRender
+{
+public:
+	int			thread_count;			// no. of worker threads, -1 if they have not been created yet
+
+private:
+	BandThread	thread_array[MAX_BAND_THREAD];
+	SDL_sem*		done_sem;				// posted by a worker thread when it has drawn its band
+
+	BandDrawFunc draw_func;
+	void*			draw_para;
+	char			quit_flag;
+
+public:
+	BandRender();
+	~BandRender();
+
+	void		deinit();
+	void		run(BandDrawFunc drawFunc, void* drawPara, int rowCount);
+
+private:
+	void		init_thread();
+	static int	thread_main(void* threadPara);
+};
+
+extern BandRender band_render;
+
+//-------------------------------------------//
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OBENCH.H
+//Description : Header file for the headless simulation benchmark
+
+#ifndef __OBENCH_H
+#define __OBENCH_H
+
+#include <stdint.h>
+
+//----------- Define constants -------------//
+
+enum { DEFAULT_BENCH_FRAMES = 1000 };
+enum { DEFAULT_PLANT_BENCH_DAYS = 1000 };
+
+//---------- Define class Bench ----------//
+
+class Bench
+{
+public:
+	char		active_flag;
+
+	int		frame_limit;			// max. no. of frames to process, 0 for no limit
+	int		frame_count;			// no. of frames processed in the current run
+	uint64_t	total_time;				// total time of all processed frames, in performance counter ticks
+
+private:
+	uint64_t	frame_start_time;
+
+public:
+	Bench();
+
+	int		run(const char* filePath, int frameCount);
+	int		run_replay(char* filePath, int frameCount);
+	int		run_path(const char* filePath, const char* logFilePath);
+	int		run_plant(int dayCount);
+	int		run_blit();
+
+	void		begin_frame();
+	void		end_frame();
+
+	void		report(const char* filePath);
+	int		report_crc();
+
+private:
+	uint64_t	time_plant_ops(int dayCount);
+
+	void		make_blit_bitmap(char* bitmapBuf, int width, int height, int transPercent, int maxColor);
+	int		compress_blit_bitmap(char* destBuf, char* bitmapBuf);
+};
+
+extern Bench bench;
+
+//-----------------------------------------//
+
+#endif
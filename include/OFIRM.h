@@ -174,7 +174,7 @@ public:
 	short  loc_x1, loc_y1, loc_x2, loc_y2;
 	short  abs_x1, abs_y1, abs_x2, abs_y2;
 	short  center_x, center_y;
-	uint8_t	 region_id;
+	uint16_t region_id;
 
 	char   cur_frame;          // current animation frame id.
 	char   remain_frame_delay;
@@ -189,7 +189,7 @@ public:
 	short  overseer_recno;
 	short  overseer_town_recno;
 	short	 builder_recno;		// the recno of the builder
-	uint8_t 	 builder_region_id;	// the original region no. of builder
+	uint16_t	 builder_region_id;	// the original region no. of builder
 	float  productivity;
 
 	Worker* worker_array;
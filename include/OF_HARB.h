@@ -51,8 +51,8 @@ public:
 	char			 build_queue_array[MAX_BUILD_SHIP_QUEUE];	// it stores the unit id.
 	char			 build_queue_count;
 
-	uint8_t			 land_region_id;
-	uint8_t			 sea_region_id;
+	uint16_t			 land_region_id;
+	uint16_t			 sea_region_id;
 
 	//----------- for harbor trading ------------//
 
@@ -111,6 +111,8 @@ public:
 
 	enum {HARBOR_BUILD_BATCH_COUNT = 5}; // Number of units enqueued when holding shift - ensure this is less than MAX_BUILD_SHIP_QUEUE
 
+	int	read_derived_file(File* filePtr);
+
 	//-------------- multiplayer checking codes ---------------//
 	virtual	uint8_t crc8();
 	virtual	void	clear_ptr();
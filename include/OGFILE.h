@@ -68,6 +68,10 @@ private:
 
 public:
 	static bool read_file_same_version;				// true if major version of the game being loaded is same as that of the program
+	static short load_file_game_version;			// the version of the game being loaded
+
+	static int   read_region_id_record(File* filePtr, void* recArray, int recCount, int recSize, const int* regionIdOffsetArray, int regionIdCount);
+	static void  widen_region_id(void* recArray, int recCount, int recSize, const int* regionIdOffsetArray, int regionIdCount);
 
    // Static class has no constructors
 private:
@@ -74,7 +74,7 @@ public:
 	short	bitmap_width()		{ return *(short *)bitmap_ptr; }
 	short bitmap_height()	{ return *(((short *)bitmap_ptr)+1); }
 
-	void	draw(int xLoc, int yLoc, int layerMask=-1);
+	void	draw(int xLoc, int yLoc, int layerMask=-1, int clipY1=-1, int clipY2=-1);
 	void 	draw_at(int absBaseX, int absBaseY, int layerMask=-1);
 };
 
@@ -0,0 +1,93 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+//Filename    : OLINKGRD.H
+//Description : Header file of Object LinkGrid, coarse grid of firms and towns for link setup
+
+#ifndef __OLINKGRD_H
+#define __OLINKGRD_H
+
+#include <stdint.h>
+
+class Firm;
+class Town;
+
+//----------- Define constants -----------//
+
+#define LINK_GRID_CELL_SHIFT		3		// a cell of the grid covers 8x8 locations
+
+//--------- Define class LinkGrid --------//
+//
+// The map is divided into cells of 8x8 locations. Each cell keeps a list
+// of the firms and a list of the towns whose centers are in it. Firms
+// are added by Firm::init() and removed by Firm::deinit(), towns by
+// Town::init() and Town::deinit().
+//
+// It lets Firm::setup_link() and Town::setup_link() look only at the
+// firms and towns near them instead of all of them.
+//
+class LinkGrid
+{
+public:
+	int			cell_x_count, cell_y_count;
+
+	short*		cell_first_firm_array;		// [cell], recno of the first firm in each cell, 0 if none
+	short*		cell_first_town_array;		// [cell], recno of the first town in each cell, 0 if none
+	short*		next_firm_array;				// [firm recno], recno of the next firm in the same cell
+	short*		next_town_array;				// [town recno], recno of the next town in the same cell
+	int			next_firm_array_size;
+	int			next_town_array_size;
+
+	short*		near_recno_array;				// the result of near_firm() and near_town()
+	int			near_recno_array_size;
+
+private:
+	char			rebuild_flag;					// the lists are rebuilt from firm_array and town_array before they are next used
+
+public:
+	LinkGrid();
+	~LinkGrid();
+
+	void		init();
+	void		deinit();
+
+	void		add_firm(Firm* firmPtr);
+	void		del_firm(Firm* firmPtr);
+	void		add_town(Town* townPtr);
+	void		del_town(Town* townPtr);
+
+	int		near_firm(int xLoc, int yLoc, int locDistance);
+	int		near_town(int xLoc, int yLoc, int locDistance);
+
+private:
+	void		rebuild();
+	void		add_recno(short* firstArray, short*& nextArray, int& nextArraySize, int xLoc, int yLoc, int recno);
+	void		del_recno(short* firstArray, short* nextArray, int nextArraySize, int xLoc, int yLoc, int recno);
+	int		near_recno(short* firstArray, short* nextArray, int xLoc, int yLoc, int locDistance);
+	int		all_recno(int recnoCount);
+	int		get_cell(int xLoc, int yLoc)	{ return (yLoc >> LINK_GRID_CELL_SHIFT) * cell_x_count + (xLoc >> LINK_GRID_CELL_SHIFT); }
+};
+
+extern LinkGrid link_grid;
+
+//-----------------------------------------//
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OLOCSUM.H
+//Description : Header file of Object LocSum, counts of blocked locations in rectangles
+
+#ifndef __OLOCSUM_H
+#define __OLOCSUM_H
+
+#include <stdint.h>
+
+//----------- Define constants -----------//
+
+enum { LOC_SUM_LAND_UNIT,		// locations a land unit can't move onto, see World::check_unit_space()
+		 LOC_SUM_LAND_BUILD,		// the same, with buildFlag set in World::check_unit_space()
+		 LOC_SUM_BUILD_FIRM,		// locations Location::can_build_firm() returns 0 for
+		 LOC_SUM_BUILD_TOWN,		// locations Location::can_build_town() returns 0 for, it also rules out sites
+		 LOC_SUM_TYPE_COUNT };
+
+//--------- Define class LocSum --------//
+//
+// For each LOC_SUM_??? type, a two dimensional Fenwick tree keeps the no.
+// of blocked locations, so that the no. of blocked locations in any
+// rectangle is found with four prefix sums instead of a loop over the
+// rectangle. It is built from World::walk_matrix and is updated by
+// World::update_walk_matrix().
+//
+class LocSum
+{
+public:
+	int			x_count, y_count;
+
+	int32_t*		tree_array[LOC_SUM_TYPE_COUNT];		// [y_count+1][x_count+1] each, with 1-based indices
+
+public:
+	LocSum();
+	~LocSum();
+
+	void		init(uint8_t* walkMatrix, int xCount, int yCount);
+	void		deinit();
+
+	void		change_walk_bits(int xLoc, int yLoc, uint8_t oldBits, uint8_t newBits);
+
+	int		count(int sumType, int xLoc1, int yLoc1, int xLoc2, int yLoc2);
+	int		is_free(int sumType, int xLoc1, int yLoc1, int xLoc2, int yLoc2)
+					{ return tree_array[sumType] && !count(sumType, xLoc1, yLoc1, xLoc2, yLoc2); }
+
+	static int is_blocked(int sumType, uint8_t walkBits);
+
+private:
+	void		add(int32_t* treePtr, int xLoc, int yLoc, int addCount);
+	int		prefix_sum(int32_t* treePtr, int xLoc, int yLoc);
+};
+
+extern LocSum loc_sum;
+
+//-----------------------------------------//
+
+#endif
@@ -117,8 +117,8 @@ public:
 	char		flammability;				// -100 to 100, likelihood of fire
 
 	char		power_nation_recno;		// 0-no nation has power over this location
-	uint8_t		region_id;
-	unsigned char visit_level;			// drop from FULL_VISIBILITY to 0
+	uint16_t		region_id;
+	unsigned char visit_level;			// the level when it was last raised, it drops from FULL_VISIBILITY*2 to EXPLORED_VISIBILITY*2 one per frame after that
 
 public:
 	//------ functions that check the type of the location ------//
@@ -129,7 +129,8 @@ public:
 									{ return loc_flag & teraMask; }
 	void	walkable_reset();
 	// void	walkable_on()		{ loc_flag |= LOCATE_WALK_LAND; }
-	void	walkable_off()		{ loc_flag &= ~(LOCATE_WALK_LAND | LOCATE_WALK_SEA); }
+	void	walkable_off()		{ loc_flag &= ~(LOCATE_WALK_LAND | LOCATE_WALK_SEA); walkable_changed(); }
+	void	walkable_changed();
 
 	void	walkable_on(int teraMask)		{ loc_flag |= teraMask; }
 	void	walkable_off(int teraMask)		{ loc_flag &= ~teraMask; }
@@ -144,10 +145,14 @@ public:
 	void	explored_off()		{ visit_level = 0; }
 
 	// ---------- visibility --------//
-	unsigned char visibility()				{ return visit_level/2; }
-	void	dec_visibility()					{ if( visit_level > EXPLORED_VISIBILITY*2) --visit_level; }
-	void	set_visited()						{ visit_level = MAX_VISIT_LEVEL*2; }
-	void	set_visited(unsigned char v)	{ if( visit_level < v*2) visit_level = v*2; }
+	// visit_level is not dropped every frame, the current level is
+	// calculated from the no. of frames since it was last raised.
+	// Use World::get_visibility() and World::set_visited().
+
+	unsigned char cur_visit_level(uint32_t elapsedFrames)
+			{ return visit_level <= EXPLORED_VISIBILITY*2 ? visit_level :
+						elapsedFrames < uint32_t(visit_level - EXPLORED_VISIBILITY*2) ? visit_level - elapsedFrames : EXPLORED_VISIBILITY*2; }
+	unsigned char visibility(uint32_t elapsedFrames)	{ return cur_visit_level(elapsedFrames)/2; }
 
 	int	is_plateau();
 
@@ -258,12 +263,16 @@ public:
 	// --------- functions on fire ---------//
 	char	fire_str()						{ return fire_level; }
 	char	fire_src()						{ return flammability; }
-	void	set_fire_str(char str)		{ fire_level = str; }
-	void	set_fire_src(char src)		{ flammability = src; }
-	void	add_fire_str(char str)		{ fire_level += str; }
-	void	add_fire_src(char src)		{ flammability += src; }
+	void	set_fire_str(char str);
+	void	set_fire_src(char src);
+	void	add_fire_str(char str);
+	void	add_fire_src(char src);
 	int	can_set_fire()					{ return flammability >= -50; }
 
+	// whether World::spread_fire() would leave the location unchanged,
+	// it neither burns, cools down nor restores its flammability
+	int	is_fire_idle()					{ return fire_level == -100 && (flammability < -30 || flammability >= 50); }
+
 	//----- functions whose results affected by mobile_type -----//
 
 	//int   is_blocked(int mobileType)    { return mobileType==UNIT_AIR ? air_cargo_recno : cargo_recno; }     // return 1 or 0 (although both are the same)
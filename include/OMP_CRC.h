@@ -64,7 +64,7 @@ struct FirmCrc
 	short		abs_y2;
 	short		center_x;
 	short		center_y;
-	uint8_t		region_id;
+	uint16_t	region_id;
 
 	char		cur_frame;
 	char		remain_frame_delay;
@@ -77,7 +77,7 @@ struct FirmCrc
 	short		overseer_recno;
 	short		overseer_town_recno;
 	short		builder_recno;
-	uint8_t		builder_region_id;
+	uint16_t	builder_region_id;
 	float		productivity;
 
 	char		worker_count;
@@ -161,8 +161,8 @@ struct FirmHarborCrc : FirmCrc
 	char		build_queue_array[MAX_BUILD_SHIP_QUEUE];
 	char		build_queue_count;
 
-	uint8_t		land_region_id;
-	uint8_t		sea_region_id;
+	uint16_t	land_region_id;
+	uint16_t	sea_region_id;
 
 	char		link_checked;
 	char		linked_mine_num;
@@ -0,0 +1,186 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OPROFILE.H
+//Description : Header file for the hierarchical frame profiler
+
+#ifndef __OPROFILE_H
+#define __OPROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+//----------- Define constants -------------//
+
+enum { MAX_PROFILE_NAME  = 256,
+		 MAX_PROFILE_NODE  = 1024,
+		 MAX_PROFILE_DEPTH = 32,
+		 MAX_PROFILE_COUNTER = 64,
+		 MAX_PROFILE_EVENT = 65536,		// size of the event ring buffer, must be a power of 2
+	  };
+
+//--------- Define struct ProfileNode ----------//
+//
+// A node of the timer tree. There is one node for each distinct call
+// path, so the same scope reached from two different parents will be
+// accumulated separately.
+//
+struct ProfileNode
+{
+	short		name_id;
+	short		parent_id;
+	short		first_child_id;
+	short		next_sibling_id;
+
+	uint32_t	call_count;
+	uint64_t	total_time;				// in performance counter ticks
+};
+
+//--------- Define struct ProfileEvent ----------//
+
+struct ProfileEvent
+{
+	short		node_id;
+	short		depth;
+	uint32_t	frame_count;
+	uint64_t	start_time;
+	uint64_t	end_time;
+};
+
+//--------- Define struct ProfileCounter ----------//
+//
+// An event count, such as cache hits, accumulated over the run.
+//
+struct ProfileCounter
+{
+	short		name_id;
+	uint64_t	total;
+};
+
+//---------- Define class Profiler ----------//
+
+class Profiler
+{
+public:
+	char			enable_flag;
+
+	int			node_count;
+	ProfileNode	node_array[MAX_PROFILE_NODE];
+
+	int				counter_count;
+	ProfileCounter	counter_array[MAX_PROFILE_COUNTER];
+
+private:
+	int			name_count;
+	const char*	name_array[MAX_PROFILE_NAME];
+
+	int			cur_node_id;
+	int			cur_depth;
+	int			skip_depth;			// no. of nested scopes which could not be recorded
+	uint64_t		start_time_array[MAX_PROFILE_DEPTH];
+
+	ProfileEvent*	event_array;		// ring buffer of the most recent timed scopes
+	uint32_t		event_count;			// total no. of events recorded, the ring buffer index is event_count%MAX_PROFILE_EVENT
+
+	uint64_t		base_time;
+
+public:
+	Profiler();
+	~Profiler();
+
+	void		init();
+	void		deinit();
+	void		reset();
+
+	int		add_name(const char* name);
+
+	void		begin(int nameId);
+	void		end();
+	void		add_count(int nameId, int addCount);
+
+	int		dump_trace(const char* filePath);
+	void		print_tree(FILE* filePtr, int frameCount);
+
+	static uint64_t get_counter();
+	static uint64_t get_frequency();
+
+private:
+	int		get_child(int parentId, int nameId);
+	void		print_node(FILE* filePtr, int nodeId, int depth, int frameCount, uint64_t rootTime, double freq);
+};
+
+extern Profiler profiler;
+
+//---------- Define class ProfileScope ----------//
+//
+// Time the enclosing block. Use the PROFILE_SCOPE() macro instead of
+// declaring it directly.
+//
+class ProfileScope
+{
+private:
+	char	active_flag;
+
+public:
+	ProfileScope(int nameId)
+	{
+		active_flag = profiler.enable_flag;
+		if( active_flag )
+			profiler.begin(nameId);
+	}
+
+	~ProfileScope()
+	{
+		if( active_flag )
+			profiler.end();
+	}
+};
+
+//---------- Define profiling macros ----------//
+//
+// PROFILE_SCOPE(name) - time from this point to the end of the enclosing block
+// PROFILE_BEGIN(name) - begin timing a section, must be paired with PROFILE_END
+// PROFILE_END()       - end timing the last section begun by PROFILE_BEGIN
+// PROFILE_COUNT(name,n) - add n to the counter of the given name
+//
+// <name> must be a string literal. Its id is looked up once per call site.
+//
+
+#define PROFILE_CONCAT2(a,b)	a##b
+#define PROFILE_CONCAT(a,b)	PROFILE_CONCAT2(a,b)
+
+#define PROFILE_SCOPE(name) \
+	static int PROFILE_CONCAT(profile_name_id_,__LINE__) = profiler.add_name(name); \
+	ProfileScope PROFILE_CONCAT(profile_scope_,__LINE__)(PROFILE_CONCAT(profile_name_id_,__LINE__))
+
+#define PROFILE_BEGIN(name) \
+	do { static int profileNameId = profiler.add_name(name); \
+		if( profiler.enable_flag ) profiler.begin(profileNameId); } while(0)
+
+#define PROFILE_END() \
+	do { if( profiler.enable_flag ) profiler.end(); } while(0)
+
+#define PROFILE_COUNT(name,n) \
+	do { static int profileNameId = profiler.add_name(name); \
+		if( profiler.enable_flag ) profiler.add_count(profileNameId, n); } while(0)
+
+//-----------------------------------------//
+
+#endif
@@ -35,7 +35,7 @@
 
 //---------- define constant ---------//
 
-#define MAX_REGION 	255
+#define MAX_REGION 	65535
 
 //------- Define enum RegionType -------//
 
@@ -51,8 +51,8 @@ enum RegionType
 #pragma pack(1)
 struct RegionInfo
 {
-	uint8_t				region_id;
-	uint8_t				region_stat_id;
+	uint16_t			region_id;
+	uint16_t			region_stat_id;
 
 	RegionType		region_type;
 	int				adj_offset_bit;
@@ -79,7 +79,9 @@ public:
 	int				region_stat_count;
 
 	unsigned char *connect_bits;
-	uint8_t		 		region_sorted_array[MAX_REGION]; 	// an array of region id. sorted by the region size
+	uint16_t*		region_sorted_array; 	// [region_info_count], an array of region id. sorted by the region size
+
+	uint16_t*		sea_path_matrix;		// [region_stat_count][region_stat_count], id. of the sea region linking two land regions, 0 if none
 
 public:
 	RegionArray();
@@ -96,9 +98,13 @@ public:
 	int	is_adjacent(int reg1, int reg2);
 	void	sort_region();
 
+	static int connect_bit_count(int regionCount);
+
 	void 	init_region_stat();
 	void 	update_region_stat();
+	void 	update_region_stat(int regionId);
 
+	void	init_region_path();
 	int 	get_sea_path_region_id(int regionId1, int regionId2);
 	int	nation_has_base_town(int regionId, int nationRecno);
 
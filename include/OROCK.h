@@ -47,7 +47,7 @@ public:
 	void	init(short rockRecno, short xLoc, short yLoc);	// cur_frame init to 1, and initDelay is random
 	void	process();
 	void	draw();
-	void	draw_block(short xLoc, short yLoc);
+	void	draw_block(short xLoc, short yLoc, int clipY1=-1, int clipY2=-1);
 
 private:
 	unsigned random(unsigned);
@@ -130,7 +130,7 @@ struct RockBitmapInfo
 
 	short width()     { return *(short *)bitmap_ptr; }
 	short height()    { return *(((short *)bitmap_ptr)+1); }
-	void	draw(short xLoc, short yLoc);
+	void	draw(short xLoc, short yLoc, int clipY1=-1, int clipY2=-1);
 };
 
 // ------------ Define struct RockAnimInfo --------//
@@ -182,7 +182,7 @@ public:
 	char             choose_next(short rockRecno, char curFrame, long path);
 	void             draw(short rockRecno, short xLoc, short yLoc, char curFrame);
 	void             draw_block(short rockRecno, short xLoc, short yLoc,
-		short offsetX, short offsetY, char curFrame);
+		short offsetX, short offsetY, char curFrame, int clipY1=-1, int clipY2=-1);
 
 	RockBlockInfo*   operator[](short rockBlockRecno)
 		{ return rock_block_array + rockBlockRecno -1; }
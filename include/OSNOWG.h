@@ -62,7 +62,7 @@ public:
 class SnowGroundArray
 {
 private:
-	unsigned	seed;
+	unsigned	seed;			// not used, has_snow() keeps its seed on the stack so that it can be called by more than one thread
 
 public:
 	int32_t snow_thick;
@@ -79,7 +79,7 @@ public:
 	int	read_file(File* filePtr);
 
 private:
-	unsigned rand_seed();
+	static unsigned rand_seed(unsigned& randSeed);
 };
 #pragma pack()
 
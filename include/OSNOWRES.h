@@ -74,7 +74,7 @@ struct SnowInfo
 	SnowInfo *		rand_prev_ptr(unsigned rand)	{ return is_root() ? NULL : prev_file[rand % prev_count]; }
 	short				bitmap_width() { return *(short *)bitmap_ptr; }
 	short				bitmap_height() { return *(((short *)bitmap_ptr)+1); }
-	void				draw_at(short absX, short absY);
+	void				draw_at(short absX, short absY, int clipY1=-1, int clipY2=-1);
 };
 
 
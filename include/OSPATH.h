@@ -86,9 +86,14 @@ enum	{	SEARCH_SUB_MODE_NORMAL=0,
 #define VALID_BACKGROUND_SEARCH_NODE	1600		// the search is considered unsuccessful if the node used > this value
 #define MIN_BACKGROUND_NODE_USED_UP		400		// don't do any new search if the current available nodes is < this value
 
+#define MAX_RESUMABLE_SEARCH_NODE		(MAX_BACKGROUND_NODE*3)	// the max. no. of nodes a search resumed over several frames can use in total
+#define RESUMED_SEARCH_NODE_PER_FRAME	800		// the max. no. of nodes a resumed search can use in a frame, so that it doesn't starve the searches of other units
+#define MAX_SUSPENDED_SEARCH				4			// the max. no. of searches which can be suspended at a time
+#define SUSPENDED_SEARCH_EXPIRY			10			// a suspended search is discarded if it is not resumed within this no. of frames
+
 #define MAX_CHILD_NODE    8		// one for each direction
 //#define MAX_STACK_NUM  2000		// maximum no. of stack entity in stack_aray, which is shared by all SeekPath objects. It is calculated based on: MAX possiblity: 500(MAX node) x 8(MAX child node) = 4000. Practical no. possiblities=2000. Memory occupied: 2000*4 = 8K
-#define MAX_STACK_NUM  MAX_BACKGROUND_NODE	// maximum no. of stack entity in stack_aray, which is shared by all SeekPath objects. It is calculated based on: MAX possiblity: 500(MAX node) x 8(MAX child node) = 4000. Practical no. possiblities=2000. Memory occupied: 2000*4 = 8K
+#define MAX_STACK_NUM  MAX_RESUMABLE_SEARCH_NODE	// maximum no. of stack entity in stack_aray, which is shared by all SeekPath objects. It is calculated based on: MAX possiblity: 500(MAX node) x 8(MAX child node) = 4000. Practical no. possiblities=2000. Memory occupied: 2000*4 = 8K
 
 //---------- Define class Node -----------//
 
@@ -99,6 +104,8 @@ public:
 	int   node_f, node_h;// could be replaced by "unsigned short" to reduce memory, set all member vars to "unsigned short" for consistency
 	short	node_g;
 	char	node_type;// the type of the node, total 16 different type, 4 points in a 2x2 node, blocked/non-blocked, so there are 2^4 combinations
+	char	closed_flag;	// whether the node is in the closed list instead of the open list
+	int	heap_pos;		// the position of the node in elements[] of the open or closed list
 	char	enter_direction;
 	// enter_direction -- 1-8 for eight directions, 0 for the starting node
 	//
@@ -143,7 +150,7 @@ struct Stack
 
 struct NodePriorityQueue
 {
-	#define MAX_ARRAY_SIZE	MAX_BACKGROUND_NODE+1
+	#define MAX_ARRAY_SIZE	MAX_RESUMABLE_SEARCH_NODE+1
 	public:
 		unsigned int	size;
 		Node	*elements[MAX_ARRAY_SIZE];
@@ -151,6 +158,7 @@ struct NodePriorityQueue
 	public:
 		void	reset_priority_queue();
 		void	insert_node(Node *insertNode);
+		void	decrease_key(Node *nodePtr);
 		Node*	return_min();
 };
 
@@ -174,6 +182,8 @@ public:
 	static NodePriorityQueue	closed_node_list;
 
 	short* node_matrix;
+	uint16_t* node_stamp_matrix;	// an entry of node_matrix is only valid if its stamp equals node_stamp
+	uint16_t	 node_stamp;
 	Node*  node_array;
 
 	int	max_node;
@@ -184,6 +194,8 @@ public:
 	short	total_node_avail;
 	void	reset_total_node_avail();
 
+	short	resume_owner_recno;		// sprite recno of the unit whose search can be suspended and resumed in later frames, 0 if the search must complete in one call
+
 private:
 	ResultNode* max_size_result_node_ptr;	// point to the temprory result node list
 	ResultNode* parent_result_node_ptr;		// the parent node of the currently node pointed by max_size_result_node_ptr
@@ -191,7 +203,7 @@ private:
 	int	upper_left_y;	// y coord. of upper left corner of the 2x2 node
 
 public:
-	SeekPath() 		{ node_array=NULL; node_matrix=NULL; }
+	SeekPath() 		{ node_array=NULL; node_matrix=NULL; node_stamp_matrix=NULL; node_stamp=0; resume_owner_recno=0; }
 	~SeekPath()		{ deinit(); }
 
 	void  init(int maxNode);
@@ -217,9 +229,15 @@ public:
 
 	void	set_attack_range_para(int attackRange);
 	void	reset_attack_range_para();
+	int	get_attack_range_para();
 	void	set_nation_recno(char nationRecno);
 	void	set_nation_passable(char nationPassable[]);
 	void	set_sub_mode(char subMode=SEARCH_SUB_MODE_NORMAL);
+	void	set_resume_owner(short spriteRecno=0)	{ resume_owner_recno = spriteRecno; }
+	int	is_territory_passable(int xLoc, int yLoc);
+	char	get_sub_mode();
+	char*	get_nation_passable();		// MAX_NATION+1 entries, entry 0 is not used
+	void	clear_suspended_search();
 
    int   write_file(File* filePtr);
    int   read_file(File* filePtr);
@@ -227,6 +245,12 @@ public:
 private:
 	static Node* return_best_node();
 
+	int	suspend_search();
+	int	resume_search();
+	int	write_suspended_search(File* filePtr);
+	int	read_suspended_search(File* filePtr);
+	void	reset_node_matrix();
+
 	void	get_real_result_node(int &count, short enterDirection, short exitDirection, short nodeType, short xCoord, short yCoord);
 	// function used to get the actual shortest path out of the 2x2 node path
 
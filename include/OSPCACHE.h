@@ -0,0 +1,126 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPCACHE.H
+//Description : Header file of Object SeekPathCache, cache of path seeking results
+
+#ifndef __OSPCACHE_H
+#define __OSPCACHE_H
+
+#include <stdint.h>
+#include <GAMEDEF.h>
+
+struct ResultNode;
+class File;
+
+//----------- Define constants -----------//
+
+#define PATH_CACHE_SIZE				64		// max. no. of paths kept in the cache
+#define PATH_CACHE_BUCKET			128	// no. of hash buckets, must be a power of 2
+#define PATH_CACHE_CELL_SHIFT		3		// the start and the destination are grouped into cells of 8x8 locations
+#define PATH_CACHE_MIN_DIST		10		// shorter paths are not worth caching
+#define PATH_CACHE_MAX_NODE		100	// paths with more turning points are not cached
+#define PATH_CACHE_FREE_ENTRY		-2		// value of PathCacheEntry::next_entry of a free entry
+
+//------- Define struct PathCacheEntry --------//
+
+struct PathCacheEntry
+{
+	short			next_entry;						// next entry in the same hash bucket, -1 for none, -2 if this entry is free
+	uint32_t		last_use;
+
+	//---------- the key of the entry ---------//
+
+	char			mobile_type;
+	uint16_t		region_id;
+	short			sour_cell, dest_cell;		// coarse cell ids of the start and the destination
+
+	//------ the search the path was found by ------//
+
+	short			sour_x_loc, sour_y_loc;
+	short			dest_x_loc, dest_y_loc;
+	short			search_mode;
+	short			misc_no;
+	short			num_of_path;
+	char			sub_mode;
+	char			nation_passable[MAX_NATION+1];
+
+	//------------- the path --------------//
+
+	short			x_loc1, y_loc1, x_loc2, y_loc2;	// bounding rectangle of the path
+	short			path_dist;
+	short			node_count;
+	ResultNode*	node_array;
+};
+
+//--------- Define class SeekPathCache --------//
+//
+// Units are often ordered between the same places again and again, such as
+// workers going to a firm and caravans trading between two firms. The
+// paths found by SeekPath are kept in a least recently used cache keyed by
+// mobile type, region and the coarse cells of the start and the
+// destination. A cached path is returned to a unit which starts on it or
+// next to its start and moves to the same destination with the same
+// search parameters.
+//
+// A path is dropped when the walkability of a location within its
+// bounding rectangle changes, or for a path found in
+// SEARCH_SUB_MODE_PASSABLE, when the territory there changes.
+//
+class SeekPathCache
+{
+public:
+	PathCacheEntry	entry_array[PATH_CACHE_SIZE];
+	short				bucket_array[PATH_CACHE_BUCKET];	// the first entry of each hash bucket, -1 for none
+	uint32_t			use_count;
+
+public:
+	SeekPathCache();
+	~SeekPathCache();
+
+	void		deinit();
+	void		clear();
+
+	ResultNode* get_path(int sx, int sy, int dx, int dy, char mobileType, short searchMode, short miscNo, short numOfPath,
+								char subMode, char* nationPassable, int& resultNodeCount, short& pathDist);
+	void		add_path(int sx, int sy, int dx, int dy, char mobileType, short searchMode, short miscNo, short numOfPath,
+								char subMode, char* nationPassable, ResultNode* nodeArray, int nodeCount, short pathDist);
+
+	void		invalidate_loc(int xLoc, int yLoc);
+	void		invalidate_power(int xLoc1, int yLoc1, int xLoc2, int yLoc2);
+
+	static int is_cacheable(short searchMode, char mobileType);
+
+	int		write_file(File* filePtr);
+	int		read_file(File* filePtr);
+
+private:
+	int		get_bucket(char mobileType, int regionId, int sourCell, int destCell);
+	void		del_entry(int entryId);
+	int		find_start_node(PathCacheEntry* entryPtr, int sx, int sy, int& skipDist);
+
+	static int get_cell(int xLoc, int yLoc);
+};
+
+extern SeekPathCache seek_path_cache;
+
+//-----------------------------------------//
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPFLOW.H
+//Description : Header file of Object FlowField, shared movement field for large group orders
+
+#ifndef __OSPFLOW_H
+#define __OSPFLOW_H
+
+#include <stdint.h>
+#include <GAMEDEF.h>
+
+struct ResultNode;
+class File;
+
+//----------- Define constants -----------//
+
+#define FLOW_FIELD_MIN_UNIT		50		// a group move order of this many land units or more uses a flow field
+#define MAX_FLOW_FIELD				4		// max. no. of flow fields kept at the same time
+#define FLOW_FIELD_LOCAL_DIST		6		// a unit leaves the field and seeks its own formation location within this distance of the destination
+#define FLOW_FIELD_UNREACHED		0xFFFF
+#define FLOW_DIR_NONE				0xFF
+
+//------- Define struct FlowFieldInfo --------//
+
+struct FlowFieldInfo
+{
+	uint32_t		group_id;					// 0 if the slot is not used
+	short			dest_x_loc, dest_y_loc;
+	short			dest_radius;				// the formation locations of the units are within this distance of the destination
+	uint16_t		region_id;
+	char			dirty_flag;					// the walkability of a location reached by the field has changed
+	char			sub_mode;					// SEARCH_SUB_MODE_PASSABLE if the field only passes territories in nation_passable[]
+	char			nation_passable[MAX_NATION+1];
+	uint32_t		last_use;
+
+	uint16_t*	dist_matrix;				// integration field, no. of steps from each location to the destination
+	uint8_t*		dir_matrix;					// direction field, the direction to move from each location, FLOW_DIR_NONE at the destination or if unreached
+};
+
+//--------- Define class FlowField --------//
+//
+// When a large group of land units is ordered to move, the distance from
+// every location of the region to the destination is calculated once by
+// a breadth-first search from the destination. All units of the group
+// then follow the direction field downhill instead of each seeking its
+// own path. Only terrain is considered; a unit steps aside to another
+// location of the same distance if its next location is occupied.
+//
+class FlowField
+{
+public:
+	FlowFieldInfo	field_array[MAX_FLOW_FIELD];
+	uint32_t			use_count;
+
+private:
+	int*				queue_array;				// queue of location indexes for the breadth-first search
+
+public:
+	FlowField();
+	~FlowField();
+
+	void		init();
+	void		deinit();
+	void		clear();
+
+	int		build(uint32_t groupId, int destXLoc, int destYLoc, int destRadius, short nationRecno);
+	void		invalidate_loc(int xLoc, int yLoc);
+
+	ResultNode* get_path(uint32_t groupId, int sx, int sy, int dx, int dy, int& resultNodeCount, short& pathDist);
+
+	int		write_file(File* filePtr);
+	int		read_file(File* filePtr);
+
+private:
+	FlowFieldInfo* get_field(uint32_t groupId, int regionId);
+	void		cal_field(FlowFieldInfo* fieldPtr);
+	int		is_passable(FlowFieldInfo* fieldPtr, int xLoc, int yLoc);
+	int		get_next_loc(FlowFieldInfo* fieldPtr, int xLoc, int yLoc, int checkUnit);
+};
+
+extern FlowField flow_field;
+
+//-----------------------------------------//
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPHPA.H
+//Description : Header file of Object SeekPathHPA, the cluster layer of hierarchical path seeking
+
+#ifndef __OSPHPA_H
+#define __OSPHPA_H
+
+#include <stdint.h>
+
+//----------- Define constants -----------//
+
+#define HPA_CLUSTER_SIZE			16		// width and height of a cluster, in locations
+#define MAX_BORDER_TRANSITION		8		// max. no. of transitions on the border between two clusters, HPA_CLUSTER_SIZE/2
+#define MAX_CLUSTER_ENTRANCE		(MAX_BORDER_TRANSITION*4)
+#define HPA_LONG_TRANSITION		6		// a passable border segment of this length or longer gets a transition at each end instead of one in the middle
+#define HPA_MIN_SEEK_DIST			(HPA_CLUSTER_SIZE*2)	// the cluster layer is only used for destinations further than this
+#define HPA_WAY_POINT_DIST			(HPA_CLUSTER_SIZE*2)	// the max. distance between a unit and the way point of its next local search
+#define HPA_UNREACHABLE				0xFF
+
+enum { HPA_LAYER_LAND, HPA_LAYER_SEA, HPA_LAYER_COUNT };
+
+enum { HPA_CLEAN, HPA_DIRTY_ENTRANCE, HPA_DIRTY_TERRAIN };	// values of HpaCluster::dirty_flag
+
+enum { HPA_BORDER_EAST, HPA_BORDER_SOUTH };
+
+//------- Define struct HpaTransition --------//
+//
+// A place where units can cross the border between two clusters.
+//
+struct HpaTransition
+{
+	short	x_loc1, y_loc1;			// the location in the west or north cluster
+	short	x_loc2, y_loc2;			// the location in the east or south cluster
+	char	entrance1, entrance2;	// the entrance id. of the transition in the two clusters
+};
+
+//------- Define struct HpaBorder --------//
+
+struct HpaBorder
+{
+	char				transition_count;
+	HpaTransition	transition_array[MAX_BORDER_TRANSITION];
+};
+
+//------- Define struct HpaEntrance --------//
+
+struct HpaEntrance
+{
+	short	x_loc, y_loc;
+	short	border_cluster_id;		// the border is stored with the west or north cluster of the two
+	char	border_dir;					// HPA_BORDER_EAST or HPA_BORDER_SOUTH
+	char	transition_id;
+	char	side;							// 1 - this cluster is the west or north one, 2 - the east or south one
+	short	neighbor_cluster_id;
+};
+
+//------- Define struct HpaCluster --------//
+
+struct HpaCluster
+{
+	char			dirty_flag;
+	char			entrance_count;
+	HpaEntrance	entrance_array[MAX_CLUSTER_ENTRANCE];
+	uint8_t		dist_matrix[MAX_CLUSTER_ENTRANCE][MAX_CLUSTER_ENTRANCE];	// no. of steps between two entrances within the cluster, HPA_UNREACHABLE if they are not connected
+};
+
+//------- Define struct HpaOpenNode --------//
+
+struct HpaOpenNode
+{
+	int	node_f;
+	int	node_id;
+};
+
+//--------- Define class SeekPathHPA --------//
+//
+// The map is divided into clusters of HPA_CLUSTER_SIZE x HPA_CLUSTER_SIZE
+// locations. Entrances on the cluster borders and the distances between
+// the entrances of each cluster are precomputed for land and for sea, so
+// a long path can be found on this small graph first. SeekPath then only
+// has to search to the next way point of it.
+//
+// Only terrain is considered, units are left to SeekPath. A cluster is
+// rebuilt when the walkability of any location in it has changed.
+//
+class SeekPathHPA
+{
+public:
+	int			cluster_x_count, cluster_y_count;
+	int			cluster_count;
+
+	HpaCluster*	cluster_array[HPA_LAYER_COUNT];
+	HpaBorder*	east_border_array[HPA_LAYER_COUNT];		// the border between cluster (x,y) and (x+1,y), indexed by the cluster id. of (x,y)
+	HpaBorder*	south_border_array[HPA_LAYER_COUNT];	// the border between cluster (x,y) and (x,y+1)
+	char			layer_dirty_flag[HPA_LAYER_COUNT];		// whether any cluster of the layer is dirty
+
+private:
+	//------- vars for searching the cluster graph -------//
+
+	int			node_count;				// cluster_count*MAX_CLUSTER_ENTRANCE entrance nodes + 1 goal node
+	int*			node_g_array;
+	int*			node_parent_array;
+	uint32_t*	node_stamp_array;		// cur_stamp - opened in the current search, cur_stamp+1 - closed
+	uint32_t		cur_stamp;
+
+	HpaOpenNode* open_heap;				// open_heap[1] is the top
+	int			open_heap_size;
+	int			open_heap_max;
+
+	int*			path_node_array;
+
+	uint8_t		start_dist_array[MAX_CLUSTER_ENTRANCE];
+	uint8_t		goal_dist_array[MAX_CLUSTER_ENTRANCE];
+	uint8_t		loc_dist_array[HPA_CLUSTER_SIZE*HPA_CLUSTER_SIZE];
+	short			loc_queue_array[HPA_CLUSTER_SIZE*HPA_CLUSTER_SIZE];
+
+public:
+	SeekPathHPA();
+	~SeekPathHPA();
+
+	void		init();
+	void		deinit();
+
+	void		invalidate_loc(int xLoc, int yLoc);
+	int		get_way_point(int sx, int sy, int dx, int dy, char mobileType, int& wayXLoc, int& wayYLoc);
+
+private:
+	void		update_layer(int layer);
+	void		scan_border(int layer, int clusterId, int borderDir, HpaBorder* borderPtr);
+	void		build_cluster(int layer, int clusterId);
+	void		add_entrance(HpaCluster* clusterPtr, HpaBorder* borderPtr, int borderClusterId, int borderDir, int side, int neighborClusterId);
+	void		cal_loc_dist(int layer, int clusterId, int xLoc, int yLoc);
+	void		cal_entrance_dist(int layer, int clusterId, int xLoc, int yLoc, uint8_t* distArray);
+
+	int		search_graph(int layer, int startClusterId, int goalClusterId, int dx, int dy);
+	void		open_node(int nodeId, int nodeG, int parentId, int nodeH);
+
+	int		get_cluster_id(int xLoc, int yLoc)	{ return (yLoc/HPA_CLUSTER_SIZE)*cluster_x_count + xLoc/HPA_CLUSTER_SIZE; }
+};
+
+extern SeekPathHPA seek_path_hpa;
+
+//-----------------------------------------//
+
+#endif
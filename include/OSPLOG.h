@@ -0,0 +1,86 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPLOG.H
+//Description : Header file of Object SeekPathLog, recording and replaying path seeking queries
+
+#ifndef __OSPLOG_H
+#define __OSPLOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <GAMEDEF.h>
+
+//----------- Define constants -----------//
+
+#define SEEK_PATH_LOG_VERSION		1
+
+//------- Define struct SeekPathQuery --------//
+
+struct SeekPathQuery
+{
+	uint32_t	frame_count;
+	short		sour_x_loc, sour_y_loc;
+	short		dest_x_loc, dest_y_loc;
+	uint32_t	group_id;
+	char		mobile_type;
+	short		search_mode;
+	short		misc_no;
+	short		num_of_path;
+	int		max_tries;
+	int		attack_range;
+	char		sub_mode;
+	char		nation_passable[MAX_NATION+1];
+};
+
+//--------- Define class SeekPathLog --------//
+//
+// When recording, every search issued by Unit::searching() is written to
+// a text log, one query per line. The log can then be replayed against
+// the saved game it was recorded from to time SeekPath on its own.
+//
+class SeekPathLog
+{
+public:
+	FILE*		record_file;
+
+public:
+	SeekPathLog();
+	~SeekPathLog();
+
+	int		open(const char* filePath);
+	void		close();
+	int		is_recording()		{ return record_file!=NULL; }
+
+	void		record(int sx, int sy, int dx, int dy, uint32_t groupId, char mobileType,
+						 short searchMode, short miscNo, short numOfPath, int maxTries);
+
+	int		replay(const char* filePath);
+
+private:
+	static int read_query(FILE* filePtr, SeekPathQuery* queryPtr);
+	static int compare_time(const void* a, const void* b);
+};
+
+extern SeekPathLog seek_path_log;
+
+//-----------------------------------------//
+
+#endif
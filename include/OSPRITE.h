@@ -108,6 +108,8 @@ public:
 	static short abs_x1, abs_y1;	// the absolute postion, taking in account of sprite offset
 	static short abs_x2, abs_y2;
 
+	static short draw_fraction;	// 0-255, how far the display time has gone from the current frame to the next, for interpolating the positions of moving sprites
+
 public:
 			  Sprite();
 	virtual ~Sprite();
@@ -140,6 +142,8 @@ public:
 
 			  void	set_remain_attack_delay();
 	virtual void	update_abs_pos(SpriteFrame* =0);
+			  void	get_draw_offset(int* offsetX, int* offsetY);
+			  void	interpolate_abs_pos();
 
 			  uint8_t	display_dir();
 			  int		need_mirror(uint8_t dispDir);
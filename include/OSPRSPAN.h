@@ -0,0 +1,108 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPRSPAN.H
+//Description : Header file of Object SpriteSpanCache, compressed bitmaps decoded into spans
+
+#ifndef __OSPRSPAN_H
+#define __OSPRSPAN_H
+
+#include <stdint.h>
+
+//----------- Define constants -----------//
+
+#define SPRITE_SPAN_HASH_SIZE		1024				// no. of hash buckets, must be a power of 2
+#define SPRITE_SPAN_CACHE_SIZE	0x400000			// max. memory used by the decoded bitmaps, 4MB
+
+//--------- Define struct SpriteSpan ---------//
+
+struct SpriteSpan
+{
+	short		x;						// the first column of the span
+	short		len;					// no. of pixels in the span
+	int		pixel_offset;		// offset of the first pixel of the span in pixel_array
+};
+
+//--------- Define struct SpanBitmap ---------//
+//
+// A compressed bitmap decoded into the runs of opaque pixels of each
+// line. It is allocated in one block together with its arrays.
+//
+struct SpanBitmap
+{
+	char*			bitmap_ptr;					// the compressed bitmap it was decoded from
+
+	SpanBitmap*	hash_next;
+	SpanBitmap*	lru_prev;					// the more recently used bitmap
+	SpanBitmap*	lru_next;					// the less recently used bitmap
+
+	int			mem_size;
+	short			width, height;
+
+	int*			row_span_array;			// [height+1], index of the first span of each line in span_array
+	SpriteSpan*	span_array;
+	uint8_t*		pixel_array;
+};
+
+//--------- Define class SpriteSpanCache --------//
+//
+// Sprite and firm bitmaps are stored compressed with transparent runs.
+// Instead of decompressing them on every draw, each bitmap is decoded
+// once into a list of opaque spans, which are then copied line by line.
+// The least recently used bitmaps are released when the decoded bitmaps
+// take up more than SPRITE_SPAN_CACHE_SIZE.
+//
+// The bitmaps are identified by their addresses, so deinit() must be
+// called to empty the cache when a bitmap resource is released.
+//
+class SpriteSpanCache
+{
+public:
+	SpanBitmap*	hash_array[SPRITE_SPAN_HASH_SIZE];
+
+	SpanBitmap*	lru_first;					// the most recently used bitmap
+	SpanBitmap*	lru_last;					// the least recently used bitmap
+
+	int			mem_used;
+
+public:
+	SpriteSpanCache();
+	~SpriteSpanCache();
+
+	void			deinit();
+
+	void			put_bitmap(char* imageBuf, int pitch, int desX, int desY, char* bitmapPtr,
+								  char* colorTable=0, int mirrorFlag=0);
+	void			put_bitmap_area(char* imageBuf, int pitch, int desX, int desY, char* bitmapPtr,
+										 int srcX1, int srcY1, int srcX2, int srcY2, char* colorTable=0, int mirrorFlag=0);
+
+private:
+	SpanBitmap*	get_span_bitmap(char* bitmapPtr);
+	SpanBitmap*	decode(char* bitmapPtr);
+	void			del_span_bitmap(SpanBitmap* spanBitmap);
+
+	int			get_hash(char* bitmapPtr)	{ return (int) (((uintptr_t) bitmapPtr >> 2) & (SPRITE_SPAN_HASH_SIZE-1)); }
+};
+
+extern SpriteSpanCache sprite_span_cache;
+
+//-----------------------------------------//
+
+#endif
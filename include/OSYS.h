@@ -35,6 +35,10 @@ enum { COMMON_DATA_BUF_SIZE = 64*1024 };			// keep a 64K common buffer for all t
 
 #define FRAMES_PER_DAY	10			// no. of frames per day
 
+#define MAX_FRAMES_PER_DISP		8		// max. no. of frames processed before a display when the game is behind
+#define MAX_FRAME_PROCESS_TIME	50		// max. time in milliseconds spent processing frames before a display
+#define MIN_DISP_INTERVAL			15		// min. time in milliseconds between displays of interpolated sprite positions
+
 #define MAX_SCENARIO_PATH 2
 
 
@@ -156,6 +160,7 @@ public:
 	void		deinit_objects();
 
 	void		run(int=0);
+	void		run_bench(int frameCount);
 	void		yield();
 	void		yield_wsock_msg();
 
@@ -209,6 +214,8 @@ private:
 	void		main_loop(int);
 	void		detect();
 	void		process();
+	void		process_frame();
+	void		detect_mp_save();
 
 	void		disp_button();
 	void 		detect_button();
@@ -221,6 +228,8 @@ private:
 	void 		disp_zoom();
 
 	int		should_next_frame();
+	int		is_next_frame_due(int *unreadyPlayerFlag);
+	int		get_frame_fraction(uint32_t curTime);
 	int		is_mp_sync( int *unreadyPlayerFlag );
 	void		auto_save();
 
@@ -0,0 +1,83 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OUNITGRD.H
+//Description : Header file of Object UnitGrid, coarse grid of unit locations by nation
+
+#ifndef __OUNITGRD_H
+#define __OUNITGRD_H
+
+#include <stdint.h>
+#include <GAMEDEF.h>
+
+class Unit;
+class Location;
+
+//----------- Define constants -----------//
+
+#define UNIT_GRID_CELL_SHIFT		3		// a cell of the grid covers 8x8 locations
+
+//--------- Define class UnitGrid --------//
+//
+// The map is divided into cells of 8x8 locations. For each cell, the grid
+// keeps the no. of locations occupied by units of each nation, and the no.
+// of firm locations. It is updated by World::set_unit_recno(),
+// Location::set_firm(), Location::remove_firm() and Unit::change_nation().
+//
+// It lets idle units skip scanning the area around them location by
+// location when there can be no target in it.
+//
+class UnitGrid
+{
+public:
+	int			cell_x_count, cell_y_count;
+
+	uint16_t*	unit_count_array;		// [cell][MAX_NATION+1], the no. of locations occupied by units of each nation in each cell, nation 0 is independent
+	uint16_t*	total_count_array;	// [cell], the no. of locations occupied by units of all nations
+	uint16_t*	firm_count_array;		// [cell], the no. of firm locations
+
+private:
+	char			rebuild_flag;			// the counts are rebuilt from the location matrix before they are next used
+
+public:
+	UnitGrid();
+	~UnitGrid();
+
+	void		init();
+	void		deinit();
+
+	void		set_unit_loc(int xLoc, int yLoc, int oldUnitRecno, int newUnitRecno);
+	void		set_firm_loc(Location* locPtr, int addCount);
+	void		change_unit_nation(Unit* unitPtr, int newNationRecno);
+
+	int		has_other_nation_unit(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int nationRecno);
+	int		has_firm(int xLoc1, int yLoc1, int xLoc2, int yLoc2);
+
+private:
+	void		rebuild();
+	void		add_unit_count(int xLoc, int yLoc, int nationRecno, int addCount);
+	int		get_cell(int xLoc, int yLoc)	{ return (yLoc >> UNIT_GRID_CELL_SHIFT) * cell_x_count + (xLoc >> UNIT_GRID_CELL_SHIFT); }
+};
+
+extern UnitGrid unit_grid;
+
+//-----------------------------------------//
+
+#endif
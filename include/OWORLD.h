@@ -36,6 +36,14 @@
 #include <OUNITRES.h>
 #endif
 
+#ifndef __OUNITGRD_H
+#include <OUNITGRD.h>
+#endif
+
+#ifndef __OLOCSUM_H
+#include <OLOCSUM.h>
+#endif
+
 //----------- Define constant ------------//
 
 #define EXPLORE_RANGE   10
@@ -45,6 +53,16 @@
 
 #define MIN_LAND_COST   500000       // Minimum land cost even there is no population at all
 
+//------- define bits of World::walk_matrix --------//
+
+#define WALK_MATRIX_LAND			LOCATE_WALK_LAND		// Location::walkable()
+#define WALK_MATRIX_SEA				LOCATE_WALK_SEA		// Location::sailable()
+#define WALK_MATRIX_CARGO			0x04						// Location::cargo_recno != 0
+#define WALK_MATRIX_AIR_CARGO		0x08						// Location::air_cargo_recno != 0
+#define WALK_MATRIX_POWER_OFF		0x10						// Location::is_power_off()
+#define WALK_MATRIX_SITE			0x20						// Location::has_site()
+#define WALK_MATRIX_BLOCK			0x40						// Location::loc_flag & LOCATE_BLOCK_MASK
+
 //------- define terrain map --------//
 
 #define MIN_GRASS_HEIGHT    100
@@ -63,6 +81,14 @@ public:
 	MapMatrix    *map_matrix;
 	ZoomMatrix   *zoom_matrix;
 	Location     *loc_matrix;
+	uint32_t		 *visit_frame_matrix;	// the value of visit_frame_count when visit_level of each location was last raised
+	uint32_t		 visit_frame_count;		// no. of frames the fog of war has faded since the map was assigned
+	uint8_t		 *walk_matrix;				// the WALK_MATRIX_??? bits of each location, kept in step with loc_matrix
+	uint16_t		 *region_matrix;			// the region_id of each location
+
+	uint8_t		 *fire_loc_matrix;		// 1 if the location is not idle and is processed by spread_fire()
+	short			 *fire_row_count_array;	// [y][SCAN_FIRE_DIST], no. of such locations in each row for each value of x % SCAN_FIRE_DIST
+	int			 fire_loc_count;			// no. of such locations on the whole map
 
 	unsigned long	 		 next_scroll_time;		 // next scroll time
 
@@ -71,6 +97,9 @@ public:
 	char			 lightning_signal;
 	int			 plant_count;
 	int			 plant_limit;
+	uint32_t		 *plant_loc_bits;			// one bit a location, set when a plant is put on it
+	int			 plant_bits_pitch;		// no. of words of plant_loc_bits for each row of locations
+	char			 plant_full_scan;			// sample every location as before plant_loc_bits, for Bench::run_plant()
 
 	//--------- static member vars --------------//
 
@@ -84,6 +113,7 @@ public:
 	void 		init();
 	void 		deinit();
 
+	void		set_map_size(int xLoc, int yLoc);
 	void 		generate_map();
 	void 		assign_map();
 
@@ -106,15 +136,22 @@ public:
 public:
 	#ifdef DEBUG3
 		Location* get_loc(int xLoc,int yLoc);
-		uint8_t		 get_region_id(int xLoc,int yLoc);
+		uint16_t		 get_region_id(int xLoc,int yLoc);
 	#else
 		Location* get_loc(int xLoc,int yLoc)
 						{ return loc_matrix + MAX_WORLD_X_LOC * yLoc + xLoc; }
 
-		uint8_t		 get_region_id(int xLoc,int yLoc)
-						{ return loc_matrix[MAX_WORLD_X_LOC*yLoc+xLoc].region_id; }
+		uint16_t		 get_region_id(int xLoc,int yLoc)
+						{ return region_matrix[MAX_WORLD_X_LOC*yLoc+xLoc]; }
 	#endif
 
+	uint8_t*	get_walk_bits(int xLoc,int yLoc)
+					{ return walk_matrix + MAX_WORLD_X_LOC * yLoc + xLoc; }
+	uint8_t	calc_walk_bits(Location* locPtr);
+	void		update_walk_matrix(Location* locPtr);
+	void		build_walk_matrix();
+	void		build_region_matrix();
+
 	short		get_unit_recno(int xLoc,int yLoc, int mobileType);
 	void 		set_unit_recno(int xLoc, int yLoc, int mobileType, int newCargoRecno);
 
@@ -127,6 +164,16 @@ public:
 	void		visit(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int range, int extend =0);
 	void		visit_shell(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int visitLevel);
 
+	unsigned char get_visibility(Location* locPtr)
+					{ return locPtr->visibility(visit_frame_count - visit_frame_matrix[locPtr-loc_matrix]); }
+	unsigned char get_visibility(int xLoc, int yLoc)
+					{ return get_visibility(get_loc(xLoc, yLoc)); }
+	void		set_visited(Location* locPtr, int visitLevel=MAX_VISIT_LEVEL)
+					{ uint32_t* framePtr = visit_frame_matrix + (locPtr-loc_matrix);
+					  if( locPtr->cur_visit_level(visit_frame_count - *framePtr) < visitLevel*2 )
+					  { locPtr->visit_level = visitLevel*2; *framePtr = visit_frame_count; } }
+	void		settle_visibility();
+
 	int		can_build_firm(int xLoc1, int yLoc1, int firmId, short unitRecno= -1);
 	int		can_build_town(int xLoc1, int yLoc1, short unitRecno= -1);
 	int		can_build_wall(int xLoc1, int yLoc1, short nationRecno);
@@ -163,12 +210,16 @@ public:
 	void		plant_spread(int pSpread =5);
 	void		plant_init();
 	void		plant_spray(short *plantIdArray, char strength, short x, short y);
+	void		update_plant_loc(Location* locPtr, int plantFlag);
+	void		build_plant_set();
 
 	//------- functions related to fire's spreading, see ow_fire.cpp ----//
 
 	void		init_fire();
 	void		spread_fire(Weather &);
 	void		setup_fire(short x, short y, char fireStrength = 30);
+	void		update_fire_loc(Location* locPtr);
+	void		build_fire_set();
 
 	//------- function related to city wall ----------//
 	void		build_wall_section(short x1, short y1, short x2, short y2,
@@ -213,9 +264,10 @@ private:
 	void    remove_odd(Plasma &, short x, short y, short recur);
 	void    set_climate();
 	void	  set_loc_flags();
+	int	  next_plant_x(int xLoc, int yLoc, int scanDensity);
 	void	  substitute_pattern();
 	void    set_region_id();
-	void    fill_region(short x, short y);
+	int     label_region(int* labelMatrix);
 	// ####### begin Gilbert 22/9 ########//
 	void    gen_rocks(int nGrouped, int nLarge, int nSmall);
 	void    gen_dirt(int nGrouped, int nLarge, int nSmall);
@@ -241,6 +293,94 @@ private:
 	void	fill_hill(short x, short y);
 };
 
+//-------- Begin of function World::calc_walk_bits -------//
+
+inline uint8_t World::calc_walk_bits(Location* locPtr)
+{
+	return (locPtr->loc_flag & (LOCATE_WALK_LAND | LOCATE_WALK_SEA))
+		| (locPtr->cargo_recno ? WALK_MATRIX_CARGO : 0)
+		| (locPtr->air_cargo_recno ? WALK_MATRIX_AIR_CARGO : 0)
+		| (locPtr->loc_flag & LOCATE_POWER_OFF ? WALK_MATRIX_POWER_OFF : 0)
+		| (locPtr->has_site() ? WALK_MATRIX_SITE : 0)
+		| (locPtr->loc_flag & LOCATE_BLOCK_MASK ? WALK_MATRIX_BLOCK : 0);
+}
+//--------- End of function World::calc_walk_bits -------//
+
+
+//-------- Begin of function World::update_walk_matrix -------//
+//
+// Called by the functions of Location which change its walkability,
+// cargo, power or site, and by set_unit_recno().
+//
+inline void World::update_walk_matrix(Location* locPtr)
+{
+	unsigned locIndex = unsigned(locPtr - loc_matrix);
+
+	if( !walk_matrix || locIndex >= unsigned(MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC) )
+		return;
+
+	uint8_t newBits = calc_walk_bits(locPtr);
+
+	if( walk_matrix[locIndex] != newBits )
+	{
+		loc_sum.change_walk_bits( locIndex % MAX_WORLD_X_LOC, locIndex / MAX_WORLD_X_LOC, walk_matrix[locIndex], newBits );
+		walk_matrix[locIndex] = newBits;
+	}
+}
+//--------- End of function World::update_walk_matrix -------//
+
+
+//-------- Begin of function World::update_fire_loc -------//
+//
+// Called by the functions of Location which change its fire level or
+// flammability. Add the location to or remove it from the set of
+// locations spread_fire() processes.
+//
+inline void World::update_fire_loc(Location* locPtr)
+{
+	unsigned locIndex = unsigned(locPtr - loc_matrix);
+
+	if( !fire_loc_matrix || locIndex >= unsigned(MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC) )
+		return;
+
+	uint8_t inSet = !locPtr->is_fire_idle();
+
+	if( fire_loc_matrix[locIndex] == inSet )
+		return;
+
+	fire_loc_matrix[locIndex] = inSet;
+
+	int addCount = inSet ? 1 : -1;
+	int xLoc = locIndex % MAX_WORLD_X_LOC, yLoc = locIndex / MAX_WORLD_X_LOC;
+
+	fire_row_count_array[yLoc*SCAN_FIRE_DIST + xLoc%SCAN_FIRE_DIST] += addCount;
+	fire_loc_count += addCount;
+}
+//--------- End of function World::update_fire_loc -------//
+
+
+//-------- Begin of function World::update_plant_loc -------//
+//
+// Called by Location::set_plant() and Location::remove_plant().
+//
+inline void World::update_plant_loc(Location* locPtr, int plantFlag)
+{
+	unsigned locIndex = unsigned(locPtr - loc_matrix);
+
+	if( !plant_loc_bits || locIndex >= unsigned(MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC) )
+		return;
+
+	int xLoc = locIndex % MAX_WORLD_X_LOC, yLoc = locIndex / MAX_WORLD_X_LOC;
+	uint32_t* wordPtr = plant_loc_bits + yLoc * plant_bits_pitch + (xLoc >> 5);
+
+	if( plantFlag )
+		*wordPtr |= 1u << (xLoc & 31);
+	else
+		*wordPtr &= ~(1u << (xLoc & 31));
+}
+//--------- End of function World::update_plant_loc -------//
+
+
 //-------- Begin of function World::get_unit_recno -------//
 
 inline short World::get_unit_recno(int xLoc, int yLoc, int mobileType)
@@ -257,10 +397,14 @@ inline short World::get_unit_recno(int xLoc, int yLoc, int mobileType)
 
 inline void World::set_unit_recno(int xLoc,int yLoc, int mobileType, int newCargoRecno)
 {
-	if( mobileType==UNIT_AIR )
-		loc_matrix[MAX_WORLD_X_LOC*yLoc+xLoc].air_cargo_recno = newCargoRecno;
-	else
-		loc_matrix[MAX_WORLD_X_LOC*yLoc+xLoc].cargo_recno = newCargoRecno;
+	Location* locPtr = loc_matrix + MAX_WORLD_X_LOC*yLoc + xLoc;
+	short*	 cargoPtr = mobileType==UNIT_AIR ? &locPtr->air_cargo_recno : &locPtr->cargo_recno;
+
+	unit_grid.set_unit_loc(xLoc, yLoc, *cargoPtr, newCargoRecno);
+
+	*cargoPtr = newCargoRecno;
+
+	update_walk_matrix(locPtr);
 
 	err_when(mobileType!=UNIT_AIR && loc_matrix[MAX_WORLD_X_LOC*yLoc+xLoc].is_firm());
 }
@@ -24,6 +24,8 @@
 #ifndef __OWORLDMT_H
 #define __OWORLDMT_H
 
+#include <stdint.h>
+
 #ifndef __OMATRIX_H
 #include <OMATRIX.h>
 #endif
@@ -37,14 +39,20 @@
 #define MAX_WORLD_X_LOC  (World::max_x_loc)
 #define MAX_WORLD_Y_LOC  (World::max_y_loc)
 
-//------------- Map window -------------//
+#define DEFAULT_WORLD_LOC_SIZE	200		// the size of the maps of the original game, of multiplayer games and of saved games before huge maps
+#define MIN_WORLD_LOC_SIZE			200
+#define MAX_WORLD_LOC_SIZE			512		// the pixel coordinates of sprites are shorts, MAX_WORLD_LOC_SIZE*ZOOM_LOC_WIDTH must fit in them
 
-#define MAP_WIDTH       MAX_WORLD_X_LOC
-#define MAP_HEIGHT      MAX_WORLD_Y_LOC
+//------------- Map window -------------//
 
 #define MAX_MAP_WIDTH	200
 #define MAX_MAP_HEIGHT	200
 
+#define MAP_LOC_SCALE   ((MAX(MAX_WORLD_X_LOC, MAX_WORLD_Y_LOC) + MAX_MAP_WIDTH - 1) / MAX_MAP_WIDTH)	// no. of locations drawn as one pixel of the map
+
+#define MAP_WIDTH       ((MAX_WORLD_X_LOC + MAP_LOC_SCALE - 1) / MAP_LOC_SCALE)
+#define MAP_HEIGHT      ((MAX_WORLD_Y_LOC + MAP_LOC_SCALE - 1) / MAP_LOC_SCALE)
+
 #define MAP_X1          (588+(MAX_MAP_WIDTH-MAP_WIDTH)/2)
 #define MAP_Y1          (56 +(MAX_MAP_HEIGHT-MAP_HEIGHT)/2)
 #define MAP_X2          (MAP_X1+MAP_WIDTH-1)
@@ -98,6 +106,7 @@ public:
    ~MapMatrix();
 
 	void init_para();
+	void assign_map(Location* locMatrix, int maxXLoc, int maxYLoc);
 	void draw();
 	void paint();
 	void disp();
@@ -113,6 +122,30 @@ protected:
 	void disp_mode_button(int putFront=0);
 };
 
+//------- Define struct ZoomLocKey -------//
+//
+// What the terrain layer of a location in the zoom area is drawn from,
+// see ZoomMatrix::draw_loc().
+//
+struct ZoomLocKey
+{
+	char*		overlay_bitmap;		// the current frame of animated terrain
+	int32_t	snow_thick;
+	int32_t	snow_pattern;
+	short		terrain_id;
+	short		hill_id1, hill_id2;
+	short		dirt_recno, dirt_rock_recno;
+	short		dirt_x_loc, dirt_y_loc;
+	short		site_recno, site_object_id;
+	short		snow_map_id;
+	char		explored;
+	char		dirt_frame;
+	char		site_type;
+	char		power_nation_recno;
+	char		power_border;			// bit 0-3: borders drawn on the top, bottom, left and right sides
+	char		debug_flag;
+};
+
 //-------- Define class ZoomMatrix -------//
 
 class ZoomMatrix : public Matrix
@@ -134,8 +167,18 @@ public:
 	int	vibration; // reset on new game, save on save game
 	short	lightning_x1, lightning_y1, lightning_x2, lightning_y2; // save on save game
 
+	char*	terrain_buf;				// the zoom area with only the terrain layer drawn by draw()
+	ZoomLocKey* terrain_key_array;	// [disp_y_loc][disp_x_loc], what each location in terrain_buf has been drawn from
+	char*	terrain_dirty_array;		// [disp_y_loc][disp_x_loc], whether the location has to be drawn again
+	char*	terrain_draw_array;
+	short	terrain_x_loc, terrain_y_loc;	// top_x_loc and top_y_loc when terrain_buf was drawn
+	short	terrain_spill_loc;		// how many locations away the bitmaps drawn on a location can reach, 0 if not calculated yet
+	char	terrain_valid;
+	char	terrain_disp_power;		// the dispPower passed to draw_loc() by draw_terrain()
+
 public:
    ZoomMatrix();
+   ~ZoomMatrix();
 
 	void init_para();
 	void draw();
@@ -148,6 +191,14 @@ public:
 	bool is_bitmap_clip(int x, int y, char* bitmapPtr);
 
 protected:
+	void deinit_terrain();
+	void draw_loc(int x, int y, int xLoc, int yLoc, int dispPower, int clipY1, int clipY2);
+	void draw_dirty_loc(int dispPower, int allDirty);
+	void draw_terrain(int row1, int row2);
+	void shift_terrain(int xShift, int yShift);
+	void get_loc_key(ZoomLocKey* keyPtr, int xLoc, int yLoc, int dispPower);
+	int  calc_terrain_spill();
+
 	void draw_objects();
 	void draw_objects_now(DynArray* unitArray, int = 0);
 
@@ -157,7 +208,13 @@ protected:
 	void draw_god_cast_range();
 
 	void blacken_unexplored();
+	void blacken_unexplored(int row1, int row2);
 	void blacken_fog_of_war();
+	void blacken_fog_of_war(int row1, int row2);
+
+	static void draw_terrain_band(void* zoomMatrix, int row1, int row2);
+	static void blacken_unexplored_band(void* zoomMatrix, int row1, int row2);
+	static void blacken_fog_of_war_band(void* zoomMatrix, int row1, int row2);
 
 	void disp_text();
 	void put_center_text(int x, int y, const char* str);
@@ -34,4 +34,21 @@
 #define IMGcall
 #endif
 
+// SSE2 is part of every x86-64 processor, so the C versions of the
+// image functions use it there without checking the processor first.
+// Only IMGbltTrans blends with it, and IMGbltTransRemap uses it to skip
+// fully transparent blocks. The remap and fog remap functions look up a
+// 256-entry table for each pixel, which SSE2 cannot do, so they stay one
+// pixel at a time. The decompression functions are not given the size of
+// the compressed data, so they cannot read it in 16-byte blocks.
+#if !defined(USE_ASM) && (defined(__SSE2__) || defined(_M_X64))
+#define IMG_USE_SSE2
+#endif
+
+// The x86 asm image functions keep their working variables in static
+// data, so only the C versions may be called from several threads.
+#ifndef USE_ASM
+#define IMG_REENTRANT
+#endif
+
 #endif // _ASMFUN_H
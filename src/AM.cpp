@@ -32,6 +32,7 @@
 #include <OANLINE.h>
 #include <OAUDIO.h>
 #include <OBATTLE.h>
+#include <OBENCH.h>
 #include <OBOX.h>
 #include <OBULLET.h>
 #include <OCONFIG.h>
@@ -55,12 +56,22 @@
 #include <ONEWS.h>
 #include <OPLANT.h>
 #include <OPOWER.h>
+#include <OPROFILE.h>
 #include <ORACERES.h>
 #include <OREBEL.h>
 #include <OREMOTE.h>
 #include <OSPATH.h>
 #include <OSITE.h>
 #include <OSPREUSE.h>
+#include <OSPHPA.h>
+#include <OSPFLOW.h>
+#include <OSPCACHE.h>
+#include <OSPLOG.h>
+#include <OUNITGRD.h>
+#include <OLINKGRD.h>
+#include <OLOCSUM.h>
+#include <OSPRSPAN.h>
+#include <OBANDRND.h>
 #include <OSPY.h>
 #include <OSYS.h>
 #include <OTALKRES.h>
@@ -116,7 +127,7 @@
 //------- define game version constant --------//
 
 	const char *GAME_VERSION_STR = SKVERSION;
-	const int GAME_VERSION = 212;	// Version 2.00, don't change it unless the format of save game files has been changed
+	const int GAME_VERSION = 213;	// Version 2.00, don't change it unless the format of save game files has been changed
 
 //-------- System class ----------//
 
@@ -144,6 +155,15 @@ WebService        ws;
 Sys               sys;
 SeekPath          seek_path;
 SeekPathReuse     seek_path_reuse;
+SeekPathHPA       seek_path_hpa;
+FlowField         flow_field;
+SeekPathCache     seek_path_cache;
+SeekPathLog       seek_path_log;
+UnitGrid          unit_grid;
+LinkGrid          link_grid;
+LocSum            loc_sum;
+SpriteSpanCache   sprite_span_cache;
+BandRender        band_render;
 Flame             flame[FLAME_GROW_STEP];
 Remote            remote;
 ErrorControl      ec_remote;
@@ -151,6 +171,8 @@ AnimLine          anim_line;
 SECtrl            se_ctrl(&audio);
 SERes             se_res;
 Log               msg_log;
+Bench             bench;
+Profiler          profiler;
 #ifdef DEBUG
 LongLog *			long_log;
 #endif
@@ -362,6 +384,19 @@ int main(int argc, char **argv)
 
 	err.set_extra_handler( extra_error_handler );   // set extra error handler, save the game when a error happens
 
+	int exitCode = 0;
+
+	if( cmd_line.profile_file && cmd_line.startup_mode != STARTUP_BENCH && cmd_line.startup_mode != STARTUP_REPLAY )
+		profiler.init();
+
+	//--- record the path searches of units, unless the log is to be replayed ---//
+
+	if( cmd_line.path_log_file && cmd_line.startup_mode != STARTUP_PATH_BENCH &&
+		 !seek_path_log.open(cmd_line.path_log_file) )
+	{
+		sys.show_error_dialog(_("Unable to create the path log file %s."), cmd_line.path_log_file);
+	}
+
 	switch( cmd_line.startup_mode )
 	{
 	case STARTUP_NORMAL:
@@ -387,14 +422,39 @@ int main(int argc, char **argv)
 		battle.run(0);
 		game.deinit();
 		break;
+	case STARTUP_BENCH:
+		config.help_mode = NO_HELP;
+		if( !bench.run(cmd_line.bench_file, cmd_line.bench_frames>0 ? cmd_line.bench_frames : DEFAULT_BENCH_FRAMES) )
+			exitCode = 1;
+		break;
+	case STARTUP_REPLAY:
+		config.help_mode = NO_HELP;
+		if( !bench.run_replay(cmd_line.replay_file, cmd_line.bench_frames) )
+			exitCode = 1;
+		break;
+	case STARTUP_PATH_BENCH:
+		config.help_mode = NO_HELP;
+		if( !bench.run_path(cmd_line.path_bench_file, cmd_line.path_log_file) )
+			exitCode = 1;
+		break;
+	case STARTUP_PLANT_BENCH:
+		config.help_mode = NO_HELP;
+		if( !bench.run_plant(cmd_line.plant_bench_days>0 ? cmd_line.plant_bench_days : DEFAULT_PLANT_BENCH_DAYS) )
+			exitCode = 1;
+		break;
+	case STARTUP_BLIT_TEST:
+		if( !bench.run_blit() )
+			exitCode = 1;
+		break;
 	default:
 		game.main_menu();
 		break;
 	}
 
+	seek_path_log.close();
 	sys.deinit();
 
-	return 0;
+	return exitCode;
 }
 //---------- End of function main ----------//
 
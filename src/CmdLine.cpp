@@ -25,6 +25,7 @@
 #include <ConfigAdv.h>
 #include <OCONFIG.h>
 #include <OSYS.h>
+#include <OWORLDMT.h>
 #include <gettext.h>
 
 CmdLine::CmdLine()
@@ -33,6 +34,14 @@ CmdLine::CmdLine()
 	game_speed = -1;
 	startup_mode = STARTUP_NORMAL;
 	join_host = NULL;
+	bench_file = NULL;
+	replay_file = NULL;
+	bench_frames = 0;
+	profile_file = NULL;
+	path_bench_file = NULL;
+	path_log_file = NULL;
+	plant_bench_days = 0;
+	map_size = 0;
 }
 
 CmdLine::~CmdLine()
@@ -61,6 +70,33 @@ static int set_startup_mode(StartupMode mode)
 }
 
 // Command line paramters:
+// -bench <saved game or scenario file>
+//   Process frames of the game without display or audio and print timings
+// -replay <replay file>
+//   Play back a replay as fast as possible without display or audio and
+//   print the timing and the final object CRCs
+// -frames <frame count>
+//   Set the number of frames processed by -bench (default 1000) or
+//   -replay (default to the end of the replay)
+// -profile <trace file>
+//   Time the game's subsystems and write a Chrome trace to the file on
+//   F12 or at the end of -bench
+// -pathlog <path log file>
+//   Record the path searches of the units to the file, or with -pathbench,
+//   the file of recorded searches to replay
+// -pathbench <saved game or scenario file>
+//   Load the game the path log was recorded from, replay the searches
+//   of the path log without display or audio and print their timings
+// -plantbench <day count>
+//   Generate a map with dense forests and time the daily growth of the
+//   plants with and without the plant registry
+// -blittest
+//   Compare the pixels drawn by the fast paths of IMGbltTrans,
+//   IMGbltTransRemap and IMGbltTransDecompress with those drawn pixel by
+//   pixel, and time both
+// -mapsize <location count>
+//   Set the width and height of the maps of new single player games and
+//   of -plantbench, from 200 (the standard size) to 512
 // -demo
 //   Start a new game in observer mode
 // -host
@@ -80,6 +116,15 @@ int CmdLine::init(int argc, char **argv)
 	const char *noIfOption = "-noif";
 	const char *speedOption = "-speed";
 	const char *windowOption = "-win";
+	const char *benchOption = "-bench";
+	const char *replayOption = "-replay";
+	const char *framesOption = "-frames";
+	const char *profileOption = "-profile";
+	const char *pathLogOption = "-pathlog";
+	const char *pathBenchOption = "-pathbench";
+	const char *plantBenchOption = "-plantbench";
+	const char *blitTestOption = "-blittest";
+	const char *mapSizeOption = "-mapsize";
 	for( int i = 1; i < argc; i++ )
 	{
 		if( !strcmp(argv[i], lobbyJoinOption) )
@@ -119,6 +164,82 @@ int CmdLine::init(int argc, char **argv)
 		{
 			config_adv.vga_full_screen = 0;
 		}
+		else if( !strcmp(argv[i], benchOption) )
+		{
+			if( !have_arg(i, argc, benchOption) )
+				return 0;
+			if( !set_startup_mode(STARTUP_BENCH) )
+				return 0;
+			bench_file = argv[++i];
+			enable_if = 0;
+		}
+		else if( !strcmp(argv[i], replayOption) )
+		{
+			if( !have_arg(i, argc, replayOption) )
+				return 0;
+			if( !set_startup_mode(STARTUP_REPLAY) )
+				return 0;
+			replay_file = argv[++i];
+			enable_if = 0;
+		}
+		else if( !strcmp(argv[i], framesOption) )
+		{
+			if( !have_arg(i, argc, framesOption) )
+				return 0;
+			bench_frames = atoi(argv[++i]);
+		}
+		else if( !strcmp(argv[i], profileOption) )
+		{
+			if( !have_arg(i, argc, profileOption) )
+				return 0;
+			profile_file = argv[++i];
+		}
+		else if( !strcmp(argv[i], pathLogOption) )
+		{
+			if( !have_arg(i, argc, pathLogOption) )
+				return 0;
+			path_log_file = argv[++i];
+		}
+		else if( !strcmp(argv[i], pathBenchOption) )
+		{
+			if( !have_arg(i, argc, pathBenchOption) )
+				return 0;
+			if( !set_startup_mode(STARTUP_PATH_BENCH) )
+				return 0;
+			path_bench_file = argv[++i];
+			enable_if = 0;
+		}
+		else if( !strcmp(argv[i], plantBenchOption) )
+		{
+			if( !have_arg(i, argc, plantBenchOption) )
+				return 0;
+			if( !set_startup_mode(STARTUP_PLANT_BENCH) )
+				return 0;
+			plant_bench_days = atoi(argv[++i]);
+			enable_if = 0;
+		}
+		else if( !strcmp(argv[i], blitTestOption) )
+		{
+			if( !set_startup_mode(STARTUP_BLIT_TEST) )
+				return 0;
+			enable_if = 0;
+		}
+		else if( !strcmp(argv[i], mapSizeOption) )
+		{
+			if( !have_arg(i, argc, mapSizeOption) )
+				return 0;
+			map_size = atoi(argv[++i]);
+			if( map_size < MIN_WORLD_LOC_SIZE || map_size > MAX_WORLD_LOC_SIZE )
+			{
+				sys.show_error_dialog(_("The map size must be from %d to %d."), MIN_WORLD_LOC_SIZE, MAX_WORLD_LOC_SIZE);
+				return 0;
+			}
+		}
+	}
+	if( startup_mode == STARTUP_PATH_BENCH && !path_log_file )
+	{
+		sys.show_error_dialog(_("The command line option %s requires %s."), pathBenchOption, pathLogOption);
+		return 0;
 	}
 	return 1;
 }
@@ -247,10 +247,12 @@ void ConfigAdv::reset()
 	unit_loyalty_require_local_leader = 1;
 
 	vga_allow_highdpi = 0;
+	vga_frame_interpolation = 1;
 	vga_full_screen = 1;
 	vga_keep_aspect_ratio = 1;
 	vga_pause_on_focus_loss = 1;
 
+	vga_render_threads = -1;
 	vga_window_width = 0;
 	vga_window_height = 0;
 
@@ -386,6 +388,11 @@ int ConfigAdv::set(char *name, char *value)
 		if( !read_bool(value, &vga_allow_highdpi) )
 			return 0;
 	}
+	else if( !strcmp(name, "vga_frame_interpolation") )
+	{
+		if( !read_bool(value, &vga_frame_interpolation) )
+			return 0;
+	}
 	else if( !strcmp(name, "vga_full_screen") )
 	{
 		if( !read_bool(value, &vga_full_screen) )
@@ -401,6 +408,11 @@ int ConfigAdv::set(char *name, char *value)
 		if( !read_bool(value, &vga_pause_on_focus_loss) )
 			return 0;
 	}
+	else if( !strcmp(name, "vga_render_threads") )
+	{
+		if( !read_int(value, &vga_render_threads) )
+			return 0;
+	}
 	else if( !strcmp(name, "vga_window_height") )
 	{
 		if( !read_int(value, &vga_window_height) )
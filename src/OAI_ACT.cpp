@@ -28,6 +28,7 @@
 #include <OINFO.h>
 #include <OU_MARI.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 //------- Begin of function Nation::process_action --------//
 //
@@ -47,6 +48,8 @@
 //
 int Nation::process_action(int priorityActionRecno, int processActionMode)
 {
+	PROFILE_SCOPE("Nation::process_action");
+
 	err_when( priorityActionRecno && processActionMode );
 
 	// #define MAX_PROCESS_ACTION_TIME	 0.01		// maximum time given to processing actions (second)
@@ -28,6 +28,7 @@
 #include <OFIRMALL.h>
 #include <OTALKRES.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 
 //------ Declare static functions --------//
@@ -808,6 +809,8 @@ static int sort_attack_camp_function( const void *a, const void *b )
 //
 int Nation::think_secret_attack()
 {
+	PROFILE_SCOPE("Nation::think_secret_attack");
+
 	//--- never secret attack if its peacefulness >= 80 ---//
 
 	if( pref_peacefulness >= 80 )
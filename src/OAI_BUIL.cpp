@@ -28,12 +28,15 @@
 #include <OCONFIG.h>
 #include <OSITE.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 
 //--------- Begin of function Nation::think_build_firm --------//
 
 void Nation::think_build_firm()
 {
+	PROFILE_SCOPE("Nation::think_build_firm");
+
 	if( !ai_should_build_mine() )
 		return;
 
@@ -28,6 +28,7 @@
 #include <OF_CAMP.h>
 #include <OF_INN.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 
 //------- define struct CaptureTown -------//
@@ -46,6 +47,8 @@ struct CaptureTown
 //
 int Nation::think_capture()
 {
+	PROFILE_SCOPE("Nation::think_capture");
+
 	if( ai_camp_count==0 )		// this can happen when a new nation has just emerged
 		return 0;
 
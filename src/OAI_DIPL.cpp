@@ -25,12 +25,15 @@
 #include <OCONFIG.h>
 #include <OTECHRES.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 
 //----- Begin of function Nation::think_diplomacy -----//
 //
 void Nation::think_diplomacy()
 {
+	PROFILE_SCOPE("Nation::think_diplomacy");
+
 	//--- process incoming messages first, so we won't send out the same request to nation which has already proposed the same thing ---//
 
 	int nationRecno = nation_recno;
@@ -25,12 +25,15 @@
 #include <OUNIT.h>
 #include <OFIRMALL.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 
 //--------- Begin of function Nation::think_reduce_expense --------//
 
 void Nation::think_reduce_expense()
 {
+	PROFILE_SCOPE("Nation::think_reduce_expense");
+
 	if( true_profit_365days() > 0 || cash > 5000 * pref_cash_reserve / 100 )
 		return;
 
@@ -28,12 +28,15 @@
 #include <OF_CAMP.h>
 #include <ONATION.h>
 #include <ConfigAdv.h>
+#include <OPROFILE.h>
 
 
 //----- Begin of function Nation::think_grand_plan -----//
 //
 void Nation::think_grand_plan()
 {
+	PROFILE_SCOPE("Nation::think_grand_plan");
+
 	think_deal_with_all_enemy();
 
 	think_against_mine_monopoly();
@@ -34,6 +34,7 @@
 #include <OF_MINE.h>
 #include <OINFO.h>
 #include <OLOG.h>
+#include <OPROFILE.h>
 
 //--------- Begin of function Nation::Nation --------//
 
@@ -228,6 +229,8 @@ void Nation::init_personalty()
 //--------- Begin of function Nation::process_ai --------//
 void Nation::process_ai()
 {
+	PROFILE_SCOPE("Nation::process_ai");
+
 	//-*********** simulate aat ************-//
 #ifdef DEBUG
 	if(debug_sim_game_type)
@@ -337,6 +340,8 @@ void Nation::process_ai()
 //
 void Nation::process_on_going_action()
 {
+	PROFILE_SCOPE("Nation::process_on_going_action");
+
 	//--- if the nation is in the process of trying to capture an enemy town ---//
 
 	if( ai_capture_enemy_town_recno )
@@ -357,6 +362,8 @@ void Nation::process_on_going_action()
 //
 void Nation::process_ai_main()
 {
+	PROFILE_SCOPE("Nation::process_ai_main");
+
 #if defined(DEBUG) && defined(ENABLE_LOG)
    String debugStr;
    debugStr = "Nation ";
@@ -467,6 +474,8 @@ void Nation::process_ai_main()
 
 void Nation::think_explore()
 {
+	PROFILE_SCOPE("Nation::think_explore");
+
 }
 //---------- End of function Nation::think_explore --------//
 
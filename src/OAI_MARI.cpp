@@ -29,11 +29,14 @@
 #include <OF_HARB.h>
 #include <OF_CAMP.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 //--------- Begin of function Nation::think_marine --------//
 //
 void Nation::think_marine()
 {
+	PROFILE_SCOPE("Nation::think_marine");
+
 	if( pref_use_marine < 50 )		// don't use marine at all
 		return;
 
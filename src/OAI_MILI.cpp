@@ -25,11 +25,14 @@
 #include <OTOWN.h>
 #include <OF_CAMP.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 //--------- Begin of function Nation::think_military --------//
 
 void Nation::think_military()
 {
+	PROFILE_SCOPE("Nation::think_military");
+
 	//---- don't build new camp if we our food consumption > production ----//
 
 	if( yearly_food_change() < 0 )
@@ -25,11 +25,14 @@
 #include <ONATION.h>
 #include <OCONFIG.h>
 #include <OMONSRES.h>
+#include <OPROFILE.h>
 
 //--------- Begin of function Nation::think_attack_monster --------//
 
 int Nation::think_attack_monster()
 {
+	PROFILE_SCOPE("Nation::think_attack_monster");
+
 	if( config.monster_type == OPTION_MONSTER_NONE )		// no monsters in the game
 		return 0;
 
@@ -27,12 +27,15 @@
 #include <OTOWN.h>
 #include <OREGIONS.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 
 //--------- Begin of function Nation::think_town --------//
 //
 void Nation::think_town()
 {
+	PROFILE_SCOPE("Nation::think_town");
+
 	optimize_town_race();
 }
 //---------- End of function Nation::think_town --------//
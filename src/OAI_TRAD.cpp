@@ -25,11 +25,14 @@
 #include <OU_CARA.h>
 #include <OF_MARK.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 //--------- Begin of function Nation::think_trading --------//
 
 void Nation::think_trading()
 {
+	PROFILE_SCOPE("Nation::think_trading");
+
 }
 //---------- End of function Nation::think_trading --------//
 
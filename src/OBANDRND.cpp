@@ -0,0 +1,211 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OBANDRND.CPP
+//Description : Object BandRender, worker threads drawing horizontal bands of an area
+
+#include <string.h>
+#include <ALL.h>
+#include <ConfigAdv.h>
+#include <OBANDRND.h>
+
+//-------- Begin of function BandRender::BandRender --------//
+
+BandRender::BandRender()
+{
+	memset( thread_array, 0, sizeof(thread_array) );
+
+	thread_count = -1;
+	done_sem		 = NULL;
+	draw_func	 = NULL;
+	draw_para	 = NULL;
+	quit_flag	 = 0;
+}
+//--------- End of function BandRender::BandRender ---------//
+
+
+//-------- Begin of function BandRender::~BandRender --------//
+
+BandRender::~BandRender()
+{
+	deinit();
+}
+//--------- End of function BandRender::~BandRender ---------//
+
+
+//-------- Begin of function BandRender::init_thread --------//
+//
+// Create one worker thread for each core besides the one of the main
+// thread, or as many as set by vga_render_threads in the advanced config.
+//
+void BandRender::init_thread()
+{
+	int threadCount = config_adv.vga_render_threads;
+
+	if( threadCount < 0 )
+		threadCount = SDL_GetCPUCount() - 1;
+
+	threadCount = MAX( 0, MIN(threadCount, MAX_BAND_THREAD) );
+
+	thread_count = 0;
+	quit_flag = 0;
+
+	if( !threadCount )
+		return;
+
+	done_sem = SDL_CreateSemaphore(0);
+
+	if( !done_sem )
+		return;
+
+	for( int i=0 ; i<threadCount ; i++ )
+	{
+		BandThread* threadPtr = thread_array + i;
+
+		threadPtr->owner = this;
+		threadPtr->start_sem = SDL_CreateSemaphore(0);
+
+		if( !threadPtr->start_sem )
+			break;
+
+		threadPtr->thread = SDL_CreateThread( thread_main, "BandRender", threadPtr );
+
+		if( !threadPtr->thread )
+		{
+			SDL_DestroySemaphore(threadPtr->start_sem);
+			threadPtr->start_sem = NULL;
+			break;
+		}
+
+		thread_count++;
+	}
+}
+//--------- End of function BandRender::init_thread ---------//
+
+
+//-------- Begin of function BandRender::deinit --------//
+//
+// Stop the worker threads. They are created again on the next run().
+//
+void BandRender::deinit()
+{
+	if( thread_count > 0 )
+	{
+		quit_flag = 1;
+
+		for( int i=0 ; i<thread_count ; i++ )
+			SDL_SemPost( thread_array[i].start_sem );
+
+		for( int i=0 ; i<thread_count ; i++ )
+		{
+			SDL_WaitThread( thread_array[i].thread, NULL );
+			SDL_DestroySemaphore( thread_array[i].start_sem );
+		}
+
+		memset( thread_array, 0, sizeof(thread_array) );
+	}
+
+	if( done_sem )
+	{
+		SDL_DestroySemaphore(done_sem);
+		done_sem = NULL;
+	}
+
+	thread_count = -1;
+}
+//--------- End of function BandRender::deinit ---------//
+
+
+//-------- Begin of function BandRender::run --------//
+//
+// Split the rows of an area into bands and draw them at the same time,
+// one on each worker thread and one on the main thread. Return when
+// all bands have been drawn.
+//
+// <BandDrawFunc> drawFunc - the function drawing a band
+// <void*>        drawPara - the parameter passed to drawFunc
+// <int>          rowCount - the no. of rows of the area
+//
+void BandRender::run(BandDrawFunc drawFunc, void* drawPara, int rowCount)
+{
+	if( thread_count < 0 )
+		init_thread();
+
+	int bandCount = MIN( thread_count+1, rowCount );
+
+	if( bandCount <= 1 )
+	{
+		if( rowCount > 0 )
+			drawFunc( drawPara, 0, rowCount-1 );
+		return;
+	}
+
+	draw_func = drawFunc;
+	draw_para = drawPara;
+
+	//------ give a band to each worker thread ------//
+
+	int workerCount = bandCount-1;
+	int row1 = 0;
+
+	for( int i=0 ; i<workerCount ; i++ )
+	{
+		int row2 = (i+1) * rowCount / bandCount - 1;
+
+		thread_array[i].row1 = row1;
+		thread_array[i].row2 = row2;
+
+		SDL_SemPost( thread_array[i].start_sem );
+
+		row1 = row2+1;
+	}
+
+	//---- draw the last band on the main thread ----//
+
+	drawFunc( drawPara, row1, rowCount-1 );
+
+	for( int i=0 ; i<workerCount ; i++ )
+		SDL_SemWait(done_sem);
+}
+//--------- End of function BandRender::run ---------//
+
+
+//-------- Begin of function BandRender::thread_main --------//
+
+int BandRender::thread_main(void* threadPara)
+{
+	BandThread* threadPtr = (BandThread*) threadPara;
+	BandRender* owner = threadPtr->owner;
+
+	while( 1 )
+	{
+		SDL_SemWait(threadPtr->start_sem);
+
+		if( owner->quit_flag )
+			break;
+
+		owner->draw_func( owner->draw_para, threadPtr->row1, threadPtr->row2 );
+
+		SDL_SemPost(owner->done_sem);
+	}
+
+	return 0;
+}
+//--------- End of function BandRender::thread_main ---------//
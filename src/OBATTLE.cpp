@@ -105,6 +105,13 @@ void Battle::run(NewNationPara *mpGame, int mpPlayerCount)
 		seedFile.file_close();
 	#endif
 
+	//--- multiplayer games and replays always use maps of the standard size ---//
+
+	if( mpGame || !cmd_line.map_size )
+		world.set_map_size(DEFAULT_WORLD_LOC_SIZE, DEFAULT_WORLD_LOC_SIZE);
+	else
+		world.set_map_size(cmd_line.map_size, cmd_line.map_size);
+
 	world.generate_map();
 
 	//------- create player nation --------//
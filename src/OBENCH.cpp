@@ -0,0 +1,653 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OBENCH.CPP
+//Description : Headless simulation benchmark
+
+#include <stdio.h>
+#include <string.h>
+#include <ALL.h>
+#include <OSYS.h>
+#include <OGAME.h>
+#include <OGFILE.h>
+#include <OSaveGameProvider.h>
+#include <OUNIT.h>
+#include <OFIRM.h>
+#include <OTOWN.h>
+#include <ONATION.h>
+#include <OBATTLE.h>
+#include <OREMOTE.h>
+#include <OCRC_STO.h>
+#include <CRC.h>
+#include <OPROFILE.h>
+#include <OSPLOG.h>
+#include <OWORLD.h>
+#include <OINFO.h>
+#include <CmdLine.h>
+#include <IMGFUN.h>
+#include <COLCODE.h>
+#include <OBENCH.h>
+
+//-------- Begin of function Bench::Bench --------//
+
+Bench::Bench()
+{
+	memset( this, 0, sizeof(Bench) );
+}
+//--------- End of function Bench::Bench ---------//
+
+
+//-------- Begin of function Bench::run --------//
+//
+// Load a saved game or scenario and process a fixed number of frames
+// as fast as possible without display, then print the timing report.
+//
+// <char*> filePath   - full path of the .SAV or .SCN file
+// <int>   frameCount - no. of frames to process
+//
+// return : <int> 1 - the benchmark has completed
+//                0 - the file could not be loaded
+//
+int Bench::run(const char* filePath, int frameCount)
+{
+	if( SaveGameProvider::load_scenario(filePath) <= 0 )
+	{
+		printf( "Unable to load %s: %s\n", filePath, GameFile::status_str() );
+		game.deinit();
+		return 0;
+	}
+
+	//---- don't bring up the winning or losing screen in the middle of a run ----//
+
+	game.game_has_ended = 1;
+
+	frame_limit = frameCount;
+	frame_count = 0;
+	total_time  = 0;
+
+	profiler.init();
+
+	active_flag = 1;
+	sys.run_bench(frameCount);
+	active_flag = 0;
+
+	report(filePath);
+
+	if( cmd_line.profile_file )
+	{
+		if( profiler.dump_trace(cmd_line.profile_file) )
+			printf( "Trace written to %s\n", cmd_line.profile_file );
+		else
+			printf( "Unable to write trace to %s\n", cmd_line.profile_file );
+	}
+
+	game.deinit();
+	return 1;
+}
+//--------- End of function Bench::run ---------//
+
+
+//-------- Begin of function Bench::run_replay --------//
+//
+// Play back a replay as fast as the simulation can process it, without
+// pacing or display, then print the timing report and the final object
+// CRCs. The object CRCs recorded in the replay are compared as it plays.
+//
+// <char*> filePath   - full path of the replay file
+// <int>   frameCount - max. no. of frames to process, 0 to play the whole replay
+//
+// return : <int> 1 - the replay has been played back without a sync error
+//                0 - the file could not be loaded or the game went out of sync
+//
+int Bench::run_replay(char* filePath, int frameCount)
+{
+	NewNationPara *mpGame = (NewNationPara *)mem_add(sizeof(NewNationPara)*MAX_NATION);
+	int mpPlayerCount = 0;
+
+	if( !remote.init_replay_load(filePath, mpGame, &mpPlayerCount) )
+	{
+		printf( "Unable to load replay %s\n", filePath );
+		mem_del(mpGame);
+		return 0;
+	}
+
+	remote.sync_test_level |= 2;		// always compare the object CRCs if the replay has them
+
+	game.init();
+	game.game_mode = GAME_DEMO;
+	game.game_has_ended = 1;
+
+	frame_limit = frameCount;
+	frame_count = 0;
+	total_time  = 0;
+
+	profiler.init();
+
+	//--- Battle::run() sets up the nations and then calls Sys::run(), which hands over to Sys::run_bench() ---//
+
+	active_flag = 1;
+	battle.run(mpGame, mpPlayerCount);
+	active_flag = 0;
+
+	report(filePath);
+
+	printf( "Replay end reached: %s\n", remote.is_replay_end() ? "yes" : "no" );
+
+	int rc = report_crc();
+
+	if( cmd_line.profile_file )
+	{
+		if( profiler.dump_trace(cmd_line.profile_file) )
+			printf( "Trace written to %s\n", cmd_line.profile_file );
+		else
+			printf( "Unable to write trace to %s\n", cmd_line.profile_file );
+	}
+
+	fflush(stdout);
+
+	mem_del(mpGame);
+	remote.deinit();
+	game.deinit();
+
+	return rc;
+}
+//--------- End of function Bench::run_replay ---------//
+
+
+//-------- Begin of function Bench::run_path --------//
+//
+// Load a saved game or scenario and replay a log of path searches
+// recorded from it, then print the timings of the searches.
+//
+// <char*> filePath    - full path of the .SAV or .SCN file
+// <char*> logFilePath - full path of the path log
+//
+// return : <int> 1 - the searches have been replayed
+//                0 - the game or the log could not be loaded
+//
+int Bench::run_path(const char* filePath, const char* logFilePath)
+{
+	if( SaveGameProvider::load_scenario(filePath) <= 0 )
+	{
+		printf( "Unable to load %s: %s\n", filePath, GameFile::status_str() );
+		game.deinit();
+		return 0;
+	}
+
+	printf( "Benchmark: %s\n", filePath );
+
+	int rc = seek_path_log.replay(logFilePath);
+
+	if( !rc )
+		printf( "Unable to read path log %s\n", logFilePath );
+
+	fflush(stdout);
+
+	game.deinit();
+	return rc;
+}
+//--------- End of function Bench::run_path ---------//
+
+
+//-------- Begin of function Bench::run_plant --------//
+//
+// Generate a map with dense forests and run the daily plant operations
+// on it twice from the same state, once with the plant registry and once
+// sampling every location as before, then print the cost per day of each
+// and whether they have come to the same result.
+//
+// <int> dayCount - no. of days to run
+//
+// return : <int> 1 - both runs have come to the same result
+//                0 - the results differ
+//
+int Bench::run_plant(int dayCount)
+{
+	const int PLANT_BENCH_SEED = 1;
+	const int PLANT_BENCH_EXTRA_FOREST = 4;		// no. of times the forests are sprayed again after generating the map
+
+	game.init();
+	info.init_random_seed(PLANT_BENCH_SEED);
+
+	if( cmd_line.map_size )
+		world.set_map_size(cmd_line.map_size, cmd_line.map_size);
+	else
+		world.set_map_size(DEFAULT_WORLD_LOC_SIZE, DEFAULT_WORLD_LOC_SIZE);
+
+	world.generate_map();
+
+	//-------- make the forests denser ---------//
+
+	int i;
+
+	for( i=0 ; i<PLANT_BENCH_EXTRA_FOREST ; i++ )
+		world.plant_init();
+
+	int locCount = world.max_x_loc * world.max_y_loc;
+	int plantCount = 0;
+
+	for( i=0 ; i<locCount ; i++ )
+	{
+		if( world.loc_matrix[i].is_plant() )
+			plantCount++;
+	}
+
+	world.plant_count = plantCount;
+	world.plant_limit = plantCount * 3 / 2;
+
+	//------- keep the state both runs start from -------//
+
+	Location* startMatrix = (Location*) mem_add( sizeof(Location) * locCount );
+	memcpy( startMatrix, world.loc_matrix, sizeof(Location) * locCount );
+
+	long startSeed = misc.get_random_seed();
+
+	//--------- run with the plant registry ---------//
+
+	uint64_t registryTime = time_plant_ops(dayCount);
+
+	Location* registryMatrix = (Location*) mem_add( sizeof(Location) * locCount );
+	memcpy( registryMatrix, world.loc_matrix, sizeof(Location) * locCount );
+
+	long registrySeed  = misc.get_random_seed();
+	int  registryCount = world.plant_count;
+
+	//------ run again from the same state, sampling every location ------//
+
+	memcpy( world.loc_matrix, startMatrix, sizeof(Location) * locCount );
+
+	world.build_walk_matrix();
+	world.build_fire_set();
+	world.build_plant_set();
+
+	misc.set_random_seed(startSeed);
+	world.plant_count = plantCount;
+	world.plant_limit = plantCount * 3 / 2;
+
+	world.plant_full_scan = 1;
+	uint64_t fullScanTime = time_plant_ops(dayCount);
+	world.plant_full_scan = 0;
+
+	int sameFlag = misc.get_random_seed() == registrySeed && world.plant_count == registryCount &&
+						!memcmp( world.loc_matrix, registryMatrix, sizeof(Location) * locCount );
+
+	//------------ print the report -------------//
+
+	double usPerTick = 1000000.0 / (double) Profiler::get_frequency();
+
+	printf( "Plant benchmark: %d days, seed %d, map %dx%d\n", dayCount, PLANT_BENCH_SEED, MAX_WORLD_X_LOC, MAX_WORLD_Y_LOC );
+	printf( "Plants: %d at start, %d at end\n", plantCount, registryCount );
+	printf( "Time per day us: registry %.2f  full scan %.2f  speedup %.2fx\n",
+		registryTime * usPerTick / dayCount, fullScanTime * usPerTick / dayCount,
+		registryTime ? (double) fullScanTime / registryTime : 0.0 );
+	printf( "Results: %s\n", sameFlag ? "identical" : "DIFFERENT" );
+
+	fflush(stdout);
+
+	mem_del(registryMatrix);
+	mem_del(startMatrix);
+
+	game.deinit();
+	return sameFlag;
+}
+//--------- End of function Bench::run_plant ---------//
+
+
+//-------- Begin of function Bench::time_plant_ops --------//
+//
+// return : <uint64_t> the time taken by the given no. of days of
+//                     World::plant_ops(), in performance counter ticks
+//
+uint64_t Bench::time_plant_ops(int dayCount)
+{
+	uint64_t startTime = Profiler::get_counter();
+
+	for( int i=0 ; i<dayCount ; i++ )
+		world.plant_ops();
+
+	return Profiler::get_counter() - startTime;
+}
+//--------- End of function Bench::time_plant_ops ---------//
+
+
+//-------- Begin of function Bench::run_blit --------//
+//
+// Draw random bitmaps with the image functions which have fast paths in
+// their C versions, once on the fast path and once pixel by pixel as the
+// original versions do, then print the time taken by each and whether
+// they have drawn the same pixels.
+//
+// return : <int> 1 - all functions have drawn the same pixels on both paths
+//                0 - some pixels differ
+//
+int Bench::run_blit()
+{
+#ifdef USE_ASM
+	printf( "Blit test: the image functions are the x86 asm versions, there are no fast paths to compare\n" );
+	fflush(stdout);
+	return 1;
+#else
+	const int BLIT_TEST_SEED = 1;
+	const int BLIT_TEST_CASES = 2000;
+	const int BLIT_TEST_REPEAT = 10;				// each function is called this many times for each case to time it
+	const int BLIT_FUNC_COUNT = 3;
+	const int BUF_PITCH = 320, BUF_HEIGHT = 200;
+	const int MAX_BITMAP_SIZE = 160;
+
+	static const char* funcNameArray[BLIT_FUNC_COUNT] = { "IMGbltTrans", "IMGbltTransRemap", "IMGbltTransDecompress" };
+	static const int transPercentArray[] = { 0, 30, 60, 90, 100 };
+
+	//------- allocate the buffers --------//
+
+	int	bufSize = BUF_PITCH * BUF_HEIGHT;
+	char* backBuf = mem_add( bufSize );
+	char* refBuf  = mem_add( bufSize );
+	char* fastBuf = mem_add( bufSize );
+
+	char* bitmapBuf		= mem_add( 4 + MAX_BITMAP_SIZE*MAX_BITMAP_SIZE );
+	char* compressedBuf = mem_add( 4 + 2*MAX_BITMAP_SIZE*MAX_BITMAP_SIZE );		// a transparent run takes at most 2 bytes
+
+	//--- the bitmap bytes index the color table as chars, which may be negative ---//
+
+	char	colorTableBuf[512];
+	char* colorTable = colorTableBuf+256;
+
+	misc.set_random_seed(BLIT_TEST_SEED);
+
+	int i;
+
+	for( i=0 ; i<512 ; i++ )
+		colorTableBuf[i] = (char) misc.random(256);
+
+	uint64_t timeArray[BLIT_FUNC_COUNT][2];			// [func][IMGreferenceFlag]
+	int		diffCountArray[BLIT_FUNC_COUNT];
+
+	memset( timeArray, 0, sizeof(timeArray) );
+	memset( diffCountArray, 0, sizeof(diffCountArray) );
+
+	for( int caseId=0 ; caseId<BLIT_TEST_CASES ; caseId++ )
+	{
+		int width  = 1 + misc.random(MAX_BITMAP_SIZE);
+		int height = 1 + misc.random(MAX_BITMAP_SIZE);
+		int x		  = misc.random(BUF_PITCH-width+1);
+		int y		  = misc.random(BUF_HEIGHT-height+1);
+		int transPercent = transPercentArray[ misc.random(sizeof(transPercentArray)/sizeof(transPercentArray[0])) ];
+
+		for( i=0 ; i<bufSize ; i++ )
+			backBuf[i] = (char) misc.random(256);
+
+		for( int funcId=0 ; funcId<BLIT_FUNC_COUNT ; funcId++ )
+		{
+			//--- the compressed bitmaps must not have normal pixels with transparent codes ---//
+
+			if( funcId==2 )
+			{
+				make_blit_bitmap( bitmapBuf, width, height, transPercent, MIN_TRANSPARENT_CODE-1 );
+				compress_blit_bitmap( compressedBuf, bitmapBuf );
+			}
+			else
+			{
+				make_blit_bitmap( bitmapBuf, width, height, transPercent, TRANSPARENT_CODE-1 );
+			}
+
+			//---- draw on the reference path, then on the fast path ----//
+
+			for( int refFlag=1 ; refFlag>=0 ; refFlag-- )
+			{
+				char* imageBuf = refFlag ? refBuf : fastBuf;
+
+				memcpy( imageBuf, backBuf, bufSize );
+
+				IMGreferenceFlag = refFlag;
+
+				uint64_t startTime = Profiler::get_counter();
+
+				for( int r=0 ; r<BLIT_TEST_REPEAT ; r++ )		// drawing the same bitmap again gives the same pixels
+				{
+					switch( funcId )
+					{
+						case 0:
+							IMGbltTrans( imageBuf, BUF_PITCH, x, y, bitmapBuf );
+							break;
+						case 1:
+							IMGbltTransRemap( imageBuf, BUF_PITCH, x, y, bitmapBuf, colorTable );
+							break;
+						case 2:
+							IMGbltTransDecompress( imageBuf, BUF_PITCH, x, y, compressedBuf );
+							break;
+					}
+				}
+
+				timeArray[funcId][refFlag] += Profiler::get_counter() - startTime;
+			}
+
+			IMGreferenceFlag = 0;
+
+			if( memcmp(refBuf, fastBuf, bufSize) )
+				diffCountArray[funcId]++;
+		}
+	}
+
+	//------------ print the report -------------//
+
+	double usPerTick = 1000000.0 / (double) Profiler::get_frequency();
+	int	 sameFlag = 1;
+
+	printf( "Blit test: %d cases, seed %d, %s\n", BLIT_TEST_CASES, BLIT_TEST_SEED,
+#ifdef IMG_USE_SSE2
+		"SSE2"
+#else
+		"no SSE2"
+#endif
+		);
+
+	for( int funcId=0 ; funcId<BLIT_FUNC_COUNT ; funcId++ )
+	{
+		printf( "%-24s reference %8.0f us  fast %8.0f us  speedup %.2fx  %s\n", funcNameArray[funcId],
+			timeArray[funcId][1] * usPerTick, timeArray[funcId][0] * usPerTick,
+			timeArray[funcId][0] ? (double) timeArray[funcId][1] / timeArray[funcId][0] : 0.0,
+			diffCountArray[funcId] ? "DIFFERENT" : "identical" );
+
+		if( diffCountArray[funcId] )
+		{
+			printf( "%-24s %d cases differ\n", "", diffCountArray[funcId] );
+			sameFlag = 0;
+		}
+	}
+
+	printf( "Results: %s\n", sameFlag ? "identical" : "DIFFERENT" );
+
+	fflush(stdout);
+
+	mem_del(compressedBuf);
+	mem_del(bitmapBuf);
+	mem_del(fastBuf);
+	mem_del(refBuf);
+	mem_del(backBuf);
+
+	return sameFlag;
+#endif
+}
+//--------- End of function Bench::run_blit ---------//
+
+
+//-------- Begin of function Bench::make_blit_bitmap --------//
+//
+// Fill a bitmap with runs of transparent and of random normal pixels.
+//
+// <char*> bitmapBuf     - the bitmap, with room for 4 + width*height bytes
+// <int>   width, height - the size of the bitmap
+// <int>   transPercent  - the chance of a run being transparent
+// <int>   maxColor      - the highest color of the normal pixels
+//
+void Bench::make_blit_bitmap(char* bitmapBuf, int width, int height, int transPercent, int maxColor)
+{
+	const int MAX_BLIT_RUN = 40;
+
+	*((short*)bitmapBuf)   = width;
+	*((short*)bitmapBuf+1) = height;
+
+	char* pixelPtr = bitmapBuf+4;
+	int	pixelCount = width * height;
+
+	for( int i=0 ; i<pixelCount ; )
+	{
+		int runLen	 = 1 + misc.random(MAX_BLIT_RUN);
+		int transFlag = misc.random(100) < transPercent;
+
+		runLen = MIN( runLen, pixelCount-i );
+
+		for( ; runLen>0 ; runLen--, i++ )
+			pixelPtr[i] = transFlag ? (char) TRANSPARENT_CODE : (char) misc.random(maxColor+1);
+	}
+}
+//--------- End of function Bench::make_blit_bitmap ---------//
+
+
+//-------- Begin of function Bench::compress_blit_bitmap --------//
+//
+// Compress a bitmap made by make_blit_bitmap() in the format read by
+// IMGbltTransDecompress(). Transparent runs carry on to the next line.
+//
+// <char*> destBuf   - the buffer for the compressed bitmap
+// <char*> bitmapBuf - the bitmap to compress
+//
+// return : <int> the size of the compressed bitmap
+//
+int Bench::compress_blit_bitmap(char* destBuf, char* bitmapBuf)
+{
+	int pixelCount = *((short*)bitmapBuf) * *((short*)bitmapBuf+1);
+
+	memcpy( destBuf, bitmapBuf, 4 );
+
+	unsigned char* srcPtr  = (unsigned char*) bitmapBuf + 4;
+	unsigned char* destPtr = (unsigned char*) destBuf + 4;
+
+	for( int i=0 ; i<pixelCount ; )
+	{
+		if( srcPtr[i] != TRANSPARENT_CODE )
+		{
+			*destPtr++ = srcPtr[i++];
+			continue;
+		}
+
+		int runLen = 1;
+
+		while( i+runLen < pixelCount && runLen < 255 && srcPtr[i+runLen] == TRANSPARENT_CODE )
+			runLen++;
+
+		if( runLen <= MAX_TRANSPARENT_CODE-MIN_TRANSPARENT_CODE )
+		{
+			*destPtr++ = FEW_TRANSPARENT_CODE(runLen);
+		}
+		else
+		{
+			*destPtr++ = MANY_TRANSPARENT_CODE;
+			*destPtr++ = runLen;
+		}
+
+		i += runLen;
+	}
+
+	return int(destPtr - (unsigned char*) destBuf);
+}
+//--------- End of function Bench::compress_blit_bitmap ---------//
+
+
+//-------- Begin of function Bench::begin_frame --------//
+
+void Bench::begin_frame()
+{
+	frame_start_time = Profiler::get_counter();
+}
+//--------- End of function Bench::begin_frame ---------//
+
+
+//-------- Begin of function Bench::end_frame --------//
+
+void Bench::end_frame()
+{
+	total_time += Profiler::get_counter() - frame_start_time;
+	frame_count++;
+}
+//--------- End of function Bench::end_frame ---------//
+
+
+//-------- Begin of function Bench::report --------//
+
+void Bench::report(const char* filePath)
+{
+	double freq = (double) Profiler::get_frequency();
+	double totalSec = total_time / freq;
+
+	printf( "Benchmark: %s\n", filePath );
+	printf( "Map: %dx%d\n", MAX_WORLD_X_LOC, MAX_WORLD_Y_LOC );
+	printf( "Frames: %d  Time: %.3f s  Frames/sec: %.1f\n",
+		frame_count, totalSec, totalSec > 0 ? frame_count / totalSec : 0.0 );
+	printf( "Units: %d  Firms: %d  Towns: %d  Nations: %d\n",
+		unit_array.size(), firm_array.size(), town_array.size(), nation_array.nation_count );
+	printf( "Random seed: %ld\n", (long) misc.get_random_seed() );
+
+	profiler.print_tree(stdout, frame_count);
+
+	fflush(stdout);
+}
+//--------- End of function Bench::report ---------//
+
+
+//-------- Begin of function Bench::report_crc --------//
+//
+// Print the CRC of each object array at the end of the run and whether
+// the game went out of sync with the CRCs recorded in the replay.
+//
+// return : <int> 1 - no sync error
+//                0 - sync error
+//
+int Bench::report_crc()
+{
+	static const char* arrayName[] = { "Nations", "Units", "Firms", "Towns", "Bullets", "Rebels", "Spies", "Talk msgs" };
+	VLenQueue* queueArray[] = { &crc_store.nations, &crc_store.units, &crc_store.firms, &crc_store.towns,
+		&crc_store.bullets, &crc_store.rebels, &crc_store.spies, &crc_store.talk_msgs };
+
+	crc_store.record_all();
+
+	printf( "Final CRCs:" );
+
+	for( int i=0 ; i<int(sizeof(queueArray)/sizeof(queueArray[0])) ; i++ )
+	{
+		printf( " %s=%02x", arrayName[i],
+			crc8((unsigned char*) queueArray[i]->queue_buf, queueArray[i]->length()) );
+	}
+
+	printf( "\n" );
+
+	//--- Remote::sync_test_level is set to ~2 by RemoteMsg::compare_remote_object() when a discrepancy is found ---//
+
+	if( remote.sync_test_level < 0 )
+	{
+		printf( "Sync error: %s\n", (char*) crc_store.crc_error_string );
+		return 0;
+	}
+
+	printf( "Sync: OK\n" );
+	return 1;
+}
+//--------- End of function Bench::report_crc ---------//
+
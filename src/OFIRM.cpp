@@ -52,6 +52,7 @@
 #include <OFIRMDIE.h>
 // ###### end Gilbert 2/10 ######//
 #include <OUNITRES.h>
+#include <OLINKGRD.h>
 #include <locale.h>
 #include "gettext.h"
 
@@ -264,6 +265,8 @@ void Firm::init(int xLoc, int yLoc, int nationRecno, int firmId, const char* bui
 
    //--------------------------------------------//
 
+	link_grid.add_firm(this);
+
 	setup_link();
 
 	set_world_matrix();
@@ -312,6 +315,8 @@ void Firm::deinit()
 	restore_world_matrix();
 	release_link();
 
+	link_grid.del_firm(this);
+
 	//------ all workers and the overseer resign ------//
 
 	if( !sys.signal_exit_flag )
@@ -3044,8 +3049,12 @@ void Firm::setup_link()
 
 	linked_firm_count = 0;
 
-	for( firmRecno=firm_array.size() ; firmRecno>0 ; firmRecno-- )
+	int i, nearCount = link_grid.near_firm( center_x, center_y, EFFECTIVE_FIRM_FIRM_DISTANCE );
+
+	for( i=0 ; i<nearCount ; i++ )
 	{
+		firmRecno = link_grid.near_recno_array[i];
+
 		if( firm_array.is_deleted(firmRecno) || firmRecno==firm_recno )
 			continue;
 
@@ -3135,8 +3144,12 @@ void Firm::setup_link()
    int   townRecno;
    Town* townPtr;
 
-   for( townRecno=town_array.size() ; townRecno>0 ; townRecno-- )
+   nearCount = link_grid.near_town( center_x, center_y, EFFECTIVE_FIRM_TOWN_DISTANCE );
+
+   for( i=0 ; i<nearCount ; i++ )
    {
+      townRecno = link_grid.near_recno_array[i];
+
       if( town_array.is_deleted(townRecno) )
          continue;
 
@@ -521,6 +521,7 @@ void FirmArray::draw_dot()
 	char*   	   nationColorArray = nation_array.nation_color_array;
 	char	  		nationColor;
 	int			vgaBufPitch = vga_back.buf_pitch();
+	int			locScale = MAP_LOC_SCALE;
 	const unsigned int excitedColorCount = 4;
 	char excitedColorArray[MAX_NATION+1][excitedColorCount];
 	for( i = 0; i <= MAX_NATION; ++i )
@@ -551,7 +552,7 @@ void FirmArray::draw_dot()
 
 		firmBuild = firm_res.get_build(firmPtr->firm_build_id);
 
-		writePtr = vgaBufPtr + (MAP_Y1+firmPtr->loc_y1)*vgaBufPitch + (MAP_X1+firmPtr->loc_x1);
+		writePtr = vgaBufPtr + (MAP_Y1+firmPtr->loc_y1/locScale)*vgaBufPitch + (MAP_X1+firmPtr->loc_x1/locScale);
 
 		nationColor = info.game_date - firmPtr->last_attacked_date > 2 ?
 			nationColorArray[firmPtr->nation_recno] :
@@ -569,6 +570,9 @@ void FirmArray::draw_dot()
 			--firmHeight;
 		}
 
+		firmWidth  = (firmWidth +locScale-1) / locScale;
+		firmHeight = (firmHeight+locScale-1) / locScale;
+
 		for( y=firmHeight ; y>0 ; y--, writePtr+=vgaBufPitch-firmWidth )
 		{
 			for( x=firmWidth ; x>0 ; x--, writePtr++ )
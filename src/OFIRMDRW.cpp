@@ -36,6 +36,7 @@
 #include <OF_BASE.h>
 #include <OSE.h>
 #include <OREMOTE.h>
+#include <OSPRSPAN.h>
 
 //------- define static vars -------//
 
@@ -239,7 +240,7 @@ void Firm::draw_full_size(int displayLayer)
 
 		if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < 0 || y2 >= ZOOM_HEIGHT )
 		{
-			vga_back.put_bitmap_area_trans_remap_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, firmBitmap->bitmap_ptr,
+			sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, firmBitmap->bitmap_ptr,
 				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable );
 		}
 
@@ -247,7 +248,7 @@ void Firm::draw_full_size(int displayLayer)
 
 		else
 		{
-			vga_back.put_bitmap_trans_remap_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, firmBitmap->bitmap_ptr, colorRemapTable );
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, firmBitmap->bitmap_ptr, colorRemapTable );
 		}
 	}
 
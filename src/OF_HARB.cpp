@@ -187,9 +187,9 @@ void FirmHarbor::init(int xLoc, int yLoc, int nationRecno, int firmId, const cha
 
 	region_id = land_region_id;		// set region_id to land_region_id
 
-	//------- update the harbor count of the regions ------//
+	//------- update the harbor count of the land region ------//
 
-	region_array.update_region_stat();
+	region_array.update_region_stat(land_region_id);
 }
 //----------- End of function FirmHarbor::init -----------//
 
@@ -61,6 +61,9 @@
 #include <OSNOWG.h>
 #include <OEXPMASK.h>
 #include <OSE.h>
+#include <OSPATH.h>
+#include <OSPFLOW.h>
+#include <OSPCACHE.h>
 #include <OSERES.h>
 #include <OROCKRES.h>
 #include <OROCK.h>
@@ -71,6 +74,7 @@
 #include <OWARPT.h>
 // ##### begin Gilbert 2/10 #######//
 #include <OFIRMDIE.h>
+#include <OSPRSPAN.h>
 // ##### end Gilbert 2/10 #######//
 #include <ConfigAdv.h>
 
@@ -174,6 +178,10 @@ int Game::init(int loadGameCall)
 	tornado_array.init();
 	war_point_array.init();
 
+	seek_path.clear_suspended_search();
+	flow_field.clear();
+	seek_path_cache.clear();
+
 	if( config_adv.big_dynarray_mode )
 	{
 		firm_array.resize(5000);
@@ -296,6 +304,8 @@ void Game::deinit(int loadGameCall)
 
 	//------- deinit game data class ---------//
 
+	sprite_span_cache.deinit();		// the bitmaps decoded from the resources below
+
 	image_tpict.deinit();
 	terrain_res.deinit();
 	plant_res.deinit();
@@ -24,6 +24,7 @@
 
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <ALL.h>
 #include <OGAME.h>
@@ -312,7 +313,7 @@ void World::generate_map()
 
 	do
 	{
-		locPtr = zoom_matrix->get_loc(misc.random(MAX_MAP_WIDTH), misc.random(MAX_MAP_HEIGHT));
+		locPtr = zoom_matrix->get_loc(misc.random(MAX_WORLD_X_LOC), misc.random(MAX_WORLD_Y_LOC));
 		if( locPtr->flammability > 0)
 		{
 			locPtr->fire_level = 80;
@@ -657,35 +658,27 @@ void World::substitute_pattern()
 
 //---------- Begin of function World::set_region_id -----//
 // must be called before any mountain or buildings on the map
-static RegionType walkable;					// to save stack space
-static unsigned char regionId;
 void World::set_region_id()
 {
 	int            i,x,y;
 	int            totalLoc=max_x_loc * max_y_loc;
 	Location*      locPtr=loc_matrix;
+	int            regionId;
+
+	//------- label the land and sea areas ---------//
+
+	int* labelMatrix = (int*) mem_add( sizeof(int) * totalLoc );
+
+	regionId = label_region(labelMatrix);
 
-	// -------- reset region_id to zero
 	for( i=0 ; i<totalLoc ; i++, locPtr++ )
 	{
-		locPtr->region_id = 0;
+		locPtr->region_id = (uint16_t) labelMatrix[i];
 	}
 
-	regionId = 0;
-	for( y = 0; y < max_y_loc; ++y)
-	{
-		locPtr = get_loc(0,y);
-		for( x = 0; x < max_x_loc; ++x, ++locPtr)
-		{
-			if( !locPtr->region_id && locPtr->region_type() != REGION_INPASSABLE)
-			{
-				walkable = locPtr->region_type();
-				++regionId;
-				fill_region(x,y);
-				err_when( regionId == 255);
-			}
-		}
-	}
+	mem_del( labelMatrix );
+
+	err_when( regionId >= MAX_REGION );
 
 	region_array.init(regionId);
 
@@ -746,58 +739,122 @@ void World::set_region_id()
 	//-------- initialize region_stat_array ----------//
 
 	region_array.init_region_stat();
+
+	build_region_matrix();
 }
 //---------- End of function World::set_region_id -----//
 
 
-//---------- Begin of function World::fill_region -----//
-void World::fill_region(short x, short y)
+//------- Begin of static function find_region_root -------//
+//
+// Find the label a label has been merged into, halving the path to it.
+//
+static int find_region_root(int* parentArray, int label)
 {
-	err_when( x < 0 || x >= max_x_loc || y < 0 || y >= max_y_loc);
-
-	short left, right;
-	// Location *locPtr;
-
-	// extent x to left and right
-	for( left = x; left >= 0 && !get_loc(left,y)->region_id && get_loc(left,y)->region_type() == walkable; --left)
+	while( parentArray[label] != label )
 	{
-		get_loc(left,y)->region_id = regionId;
+		parentArray[label] = parentArray[parentArray[label]];
+		label = parentArray[label];
 	}
-	++left;
 
-	for( right=x+1; right < max_x_loc && !get_loc(right,y)->region_id && get_loc(right,y)->region_type() == walkable; ++right)
-	{
-		get_loc(right,y)->region_id = regionId;
-	}
-	--right;
+	return label;
+}
+//-------- End of static function find_region_root --------//
+
+
+//---------- Begin of function World::label_region -----//
+//
+// Label the 8-connected land and sea areas of the map without recursion.
+// Each run of locations of the same region type on a row is given a
+// label, which is merged with the labels of the touching runs on the row
+// above. The areas are then numbered in the order of their first
+// location on the map, the order in which they used to be flood filled.
+//
+// <int*> labelMatrix - [max_x_loc*max_y_loc] returns the area of each
+//                      location, 0 for impassable locations
+//
+// return : <int> the no. of areas
+//
+int World::label_region(int* labelMatrix)
+{
+	int  totalLoc = max_x_loc * max_y_loc;
+	int* parentArray = (int*) mem_add( sizeof(int) * (totalLoc+1) );
+	int  runCount = 0;
 
-	// ------- scan line below ---------//
-	y++;
-	if( y < max_y_loc )
+	for( int y=0 ; y<max_y_loc ; y++ )
 	{
-		for( x = left>0?left-1:0 ; x <= right+1 && x < max_x_loc; ++x )
+		Location* locPtr = get_loc(0, y);
+		int*		 labelPtr = labelMatrix + y * max_x_loc;
+
+		for( int x=0 ; x<max_x_loc ; )
 		{
-			if( !get_loc(x,y)->region_id && get_loc(x,y)->region_type() == walkable)
+			RegionType regionType = locPtr[x].region_type();
+
+			if( regionType == REGION_INPASSABLE )
 			{
-				fill_region(x,y);
+				labelPtr[x++] = 0;
+				continue;
 			}
-		}
-	}
 
-	// ------- scan line above -------- //
-	y -= 2;
-	if( y >= 0)
-	{
-		for( x = left>0?left-1:0 ; x <= right+1 && x < max_x_loc; ++x )
-		{
-			if( !get_loc(x,y)->region_id && get_loc(x,y)->region_type() == walkable)
+			//------ give a new label to the run ------//
+
+			int x1 = x;
+			int runLabel = ++runCount;
+
+			parentArray[runLabel] = runLabel;
+
+			for( ; x<max_x_loc && locPtr[x].region_type()==regionType ; x++ )
+				labelPtr[x] = runLabel;
+
+			//--- merge it with the touching runs of the row above ---//
+
+			if( y==0 )
+				continue;
+
+			for( int adjX=MAX(x1-1,0) ; adjX<=MIN(x,max_x_loc-1) ; adjX++ )
 			{
-				fill_region(x,y);
+				int adjLabel = labelPtr[adjX-max_x_loc];
+
+				if( !adjLabel || locPtr[adjX-max_x_loc].region_type() != regionType )
+					continue;
+
+				int root1 = find_region_root(parentArray, adjLabel);
+				int root2 = find_region_root(parentArray, runLabel);
+
+				if( root1 < root2 )		// the root is always the first run of the area
+					parentArray[root2] = root1;
+				else
+					parentArray[root1] = root2;
 			}
 		}
 	}
+
+	//----- number the areas in the order of their first run -----//
+
+	int* areaIdArray = (int*) mem_add( sizeof(int) * (runCount+1) );
+	int  areaCount = 0;
+
+	areaIdArray[0] = 0;		// impassable locations
+
+	for( int label=1 ; label<=runCount ; label++ )
+	{
+		int root = find_region_root(parentArray, label);
+
+		if( root == label )
+			areaIdArray[label] = ++areaCount;
+		else
+			areaIdArray[label] = areaIdArray[root];		// root < label, so it has been numbered
+	}
+
+	for( int i=0 ; i<totalLoc ; i++ )
+		labelMatrix[i] = areaIdArray[labelMatrix[i]];
+
+	mem_del( areaIdArray );
+	mem_del( parentArray );
+
+	return areaCount;
 }
-//---------- End of function World::fill_region -----//
+//---------- End of function World::label_region -----//
 
 
 //---------- Begin of function World::set_harbor_bit -----//
@@ -22,6 +22,8 @@
 //Filename    : OGFILE2.CPP
 //Description : Object Game file, save game and restore game, part 2
 
+#include <stddef.h>
+#include <string.h>
 #include <OUNITRES.h>
 #include <OFIRMRES.h>
 
@@ -44,6 +46,8 @@
 #include <OROCK.h>
 #include <OSITE.h>
 #include <OSNOWG.h>
+#include <OSPFLOW.h>
+#include <OSPCACHE.h>
 #include <OSPY.h>
 #include <OSYS.h>
 #include <OTALKRES.h>
@@ -117,6 +121,7 @@ DBGLOG_DEFAULT_CHANNEL(GameFile);
 static int loaded_random_seed;
 
 bool GameFile::read_file_same_version = true;
+short GameFile::load_file_game_version = 0;
 
 //-------- Begin of function GameFile::write_file -------//
 //
@@ -190,7 +195,7 @@ int GameFile::read_file(File* filePtr)
 
 	int originalRandomSeed = misc.get_random_seed();
 
-	short load_file_game_version = filePtr->file_get_short();
+	load_file_game_version = filePtr->file_get_short();
 
 	// compare if same demo format or not
 	if( demo_format && load_file_game_version > 0
@@ -746,6 +751,86 @@ int GameFile::read_book_mark(File* filePtr, short bookMark)
 //---------- End of function GameFile::read_book_mark -------//
 
 
+//-------- Begin of function GameFile::read_region_id_record -------//
+//
+// Read an array of records which are saved as raw memory and contain
+// region ids. Region ids were 8-bit before version 2.13, records of
+// older versions are widened after they are read.
+//
+// <File*> filePtr             - the file to read from
+// <void*> recArray            - the array to read into
+// <int>   recCount            - no. of records in the array
+// <int>   recSize             - size of a record in the current version
+// <int*>  regionIdOffsetArray - offsets of the region ids in a record of the
+//                               current version, in ascending order
+// <int>   regionIdCount       - no. of region ids in a record
+//
+// Return : 1 - read successfully
+//          0 - reading error
+//
+int GameFile::read_region_id_record(File* filePtr, void* recArray, int recCount, int recSize,
+												const int* regionIdOffsetArray, int regionIdCount)
+{
+	if( load_file_game_version >= 213 )
+		return filePtr->file_read( recArray, recSize * recCount );
+
+	if( !filePtr->file_read( recArray, (recSize-regionIdCount) * recCount ) )
+		return 0;
+
+	widen_region_id( recArray, recCount, recSize, regionIdOffsetArray, regionIdCount );
+
+	return 1;
+}
+//---------- End of function GameFile::read_region_id_record -------//
+
+
+//-------- Begin of function GameFile::widen_region_id -------//
+//
+// Convert an array of records read from a game saved before version 2.13
+// to the current layout. The old records are packed at the beginning of
+// recArray, each of them one byte shorter for every 8-bit region id.
+//
+// <void*> recArray            - the array to convert
+// <int>   recCount            - no. of records in the array
+// <int>   recSize             - size of a record in the current version
+// <int*>  regionIdOffsetArray - offsets of the region ids in a record of the
+//                               current version, in ascending order
+// <int>   regionIdCount       - no. of region ids in a record
+//
+void GameFile::widen_region_id(void* recArray, int recCount, int recSize,
+										 const int* regionIdOffsetArray, int regionIdCount)
+{
+	int oldRecSize = recSize - regionIdCount;
+
+	//--- start from the last record, so a record is not overwritten before it is moved ---//
+
+	for( int i=recCount-1 ; i>=0 ; i-- )
+	{
+		char* recPtr = (char*) recArray + recSize * i;
+
+		memmove( recPtr, (char*) recArray + oldRecSize * i, oldRecSize );
+
+		//--- widen the ids from the last one, each one shifts the data after it by a byte ---//
+
+		int oldEnd = oldRecSize;
+
+		for( int j=regionIdCount-1 ; j>=0 ; j-- )
+		{
+			int newOffset = regionIdOffsetArray[j];
+			int oldOffset = newOffset - j;		// the j ids before this one were one byte shorter each
+
+			uint16_t regionId = (uint8_t) recPtr[oldOffset];
+
+			memmove( recPtr+newOffset+sizeof(uint16_t), recPtr+oldOffset+1, oldEnd-oldOffset-1 );
+			memcpy( recPtr+newOffset, &regionId, sizeof(uint16_t) );
+
+			oldEnd = oldOffset;
+		}
+	}
+}
+//---------- End of function GameFile::widen_region_id -------//
+
+
 //***//
 
 
@@ -1417,6 +1502,11 @@ int World::write_file(File* filePtr)
 {
 	//--------- save map -------------//
 
+	settle_visibility();
+
+	filePtr->file_put_short(max_x_loc);
+	filePtr->file_put_short(max_y_loc);
+
 	if( !filePtr->file_write(loc_matrix, max_x_loc*max_y_loc*sizeof(Location) ) )
 		return 0;
 
@@ -1456,10 +1546,30 @@ int World::read_file(File* filePtr)
 {
 	//-------- read in the map --------//
 
+	if( GameFile::load_file_game_version >= 213 )		// the size of the map is saved since version 2.13
+	{
+		int xLoc = filePtr->file_get_short();
+		int yLoc = filePtr->file_get_short();
+
+		if( xLoc < MIN_WORLD_LOC_SIZE || xLoc > MAX_WORLD_LOC_SIZE ||
+			 yLoc < MIN_WORLD_LOC_SIZE || yLoc > MAX_WORLD_LOC_SIZE )
+		{
+			return 0;
+		}
+
+		set_map_size(xLoc, yLoc);
+	}
+	else
+	{
+		set_map_size(DEFAULT_WORLD_LOC_SIZE, DEFAULT_WORLD_LOC_SIZE);
+	}
+
 	loc_matrix = (Location*) mem_resize( loc_matrix, max_x_loc * max_y_loc
 					  * sizeof(Location) );
 
-	if( !filePtr->file_read(loc_matrix, max_x_loc*max_y_loc*sizeof(Location) ) )
+	int regionIdOffset = (int) offsetof(Location, region_id);
+
+	if( !GameFile::read_region_id_record(filePtr, loc_matrix, max_x_loc*max_y_loc, sizeof(Location), &regionIdOffset, 1) )
 		return 0;
 
 	assign_map();
@@ -1534,6 +1644,19 @@ int Tutor::read_file(File* filePtr)
 int SeekPath::write_file(File* filePtr)
 {
 	filePtr->file_put_short(total_node_avail);
+
+	//--- save the suspended searches, flow fields and cached paths, so that ---//
+	//--- units of a loaded game move the same way as in the saved game ---//
+
+	if( !write_suspended_search(filePtr) )
+		return 0;
+
+	if( !flow_field.write_file(filePtr) )
+		return 0;
+
+	if( !seek_path_cache.write_file(filePtr) )
+		return 0;
+
 	return 1;
 }
 //--------- End of function SeekPath::write_file ---------------//
@@ -1544,8 +1667,264 @@ int SeekPath::write_file(File* filePtr)
 int SeekPath::read_file(File* filePtr)
 {
 	total_node_avail =	filePtr->file_get_short();
+
+	//--- suspended searches, flow fields and cached paths are saved since version 2.13 ---//
+
+	if( GameFile::load_file_game_version < 213 )
+	{
+		clear_suspended_search();
+		flow_field.clear();
+		seek_path_cache.clear();
+		return 1;
+	}
+
+	if( !read_suspended_search(filePtr) )
+		return 0;
+
+	if( !flow_field.read_file(filePtr) )
+		return 0;
+
+	if( !seek_path_cache.read_file(filePtr) )
+		return 0;
+
 	return 1;
 }
 //--------- End of function SeekPath::read_file ---------------//
+
+
+//-------- Start of function FlowField::write_file -------------//
+//
+int FlowField::write_file(File* filePtr)
+{
+	FlowFieldInfo* fieldPtr = field_array;
+
+	filePtr->file_put_long(use_count);
+
+	for( int i=0 ; i<MAX_FLOW_FIELD ; i++, fieldPtr++ )
+	{
+		filePtr->file_put_long(fieldPtr->group_id);
+
+		if( !fieldPtr->group_id )
+			continue;
+
+		filePtr->file_put_short(fieldPtr->dest_x_loc);
+		filePtr->file_put_short(fieldPtr->dest_y_loc);
+		filePtr->file_put_short(fieldPtr->dest_radius);
+		filePtr->file_put_unsigned_short(fieldPtr->region_id);
+		filePtr->file_put_short(fieldPtr->dirty_flag);
+		filePtr->file_put_short(fieldPtr->sub_mode);
+		filePtr->file_write(fieldPtr->nation_passable, sizeof(fieldPtr->nation_passable));
+		filePtr->file_put_long(fieldPtr->last_use);
+
+		//------- save the matrices of the field --------//
+
+		const int matrixSize = MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC;
+
+		for( int j=0 ; j<matrixSize ; j++ )
+			filePtr->file_put_unsigned_short(fieldPtr->dist_matrix[j]);
+
+		if( !filePtr->file_write(fieldPtr->dir_matrix, sizeof(uint8_t)*matrixSize) )
+			return 0;
+	}
+
+	return 1;
+}
+//--------- End of function FlowField::write_file ---------------//
+
+
+//-------- Start of function FlowField::read_file -------------//
+//
+int FlowField::read_file(File* filePtr)
+{
+	FlowFieldInfo* fieldPtr = field_array;
+
+	use_count = (uint32_t) filePtr->file_get_long();
+
+	for( int i=0 ; i<MAX_FLOW_FIELD ; i++, fieldPtr++ )
+	{
+		fieldPtr->group_id = (uint32_t) filePtr->file_get_long();
+
+		if( !fieldPtr->group_id )
+		{
+			fieldPtr->last_use = 0;
+			continue;
+		}
+
+		fieldPtr->dest_x_loc  = filePtr->file_get_short();
+		fieldPtr->dest_y_loc  = filePtr->file_get_short();
+		fieldPtr->dest_radius = filePtr->file_get_short();
+		fieldPtr->region_id	 = filePtr->file_get_unsigned_short();
+		fieldPtr->dirty_flag	 = (char) filePtr->file_get_short();
+		fieldPtr->sub_mode	 = (char) filePtr->file_get_short();
+
+		if( !filePtr->file_read(fieldPtr->nation_passable, sizeof(fieldPtr->nation_passable)) )
+			return 0;
+
+		fieldPtr->last_use = (uint32_t) filePtr->file_get_long();
+
+		//------- read the matrices of the field --------//
+
+		const int matrixSize = MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC;
+
+		if( !fieldPtr->dist_matrix )
+		{
+			fieldPtr->dist_matrix = (uint16_t*) mem_add( sizeof(uint16_t) * matrixSize );
+			fieldPtr->dir_matrix  = (uint8_t*) mem_add( sizeof(uint8_t) * matrixSize );
+		}
+
+		for( int j=0 ; j<matrixSize ; j++ )
+			fieldPtr->dist_matrix[j] = filePtr->file_get_unsigned_short();
+
+		if( !filePtr->file_read(fieldPtr->dir_matrix, sizeof(uint8_t)*matrixSize) )
+			return 0;
+	}
+
+	return 1;
+}
+//--------- End of function FlowField::read_file ---------------//
+
+
+//-------- Start of function SeekPathCache::write_file -------------//
+//
+int SeekPathCache::write_file(File* filePtr)
+{
+	PathCacheEntry* entryPtr = entry_array;
+	int i, j;
+
+	filePtr->file_put_long(use_count);
+
+	for( i=0 ; i<PATH_CACHE_BUCKET ; i++ )
+		filePtr->file_put_short(bucket_array[i]);
+
+	for( i=0 ; i<PATH_CACHE_SIZE ; i++, entryPtr++ )
+	{
+		filePtr->file_put_short(entryPtr->next_entry);
+
+		if( entryPtr->next_entry == PATH_CACHE_FREE_ENTRY )
+			continue;
+
+		filePtr->file_put_long(entryPtr->last_use);
+		filePtr->file_put_short(entryPtr->mobile_type);
+		filePtr->file_put_unsigned_short(entryPtr->region_id);
+		filePtr->file_put_short(entryPtr->sour_cell);
+		filePtr->file_put_short(entryPtr->dest_cell);
+
+		filePtr->file_put_short(entryPtr->sour_x_loc);
+		filePtr->file_put_short(entryPtr->sour_y_loc);
+		filePtr->file_put_short(entryPtr->dest_x_loc);
+		filePtr->file_put_short(entryPtr->dest_y_loc);
+		filePtr->file_put_short(entryPtr->search_mode);
+		filePtr->file_put_short(entryPtr->misc_no);
+		filePtr->file_put_short(entryPtr->num_of_path);
+		filePtr->file_put_short(entryPtr->sub_mode);
+		filePtr->file_write(entryPtr->nation_passable, sizeof(entryPtr->nation_passable));
+
+		filePtr->file_put_short(entryPtr->x_loc1);
+		filePtr->file_put_short(entryPtr->y_loc1);
+		filePtr->file_put_short(entryPtr->x_loc2);
+		filePtr->file_put_short(entryPtr->y_loc2);
+		filePtr->file_put_short(entryPtr->path_dist);
+		filePtr->file_put_short(entryPtr->node_count);
+
+		for( j=0 ; j<entryPtr->node_count ; j++ )
+		{
+			filePtr->file_put_short(entryPtr->node_array[j].node_x);
+			filePtr->file_put_short(entryPtr->node_array[j].node_y);
+		}
+	}
+
+	return 1;
+}
+//--------- End of function SeekPathCache::write_file ---------------//
+
+
+//-------- Start of function SeekPathCache::read_file -------------//
+//
+int SeekPathCache::read_file(File* filePtr)
+{
+	PathCacheEntry* entryPtr = entry_array;
+	int i, j, readFlag=1;
+
+	clear();		// free the paths of the current cache
+
+	use_count = (uint32_t) filePtr->file_get_long();
+
+	for( i=0 ; i<PATH_CACHE_BUCKET ; i++ )
+	{
+		bucket_array[i] = filePtr->file_get_short();
+
+		if( bucket_array[i] < -1 || bucket_array[i] >= PATH_CACHE_SIZE )
+			readFlag = 0;
+	}
+
+	for( i=0 ; i<PATH_CACHE_SIZE && readFlag ; i++, entryPtr++ )
+	{
+		entryPtr->next_entry = filePtr->file_get_short();
+
+		if( entryPtr->next_entry == PATH_CACHE_FREE_ENTRY )
+			continue;
+
+		entryPtr->last_use	 = (uint32_t) filePtr->file_get_long();
+		entryPtr->mobile_type = (char) filePtr->file_get_short();
+		entryPtr->region_id	 = filePtr->file_get_unsigned_short();
+		entryPtr->sour_cell	 = filePtr->file_get_short();
+		entryPtr->dest_cell	 = filePtr->file_get_short();
+
+		entryPtr->sour_x_loc	 = filePtr->file_get_short();
+		entryPtr->sour_y_loc	 = filePtr->file_get_short();
+		entryPtr->dest_x_loc	 = filePtr->file_get_short();
+		entryPtr->dest_y_loc	 = filePtr->file_get_short();
+		entryPtr->search_mode = filePtr->file_get_short();
+		entryPtr->misc_no		 = filePtr->file_get_short();
+		entryPtr->num_of_path = filePtr->file_get_short();
+		entryPtr->sub_mode	 = (char) filePtr->file_get_short();
+		filePtr->file_read(entryPtr->nation_passable, sizeof(entryPtr->nation_passable));
+
+		entryPtr->x_loc1		 = filePtr->file_get_short();
+		entryPtr->y_loc1		 = filePtr->file_get_short();
+		entryPtr->x_loc2		 = filePtr->file_get_short();
+		entryPtr->y_loc2		 = filePtr->file_get_short();
+		entryPtr->path_dist	 = filePtr->file_get_short();
+		entryPtr->node_count	 = filePtr->file_get_short();
+
+		if( entryPtr->next_entry < -1 || entryPtr->next_entry >= PATH_CACHE_SIZE ||
+			 entryPtr->node_count < 2 || entryPtr->node_count > PATH_CACHE_MAX_NODE )
+		{
+			readFlag = 0;
+			break;
+		}
+
+		entryPtr->node_array = (ResultNode*) mem_add( sizeof(ResultNode) * entryPtr->node_count );
+
+		for( j=0 ; j<entryPtr->node_count ; j++ )
+		{
+			entryPtr->node_array[j].node_x = filePtr->file_get_short();
+			entryPtr->node_array[j].node_y = filePtr->file_get_short();
+		}
+	}
+
+	if( readFlag )
+		return 1;
+
+	//--- the hash chains cannot be trusted, empty the cache without unlinking the entries ---//
+
+	for( i=0 ; i<PATH_CACHE_SIZE ; i++ )
+	{
+		if( entry_array[i].node_array )
+		{
+			mem_del( entry_array[i].node_array );
+			entry_array[i].node_array = NULL;
+		}
+
+		entry_array[i].next_entry = PATH_CACHE_FREE_ENTRY;
+	}
+
+	for( i=0 ; i<PATH_CACHE_BUCKET ; i++ )
+		bucket_array[i] = -1;
+
+	use_count = 0;
+	return 0;
+}
+//--------- End of function SeekPathCache::read_file ---------------//
 //#### end alex 23/9 ####//
 /* vim:set sw=3 ts=3: */
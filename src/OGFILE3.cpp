@@ -22,11 +22,13 @@
 //Filename    : OGFILE3.CPP
 //Description : Object Game file, save game and restore game, part 3
 
+#include <stddef.h>
 #include <OUNIT.h>
 
 #include <OBULLET.h>
 #include <OB_PROJ.h>
 #include <OFIRM.h>
+#include <OF_HARB.h>
 #include <OGFILE.h>
 #include <ONATION.h>
 #include <ONEWS.h>
@@ -804,6 +806,23 @@ int Projectile::read_derived_file(File *filePtr)
 
 //*****//
 
+//----- region ids are 16-bit, they were 8-bit before version 2.13 -----//
+
+static void visit_region_id(FileWriterVisitor *v, uint16_t *regionId)
+{
+	visit<uint16_t>(v, regionId);
+}
+
+static void visit_region_id(FileReaderVisitor *v, uint16_t *regionId)
+{
+	if( GameFile::load_file_game_version >= 213 )
+		visit<uint16_t>(v, regionId);
+	else
+		visit<uint8_t>(v, regionId);
+}
+
+//*****//
+
 template <typename Visitor>
 static void visit_firm(Visitor *v, Firm *f)
 {
@@ -831,7 +850,7 @@ static void visit_firm(Visitor *v, Firm *f)
 	visit<int16_t>(v, &f->abs_y2);
 	visit<int16_t>(v, &f->center_x);
 	visit<int16_t>(v, &f->center_y);
-	visit<uint8_t>(v, &f->region_id);
+	visit_region_id(v, &f->region_id);
 	visit<int8_t>(v, &f->cur_frame);
 	visit<int8_t>(v, &f->remain_frame_delay);
 	visit<float>(v, &f->hit_points);
@@ -841,7 +860,7 @@ static void visit_firm(Visitor *v, Firm *f)
 	visit<int16_t>(v, &f->overseer_recno);
 	visit<int16_t>(v, &f->overseer_town_recno);
 	visit<int16_t>(v, &f->builder_recno);
-	visit<uint8_t>(v, &f->builder_region_id);
+	visit_region_id(v, &f->builder_region_id);
 	visit<float>(v, &f->productivity);
 	visit_pointer(v, &f->worker_array);
 	visit<int8_t>(v, &f->worker_count);
@@ -869,11 +888,12 @@ static void visit_firm(Visitor *v, Firm *f)
 	visit<int8_t>(v, &f->ai_should_build_factory_count);
 }
 
-enum { FIRM_RECORD_SIZE = 254 };
+enum { FIRM_RECORD_SIZE = 256, VERSION_212_FIRM_RECORD_SIZE = 254 };
 
 static bool read_firm(File *file, Firm *firm)
 {
-	return read_with_record_size(file, firm, &visit_firm<FileReaderVisitor>, FIRM_RECORD_SIZE);
+	return read_with_record_size(file, firm, &visit_firm<FileReaderVisitor>,
+										  GameFile::load_file_game_version >= 213 ? FIRM_RECORD_SIZE : VERSION_212_FIRM_RECORD_SIZE);
 }
 
 static bool write_firm(File *file, Firm *firm)
@@ -1070,6 +1090,23 @@ int Firm::read_derived_file(File* filePtr)
 //----------- End of function Firm::read_derived_file ---------//
 
 
+//--------- Begin of function FirmHarbor::read_derived_file ---------//
+//
+// The region ids of the harbor were 8-bit before version 2.13.
+//
+int FirmHarbor::read_derived_file(File* filePtr)
+{
+	char* derivedPtr = (char*) this + sizeof(Firm);
+
+	int regionIdOffsetArray[] = { (int) ((char*) &land_region_id - derivedPtr),
+											(int) ((char*) &sea_region_id - derivedPtr) };
+
+	return GameFile::read_region_id_record( filePtr, derivedPtr, 1, sizeof(FirmHarbor)-sizeof(Firm),
+														 regionIdOffsetArray, 2 );
+}
+//----------- End of function FirmHarbor::read_derived_file ---------//
+
+
 //*****//
 
 
@@ -1098,7 +1135,21 @@ int SiteArray::read_file(File* filePtr)
 	gold_coin_count	 =	filePtr->file_get_short();
 	std_raw_site_count =	filePtr->file_get_short();
 
-	return DynArrayB::read_file( filePtr );
+	if( !DynArrayB::read_file( filePtr ) )
+		return 0;
+
+	//--- the sites of games saved before version 2.13 have 8-bit region ids ---//
+
+	if( GameFile::load_file_game_version < 213 && ele_size != sizeof(Site) )
+	{
+		int regionIdOffset = (int) offsetof(Site, region_id);
+
+		body_buf = mem_resize( body_buf, ele_num * sizeof(Site) );
+		GameFile::widen_region_id( body_buf, last_ele, sizeof(Site), &regionIdOffset, 1 );
+		ele_size = sizeof(Site);
+	}
+
+	return 1;
 }
 //--------- End of function SiteArray::read_file ---------------//
 
@@ -1199,8 +1250,13 @@ int TownArray::read_file(File* filePtr)
 			}
 			else
 			{
-				if( !filePtr->file_read( townPtr, sizeof(Town) - Town::SIZEOF_NONSAVED_ELEMENTS ) )
+				int regionIdOffset = (int) ((char*) &townPtr->region_id - (char*) townPtr);
+
+				if( !GameFile::read_region_id_record( filePtr, townPtr, 1, sizeof(Town) - Town::SIZEOF_NONSAVED_ELEMENTS,
+																  &regionIdOffset, 1 ) )
+				{
 					return 0;
+				}
 			}
 
 			#ifdef DEBUG
@@ -1498,7 +1554,7 @@ static void visit_attack_camp(Visitor *v, AttackCamp *ac)
 template <typename Visitor>
 static void visit_ai_region(Visitor *v, AIRegion *reg)
 {
-	visit<int8_t>(v, &reg->region_id);
+	visit_region_id(v, &reg->region_id);
 	visit<int8_t>(v, &reg->town_count);
 	visit<int8_t>(v, &reg->base_town_count);
 }
@@ -1900,7 +1956,7 @@ static void visit_nation(Visitor *v, Nation *nat)
 	visit<int16_t>(v, &nat->lead_attack_camp_recno);
 }
 
-enum { NATION_RECORD_SIZE = 2202 };
+enum { NATION_RECORD_SIZE = 2222, VERSION_212_NATION_RECORD_SIZE = 2202 };
 
 //--------- Begin of function Nation::write_file ---------//
 //
@@ -1949,7 +2005,8 @@ static void write_ai_info(File* filePtr, short* aiInfoArray, short aiInfoCount,
 
 static bool read_nation(File *file, Nation *nat)
 {
-	if (!read_with_record_size(file, nat, &visit_nation<FileReaderVisitor>, NATION_RECORD_SIZE))
+	if (!read_with_record_size(file, nat, &visit_nation<FileReaderVisitor>,
+										GameFile::load_file_game_version >= 213 ? NATION_RECORD_SIZE : VERSION_212_NATION_RECORD_SIZE))
 		return false;
 
 	memset(&nat->action_array, 0, sizeof(nat->action_array));
@@ -2249,10 +2306,19 @@ static void visit_region_array(Visitor *v, RegionArray *ra)
 	visit_pointer(v, &ra->region_stat_array);
 	visit<int32_t>(v, &ra->region_stat_count);
 	visit_pointer(v, &ra->connect_bits);
-	visit_array<uint8_t>(v, ra->region_sorted_array, MAX_REGION);
 }
 
-enum { REGION_ARRAY_RECORD_SIZE = 279 };
+enum { REGION_ARRAY_RECORD_SIZE = 24 };
+
+//--- before version 2.13, the record had region_sorted_array of 255 8-bit region ids ---//
+
+static void visit_version_212_region_array(FileReaderVisitor *v, RegionArray *ra)
+{
+	visit_region_array(v, ra);
+	v->skip(255);
+}
+
+enum { VERSION_212_REGION_ARRAY_RECORD_SIZE = 279 };
 
 //-------- Start of function RegionArray::write_file -------------//
 //
@@ -2274,7 +2340,7 @@ int RegionArray::write_file(File* filePtr)
 
 	//--------- write connection bits ----------//
 
-	int connectBit = (region_info_count -1) * (region_info_count) /2;
+	int connectBit = connect_bit_count(region_info_count);
 	int connectByte = (connectBit +7) /8;
 
 	if( connectByte > 0)
@@ -2292,17 +2358,43 @@ int RegionArray::write_file(File* filePtr)
 //
 int RegionArray::read_file(File* filePtr)
 {
-	if (!read_with_record_size(filePtr, this, &visit_region_array<FileReaderVisitor>,
-										REGION_ARRAY_RECORD_SIZE))
-		return 0;
+	if( GameFile::load_file_game_version >= 213 )
+	{
+		if (!read_with_record_size(filePtr, this, &visit_region_array<FileReaderVisitor>,
+											REGION_ARRAY_RECORD_SIZE))
+			return 0;
+	}
+	else
+	{
+		if (!read_with_record_size(filePtr, this, &visit_version_212_region_array,
+											VERSION_212_REGION_ARRAY_RECORD_SIZE))
+			return 0;
+	}
 
    if( region_info_count > 0 )
       region_info_array = (RegionInfo *) mem_add(sizeof(RegionInfo)*region_info_count);
    else
       region_info_array = NULL;
 
-   if( !filePtr->file_read( region_info_array, sizeof(RegionInfo)*region_info_count))
-      return 0;
+	int infoRegionIdOffsetArray[] = { (int) offsetof(RegionInfo, region_id), (int) offsetof(RegionInfo, region_stat_id) };
+
+	if( !GameFile::read_region_id_record( filePtr, region_info_array, region_info_count, sizeof(RegionInfo),
+													  infoRegionIdOffsetArray, 2 ) )
+	{
+		return 0;
+	}
+
+	//---- region_sorted_array is not saved, sort the regions again ----//
+
+	if( region_info_count > 0 )
+	{
+		region_sorted_array = (uint16_t *) mem_add(sizeof(uint16_t)*region_info_count);
+		sort_region();
+	}
+	else
+	{
+		region_sorted_array = NULL;
+	}
 
 	//-------- read RegionStat ----------//
 
@@ -2310,12 +2402,29 @@ int RegionArray::read_file(File* filePtr)
 
 	region_stat_array = (RegionStat*) mem_add( region_stat_count * sizeof(RegionStat) );
 
-	if( !filePtr->file_read( region_stat_array, sizeof(RegionStat)*region_stat_count ) )
+	//--- the region id. and the ids. in each RegionPath ---//
+
+	int statRegionIdOffsetArray[1+MAX_REACHABLE_REGION_PER_STAT*2];
+
+	statRegionIdOffsetArray[0] = (int) offsetof(RegionStat, region_id);
+
+	for( int i=0 ; i<MAX_REACHABLE_REGION_PER_STAT ; i++ )
+	{
+		int pathOffset = (int) (offsetof(RegionStat, reachable_region_array) + sizeof(RegionPath) * i);
+
+		statRegionIdOffsetArray[1+i*2] = pathOffset + (int) offsetof(RegionPath, sea_region_id);
+		statRegionIdOffsetArray[2+i*2] = pathOffset + (int) offsetof(RegionPath, land_region_stat_id);
+	}
+
+	if( !GameFile::read_region_id_record( filePtr, region_stat_array, region_stat_count, sizeof(RegionStat),
+													  statRegionIdOffsetArray, 1+MAX_REACHABLE_REGION_PER_STAT*2 ) )
+	{
 		return 0;
+	}
 
 	//--------- read connection bits ----------//
 
-	int connectBit = (region_info_count -1) * (region_info_count) /2;
+	int connectBit = connect_bit_count(region_info_count);
 	int connectByte = (connectBit +7) /8;
 
 	if( connectByte > 0)
@@ -2329,6 +2438,12 @@ int RegionArray::read_file(File* filePtr)
 		connect_bits = NULL;
 	}
 
+	//------ rebuild the sea path table -------//
+
+	sea_path_matrix = NULL;
+
+	init_region_path();
+
 	return 1;
 }
 //--------- End of function RegionArray::read_file ---------------//
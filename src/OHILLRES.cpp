@@ -256,11 +256,20 @@ short HillRes::scan(char patternId, char searchPriority, char specialFlag, char
 //
 // Draw the current hill on the map
 //
-void HillBlockInfo::draw(int xLoc, int yLoc, int layerMask)
+// <int> clipY1, clipY2 - only draw on these rows of the zoom area,
+//                        -1 for all rows (default: -1)
+//
+void HillBlockInfo::draw(int xLoc, int yLoc, int layerMask, int clipY1, int clipY2)
 {
 	if(!(layerMask & layer))
 		return;
 
+	if( clipY1 < 0 )
+	{
+		clipY1 = 0;
+		clipY2 = ZOOM_HEIGHT-1;
+	}
+
 	//----------- calculate absolute positions ------------//
 
 	int absX1   = xLoc*ZOOM_LOC_WIDTH + offset_x;
@@ -275,26 +284,34 @@ void HillBlockInfo::draw(int xLoc, int yLoc, int layerMask)
 
 	int y1 = absY1 - World::view_top_y;
 
-	if( y1 <= -bitmap_height() || y1 >= ZOOM_HEIGHT )
+	if( y1 <= clipY1-bitmap_height() || y1 > clipY2 )
 		return;
 
-	if( bitmap_type == 'W')
-	{
-		vga_back.put_bitmap_32x32(x1+ZOOM_X1,y1+ZOOM_Y1, bitmap_ptr);
-		return;
-	}
-
 	//------- decide which approach to use for displaying -----//
 
 	int x2 = absX1 + bitmap_width() - 1 - World::view_top_x;
 	int y2 = absY1 + bitmap_height()- 1 - World::view_top_y;
 
+	if( bitmap_type == 'W')
+	{
+		if( y1 < clipY1 || y2 > clipY2 )
+		{
+			vga_back.put_bitmap_area( x1+ZOOM_X1, y1+ZOOM_Y1, bitmap_ptr,
+				0, MAX(clipY1,y1)-y1, bitmap_width()-1, MIN(clipY2,y2)-y1 );
+		}
+		else
+		{
+			vga_back.put_bitmap_32x32(x1+ZOOM_X1,y1+ZOOM_Y1, bitmap_ptr);
+		}
+		return;
+	}
+
 	//---- only portion of the sprite is inside the view area ------//
 
-	if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < 0 || y2 >= ZOOM_HEIGHT )
+	if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < clipY1 || y2 > clipY2 )
 	{
 		vga_back.put_bitmap_area_trans_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, bitmap_ptr,
-			MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1 );
+			MAX(0,x1)-x1, MAX(clipY1,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(clipY2,y2)-y1 );
 	}
 
 	//---- the whole sprite is inside the view area ------//
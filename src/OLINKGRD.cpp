@@ -0,0 +1,333 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+//Filename    : OLINKGRD.CPP
+//Description : Object LinkGrid, coarse grid of firms and towns for link setup
+
+#include <string.h>
+#include <ALL.h>
+#include <OWORLD.h>
+#include <OFIRM.h>
+#include <OFIRMA.h>
+#include <OTOWN.h>
+#include <OLINKGRD.h>
+
+//-------- Begin of function LinkGrid::LinkGrid --------//
+
+LinkGrid::LinkGrid()
+{
+	memset( this, 0, sizeof(LinkGrid) );
+}
+//--------- End of function LinkGrid::LinkGrid ---------//
+
+
+//-------- Begin of function LinkGrid::~LinkGrid --------//
+
+LinkGrid::~LinkGrid()
+{
+	deinit();
+}
+//--------- End of function LinkGrid::~LinkGrid ---------//
+
+
+//-------- Begin of function LinkGrid::init --------//
+//
+// Called by World::assign_map() when a map is generated or loaded. The
+// firms and towns may not have been loaded yet, so the lists are only
+// rebuilt when they are next used.
+//
+void LinkGrid::init()
+{
+	deinit();
+
+	cell_x_count = (MAX_WORLD_X_LOC + (1<<LINK_GRID_CELL_SHIFT) - 1) >> LINK_GRID_CELL_SHIFT;
+	cell_y_count = (MAX_WORLD_Y_LOC + (1<<LINK_GRID_CELL_SHIFT) - 1) >> LINK_GRID_CELL_SHIFT;
+
+	int cellCount = cell_x_count * cell_y_count;
+
+	cell_first_firm_array = (short*) mem_add( sizeof(short) * cellCount );
+	cell_first_town_array = (short*) mem_add( sizeof(short) * cellCount );
+
+	rebuild_flag = 1;
+}
+//--------- End of function LinkGrid::init ---------//
+
+
+//-------- Begin of function LinkGrid::deinit --------//
+
+void LinkGrid::deinit()
+{
+	if( cell_first_firm_array )
+	{
+		mem_del( cell_first_firm_array );
+		mem_del( cell_first_town_array );
+
+		cell_first_firm_array = NULL;
+		cell_first_town_array = NULL;
+	}
+
+	if( next_firm_array )
+	{
+		mem_del( next_firm_array );
+		next_firm_array = NULL;
+		next_firm_array_size = 0;
+	}
+
+	if( next_town_array )
+	{
+		mem_del( next_town_array );
+		next_town_array = NULL;
+		next_town_array_size = 0;
+	}
+
+	if( near_recno_array )
+	{
+		mem_del( near_recno_array );
+		near_recno_array = NULL;
+		near_recno_array_size = 0;
+	}
+}
+//--------- End of function LinkGrid::deinit ---------//
+
+
+//-------- Begin of function LinkGrid::rebuild --------//
+//
+// Put all firms and towns in the lists of their cells again.
+//
+void LinkGrid::rebuild()
+{
+	int cellCount = cell_x_count * cell_y_count;
+
+	memset( cell_first_firm_array, 0, sizeof(short) * cellCount );
+	memset( cell_first_town_array, 0, sizeof(short) * cellCount );
+
+	rebuild_flag = 0;
+
+	int i;
+
+	for( i=firm_array.size() ; i>0 ; i-- )
+	{
+		if( !firm_array.is_deleted(i) )
+			add_firm( firm_array[i] );
+	}
+
+	for( i=town_array.size() ; i>0 ; i-- )
+	{
+		if( !town_array.is_deleted(i) )
+			add_town( town_array[i] );
+	}
+}
+//--------- End of function LinkGrid::rebuild ---------//
+
+
+//-------- Begin of function LinkGrid::add_firm --------//
+//
+// Called by Firm::init() before it sets up its links.
+//
+void LinkGrid::add_firm(Firm* firmPtr)
+{
+	if( cell_first_firm_array && !rebuild_flag )
+	{
+		add_recno( cell_first_firm_array, next_firm_array, next_firm_array_size,
+					  firmPtr->center_x, firmPtr->center_y, firmPtr->firm_recno );
+	}
+}
+//--------- End of function LinkGrid::add_firm ---------//
+
+
+//-------- Begin of function LinkGrid::del_firm --------//
+//
+// Called by Firm::deinit().
+//
+void LinkGrid::del_firm(Firm* firmPtr)
+{
+	if( cell_first_firm_array && !rebuild_flag )
+	{
+		del_recno( cell_first_firm_array, next_firm_array, next_firm_array_size,
+					  firmPtr->center_x, firmPtr->center_y, firmPtr->firm_recno );
+	}
+}
+//--------- End of function LinkGrid::del_firm ---------//
+
+
+//-------- Begin of function LinkGrid::add_town --------//
+//
+// Called by Town::init() before it sets up its links.
+//
+void LinkGrid::add_town(Town* townPtr)
+{
+	if( cell_first_town_array && !rebuild_flag )
+	{
+		add_recno( cell_first_town_array, next_town_array, next_town_array_size,
+					  townPtr->center_x, townPtr->center_y, townPtr->town_recno );
+	}
+}
+//--------- End of function LinkGrid::add_town ---------//
+
+
+//-------- Begin of function LinkGrid::del_town --------//
+//
+// Called by Town::deinit().
+//
+void LinkGrid::del_town(Town* townPtr)
+{
+	if( cell_first_town_array && !rebuild_flag )
+	{
+		del_recno( cell_first_town_array, next_town_array, next_town_array_size,
+					  townPtr->center_x, townPtr->center_y, townPtr->town_recno );
+	}
+}
+//--------- End of function LinkGrid::del_town ---------//
+
+
+//-------- Begin of function LinkGrid::add_recno --------//
+
+void LinkGrid::add_recno(short* firstArray, short*& nextArray, int& nextArraySize, int xLoc, int yLoc, int recno)
+{
+	if( recno >= nextArraySize )
+	{
+		nextArraySize = MAX(recno+1, nextArraySize*2);
+		nextArray = (short*) mem_resize( nextArray, sizeof(short) * nextArraySize );
+	}
+
+	int cellId = get_cell(xLoc, yLoc);
+
+	nextArray[recno]   = firstArray[cellId];
+	firstArray[cellId] = recno;
+}
+//--------- End of function LinkGrid::add_recno ---------//
+
+
+//-------- Begin of function LinkGrid::del_recno --------//
+
+void LinkGrid::del_recno(short* firstArray, short* nextArray, int nextArraySize, int xLoc, int yLoc, int recno)
+{
+	short* linkPtr = firstArray + get_cell(xLoc, yLoc);
+
+	while( *linkPtr && *linkPtr != recno )
+		linkPtr = nextArray + *linkPtr;
+
+	if( *linkPtr && recno < nextArraySize )
+		*linkPtr = nextArray[recno];
+	else
+		rebuild_flag = 1;			// the lists are out of step with the firms and towns
+}
+//--------- End of function LinkGrid::del_recno ---------//
+
+
+//-------- Begin of function LinkGrid::near_firm --------//
+//
+// Find the firms whose centers may be within the given distance of the
+// given location. The area is rounded up to whole cells, so the caller
+// still has to check the distance of each firm.
+//
+// return : <int> the no. of firms found, their recnos are in
+//                near_recno_array[] in descending order, the order in
+//                which setup_link() has always scanned firm_array
+//
+int LinkGrid::near_firm(int xLoc, int yLoc, int locDistance)
+{
+	if( !cell_first_firm_array )
+		return all_recno( firm_array.size() );
+
+	if( rebuild_flag )
+		rebuild();
+
+	return near_recno( cell_first_firm_array, next_firm_array, xLoc, yLoc, locDistance );
+}
+//--------- End of function LinkGrid::near_firm ---------//
+
+
+//-------- Begin of function LinkGrid::near_town --------//
+//
+// Find the towns whose centers may be within the given distance of the
+// given location, as in near_firm().
+//
+int LinkGrid::near_town(int xLoc, int yLoc, int locDistance)
+{
+	if( !cell_first_town_array )
+		return all_recno( town_array.size() );
+
+	if( rebuild_flag )
+		rebuild();
+
+	return near_recno( cell_first_town_array, next_town_array, xLoc, yLoc, locDistance );
+}
+//--------- End of function LinkGrid::near_town ---------//
+
+
+//-------- Begin of function LinkGrid::near_recno --------//
+
+int LinkGrid::near_recno(short* firstArray, short* nextArray, int xLoc, int yLoc, int locDistance)
+{
+	int cellX1 = MAX(xLoc-locDistance, 0) >> LINK_GRID_CELL_SHIFT;
+	int cellY1 = MAX(yLoc-locDistance, 0) >> LINK_GRID_CELL_SHIFT;
+	int cellX2 = MIN(xLoc+locDistance, MAX_WORLD_X_LOC-1) >> LINK_GRID_CELL_SHIFT;
+	int cellY2 = MIN(yLoc+locDistance, MAX_WORLD_Y_LOC-1) >> LINK_GRID_CELL_SHIFT;
+
+	int nearCount=0, recno, i;
+
+	for( int cellY=cellY1 ; cellY<=cellY2 ; cellY++ )
+	{
+		for( int cellX=cellX1 ; cellX<=cellX2 ; cellX++ )
+		{
+			for( recno=firstArray[cellY*cell_x_count+cellX] ; recno ; recno=nextArray[recno] )
+			{
+				if( nearCount == near_recno_array_size )
+				{
+					near_recno_array_size = MAX(32, near_recno_array_size*2);
+					near_recno_array = (short*) mem_resize( near_recno_array, sizeof(short) * near_recno_array_size );
+				}
+
+				//---- insert it in descending order of recno ----//
+
+				for( i=nearCount ; i>0 && near_recno_array[i-1] < recno ; i-- )
+					near_recno_array[i] = near_recno_array[i-1];
+
+				near_recno_array[i] = recno;
+				nearCount++;
+			}
+		}
+	}
+
+	return nearCount;
+}
+//--------- End of function LinkGrid::near_recno ---------//
+
+
+//-------- Begin of function LinkGrid::all_recno --------//
+//
+// Return all recnos from recnoCount down to 1, when there is no grid.
+//
+int LinkGrid::all_recno(int recnoCount)
+{
+	if( recnoCount > near_recno_array_size )
+	{
+		near_recno_array_size = recnoCount;
+		near_recno_array = (short*) mem_resize( near_recno_array, sizeof(short) * near_recno_array_size );
+	}
+
+	for( int i=0 ; i<recnoCount ; i++ )
+		near_recno_array[i] = recnoCount-i;
+
+	return recnoCount;
+}
+//--------- End of function LinkGrid::all_recno ---------//
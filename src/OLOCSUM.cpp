@@ -0,0 +1,220 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OLOCSUM.CPP
+//Description : Object LocSum, counts of blocked locations in rectangles
+
+#include <string.h>
+#include <ALL.h>
+#include <OWORLD.h>
+#include <OLOCSUM.h>
+
+//------- the walk bits checked by each type, and the bits a free location has ------//
+
+static uint8_t check_bits_array[LOC_SUM_TYPE_COUNT] =
+{
+	WALK_MATRIX_LAND | WALK_MATRIX_CARGO,
+	WALK_MATRIX_LAND | WALK_MATRIX_CARGO | WALK_MATRIX_POWER_OFF | WALK_MATRIX_SITE,
+	WALK_MATRIX_LAND | WALK_MATRIX_CARGO | WALK_MATRIX_BLOCK | WALK_MATRIX_POWER_OFF,
+	WALK_MATRIX_LAND | WALK_MATRIX_CARGO | WALK_MATRIX_BLOCK | WALK_MATRIX_POWER_OFF | WALK_MATRIX_SITE,
+};
+
+static uint8_t need_bits_array[LOC_SUM_TYPE_COUNT] =
+{
+	WALK_MATRIX_LAND,
+	WALK_MATRIX_LAND,
+	WALK_MATRIX_LAND,
+	WALK_MATRIX_LAND,
+};
+
+//-------- Begin of function LocSum::LocSum --------//
+
+LocSum::LocSum()
+{
+	memset( this, 0, sizeof(LocSum) );
+}
+//--------- End of function LocSum::LocSum ---------//
+
+
+//-------- Begin of function LocSum::~LocSum --------//
+
+LocSum::~LocSum()
+{
+	deinit();
+}
+//--------- End of function LocSum::~LocSum ---------//
+
+
+//-------- Begin of function LocSum::init --------//
+//
+// Build the trees from the walk bits of all locations.
+//
+// <uint8_t*> walkMatrix     - World::walk_matrix
+// <int>      xCount, yCount - the size of the map
+//
+void LocSum::init(uint8_t* walkMatrix, int xCount, int yCount)
+{
+	deinit();
+
+	x_count = xCount;
+	y_count = yCount;
+
+	int rowSize = x_count+1;
+	int x, y, i;
+
+	for( int sumType=0 ; sumType<LOC_SUM_TYPE_COUNT ; sumType++ )
+	{
+		int32_t* treePtr = (int32_t*) mem_add( sizeof(int32_t) * rowSize * (y_count+1) );
+
+		memset( treePtr, 0, sizeof(int32_t) * rowSize * (y_count+1) );
+
+		//------- put the count of each location in the tree -------//
+
+		uint8_t* walkBits = walkMatrix;
+
+		for( y=1 ; y<=y_count ; y++ )
+		{
+			for( x=1 ; x<=x_count ; x++, walkBits++ )
+				treePtr[y*rowSize+x] = is_blocked(sumType, *walkBits);
+		}
+
+		//---- add each node to its parent, along x, then along y ----//
+
+		for( y=1 ; y<=y_count ; y++ )
+		{
+			for( x=1 ; x<=x_count ; x++ )
+			{
+				if( (i = x + (x & -x)) <= x_count )
+					treePtr[y*rowSize+i] += treePtr[y*rowSize+x];
+			}
+		}
+
+		for( y=1 ; y<=y_count ; y++ )
+		{
+			if( (i = y + (y & -y)) > y_count )
+				continue;
+
+			for( x=1 ; x<=x_count ; x++ )
+				treePtr[i*rowSize+x] += treePtr[y*rowSize+x];
+		}
+
+		tree_array[sumType] = treePtr;
+	}
+}
+//--------- End of function LocSum::init ---------//
+
+
+//-------- Begin of function LocSum::deinit --------//
+
+void LocSum::deinit()
+{
+	for( int sumType=0 ; sumType<LOC_SUM_TYPE_COUNT ; sumType++ )
+	{
+		if( tree_array[sumType] )
+		{
+			mem_del( tree_array[sumType] );
+			tree_array[sumType] = NULL;
+		}
+	}
+}
+//--------- End of function LocSum::deinit ---------//
+
+
+//-------- Begin of function LocSum::is_blocked --------//
+
+int LocSum::is_blocked(int sumType, uint8_t walkBits)
+{
+	return (walkBits & check_bits_array[sumType]) != need_bits_array[sumType];
+}
+//--------- End of function LocSum::is_blocked ---------//
+
+
+//-------- Begin of function LocSum::change_walk_bits --------//
+//
+// Called by World::update_walk_matrix() when the walk bits of a location
+// have changed.
+//
+void LocSum::change_walk_bits(int xLoc, int yLoc, uint8_t oldBits, uint8_t newBits)
+{
+	for( int sumType=0 ; sumType<LOC_SUM_TYPE_COUNT ; sumType++ )
+	{
+		if( !tree_array[sumType] )
+			continue;
+
+		int addCount = is_blocked(sumType, newBits) - is_blocked(sumType, oldBits);
+
+		if( addCount )
+			add( tree_array[sumType], xLoc, yLoc, addCount );
+	}
+}
+//--------- End of function LocSum::change_walk_bits ---------//
+
+
+//-------- Begin of function LocSum::count --------//
+//
+// return : <int> the no. of blocked locations of the given type in the
+//                rectangle, both corners included
+//
+int LocSum::count(int sumType, int xLoc1, int yLoc1, int xLoc2, int yLoc2)
+{
+	int32_t* treePtr = tree_array[sumType];
+
+	err_when( !treePtr );
+	err_when( xLoc1<0 || yLoc1<0 || xLoc2>=x_count || yLoc2>=y_count );
+
+	return prefix_sum(treePtr, xLoc2, yLoc2) - prefix_sum(treePtr, xLoc1-1, yLoc2)
+			 - prefix_sum(treePtr, xLoc2, yLoc1-1) + prefix_sum(treePtr, xLoc1-1, yLoc1-1);
+}
+//--------- End of function LocSum::count ---------//
+
+
+//-------- Begin of function LocSum::add --------//
+
+void LocSum::add(int32_t* treePtr, int xLoc, int yLoc, int addCount)
+{
+	int rowSize = x_count+1;
+
+	for( int y=yLoc+1 ; y<=y_count ; y += y & -y )
+	{
+		for( int x=xLoc+1 ; x<=x_count ; x += x & -x )
+			treePtr[y*rowSize+x] += addCount;
+	}
+}
+//--------- End of function LocSum::add ---------//
+
+
+//-------- Begin of function LocSum::prefix_sum --------//
+//
+// return : <int> the no. of blocked locations from (0,0) to (xLoc,yLoc)
+//
+int LocSum::prefix_sum(int32_t* treePtr, int xLoc, int yLoc)
+{
+	int rowSize = x_count+1;
+	int sum = 0;
+
+	for( int y=yLoc+1 ; y>0 ; y -= y & -y )
+	{
+		for( int x=xLoc+1 ; x>0 ; x -= x & -x )
+			sum += treePtr[y*rowSize+x];
+	}
+
+	return sum;
+}
+//--------- End of function LocSum::prefix_sum ---------//
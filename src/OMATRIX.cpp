@@ -33,6 +33,9 @@
 #include <OUNIT.h>
 #include <OWORLD.h>
 #include <OHILLRES.h>
+#include <OSPHPA.h>
+#include <OSPFLOW.h>
+#include <OSPCACHE.h>
 
 // --------- define constant ----------//
 #define DEFAULT_WALL_TIMEOUT 10
@@ -422,11 +425,35 @@ void Location::walkable_reset()
 		{
 			loc_flag |= LOCATE_WALK_LAND;
 		}
+
+		walkable_changed();
 	}
 }
 // ----------- End of function Location::walkable_reset -------//
 
 
+// ------- Begin of function Location::walkable_changed -----/
+//
+// Let the cluster layer of path seeking, the flow fields and the path
+// cache know that the walkability of this location has changed.
+//
+void Location::walkable_changed()
+{
+	world.update_walk_matrix(this);
+
+	Location* locMatrix = world.loc_matrix;
+
+	if( locMatrix && this >= locMatrix && this < locMatrix + MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC )
+	{
+		int locIndex = int(this - locMatrix);
+		seek_path_hpa.invalidate_loc( locIndex % MAX_WORLD_X_LOC, locIndex / MAX_WORLD_X_LOC );
+		flow_field.invalidate_loc( locIndex % MAX_WORLD_X_LOC, locIndex / MAX_WORLD_X_LOC );
+		seek_path_cache.invalidate_loc( locIndex % MAX_WORLD_X_LOC, locIndex / MAX_WORLD_X_LOC );
+	}
+}
+// ----------- End of function Location::walkable_changed -------//
+
+
 // ----------- Begin of function Location::is_plateau ---------//
 int Location::is_plateau()
 {
@@ -445,6 +472,8 @@ void Location::set_site(int siteRecno)
 	// loc_flag |= LOCATION_HAS_SITE;
 
 	extra_para = siteRecno;
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::set_site ------------//
 
@@ -458,6 +487,8 @@ void Location::remove_site()
 	loc_flag &= ~LOCATE_SITE_MASK;
 
 	extra_para  = 0;
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::remove_site ------------//
 
@@ -534,6 +565,9 @@ void Location::set_firm(int firmRecno)
 	loc_flag = (loc_flag & ~LOCATE_BLOCK_MASK) | LOCATE_IS_FIRM;
 
 	cargo_recno = firmRecno;
+
+	world.update_walk_matrix(this);
+	unit_grid.set_firm_loc(this, 1);
 }
 //------------ End of function Location::set_firm ------------//
 
@@ -544,6 +578,8 @@ void Location::remove_firm()
 {
 	err_when( !is_firm() );
 
+	unit_grid.set_firm_loc(this, -1);
+
 	loc_flag &= ~LOCATE_BLOCK_MASK;
 	cargo_recno = 0;
 	walkable_reset();
@@ -563,6 +599,8 @@ void Location::set_town(int townRecno)
 	loc_flag = loc_flag & ~LOCATE_BLOCK_MASK | LOCATE_IS_TOWN;
 
 	cargo_recno = townRecno;
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::set_town ------------//
 
@@ -618,6 +656,8 @@ void Location::set_hill(int hillId)
 		cargo_recno = hillId;
 		extra_para = 0;
 	}
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::set_hill ------------//
 
@@ -633,6 +673,8 @@ void Location::remove_hill()
 	cargo_recno = 0;
 	// err_when(is_firm());
 	// BUGHERE : need to call walkable_reset();
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::remove_hill ------------//
 
@@ -653,6 +695,8 @@ void Location::set_wall(int wallId, int townRecno, int hitPoints)
 
 	extra_para  = wallId;
 	cargo_recno = (hitPoints<<8) + townRecno;
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::set_wall ------------//
 
@@ -788,6 +832,9 @@ void Location::set_plant(int plantId, int offsetX, int offsetY)
 	extra_para  = plantId;
 	cargo_recno = (offsetY<<8) + offsetX;
 	err_when(cargo_recno==0 || is_firm());
+
+	world.update_walk_matrix(this);
+	world.update_plant_loc(this, 1);
 }
 //------------ End of function Location::set_plant ------------//
 
@@ -798,6 +845,8 @@ void Location::remove_plant()
 {
 	err_when( !is_plant() );
 
+	world.update_plant_loc(this, 0);
+
 	loc_flag &= ~(LOCATE_BLOCK_MASK | LOCATE_SITE_MASK);
 	extra_para  = 0;
 	cargo_recno = 0;
@@ -817,6 +866,8 @@ void Location::set_rock(short rockArrayRecno)
 	loc_flag = loc_flag & ~LOCATE_BLOCK_MASK | LOCATE_IS_ROCK;
 
 	cargo_recno = rockArrayRecno;
+
+	world.update_walk_matrix(this);
 }
 //------------ End of function Location::set_rock ------------//
 
@@ -834,6 +885,50 @@ void Location::remove_rock()
 //------------ End of function Location::remove_rock ------------//
 
 
+//---------- Begin of function Location::set_fire_str ------------//
+//
+// The functions changing the fire level and the flammability let
+// World::update_fire_loc() keep the set of locations spread_fire()
+// processes up to date.
+//
+void Location::set_fire_str(char str)
+{
+	fire_level = str;
+	world.update_fire_loc(this);
+}
+//------------ End of function Location::set_fire_str ------------//
+
+
+//---------- Begin of function Location::set_fire_src ------------//
+//
+void Location::set_fire_src(char src)
+{
+	flammability = src;
+	world.update_fire_loc(this);
+}
+//------------ End of function Location::set_fire_src ------------//
+
+
+//---------- Begin of function Location::add_fire_str ------------//
+//
+void Location::add_fire_str(char str)
+{
+	fire_level += str;
+	world.update_fire_loc(this);
+}
+//------------ End of function Location::add_fire_str ------------//
+
+
+//---------- Begin of function Location::add_fire_src ------------//
+//
+void Location::add_fire_src(char src)
+{
+	flammability += src;
+	world.update_fire_loc(this);
+}
+//------------ End of function Location::add_fire_src ------------//
+
+
 //-------- Begin of function Location::has_unit --------//
 // return 0 or unit recno
 int Location::has_unit(int mobileType)
@@ -950,6 +1045,8 @@ int Location::is_unit_group_accessible(int mobileType, uint32_t curGroupId)
 void Location::set_power_on()
 {
 	loc_flag &= ~LOCATE_POWER_OFF;
+
+	world.update_walk_matrix(this);
 }
 //-------- End of function Location::set_power_on --------//
 
@@ -958,6 +1055,8 @@ void Location::set_power_on()
 void Location::set_power_off()
 {
 	loc_flag |= LOCATE_POWER_OFF;
+
+	world.update_walk_matrix(this);
 }
 //-------- End of function Location::set_power_off --------//
 
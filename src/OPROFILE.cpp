@@ -0,0 +1,377 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OPROFILE.CPP
+//Description : Hierarchical frame profiler
+
+#include <string.h>
+#include <SDL.h>
+#include <ALL.h>
+#include <OSYS.h>
+#include <OPROFILE.h>
+
+//-------- Begin of function Profiler::Profiler --------//
+
+Profiler::Profiler()
+{
+	memset( this, 0, sizeof(Profiler) );
+}
+//--------- End of function Profiler::Profiler ---------//
+
+
+//-------- Begin of function Profiler::~Profiler --------//
+
+Profiler::~Profiler()
+{
+	deinit();
+}
+//--------- End of function Profiler::~Profiler ---------//
+
+
+//-------- Begin of function Profiler::init --------//
+//
+// Allocate the event buffer and start profiling. Call it between frames
+// only, so that no scope is open when profiling starts.
+//
+void Profiler::init()
+{
+	if( !event_array )
+		event_array = (ProfileEvent*) mem_add( sizeof(ProfileEvent) * MAX_PROFILE_EVENT );
+
+	reset();
+
+	enable_flag = 1;
+}
+//--------- End of function Profiler::init ---------//
+
+
+//-------- Begin of function Profiler::deinit --------//
+
+void Profiler::deinit()
+{
+	enable_flag = 0;
+
+	if( event_array )
+	{
+		mem_del(event_array);
+		event_array = NULL;
+	}
+}
+//--------- End of function Profiler::deinit ---------//
+
+
+//-------- Begin of function Profiler::reset --------//
+//
+// Clear the timer tree and the event buffer. Scope names are kept as
+// their ids are cached at the call sites.
+//
+void Profiler::reset()
+{
+	memset( node_array, 0, sizeof(node_array) );
+
+	node_array[0].name_id = -1;			// node 0 is the root
+	node_array[0].parent_id = -1;
+	node_array[0].first_child_id = -1;
+	node_array[0].next_sibling_id = -1;
+	node_count = 1;
+
+	counter_count = 0;
+
+	cur_node_id = 0;
+	cur_depth = 0;
+	skip_depth = 0;
+	event_count = 0;
+
+	base_time = get_counter();
+}
+//--------- End of function Profiler::reset ---------//
+
+
+//-------- Begin of function Profiler::add_name --------//
+//
+// Register a scope name and return its id. Scopes with the same name
+// share the same id.
+//
+int Profiler::add_name(const char* name)
+{
+	for( int i=0 ; i<name_count ; i++ )
+	{
+		if( !strcmp(name_array[i], name) )
+			return i;
+	}
+
+	err_when( name_count >= MAX_PROFILE_NAME );
+
+	if( name_count >= MAX_PROFILE_NAME )
+		return MAX_PROFILE_NAME-1;
+
+	name_array[name_count] = name;
+	return name_count++;
+}
+//--------- End of function Profiler::add_name ---------//
+
+
+//-------- Begin of function Profiler::get_child --------//
+//
+// Return the child node of the given parent for the given scope name,
+// create it if it doesn't exist yet.
+//
+// return : <int> the node id, -1 if the node array is full
+//
+int Profiler::get_child(int parentId, int nameId)
+{
+	int nodeId, lastChildId=-1;
+
+	for( nodeId=node_array[parentId].first_child_id ; nodeId>0 ; nodeId=node_array[nodeId].next_sibling_id )
+	{
+		if( node_array[nodeId].name_id == nameId )
+			return nodeId;
+
+		lastChildId = nodeId;
+	}
+
+	if( node_count >= MAX_PROFILE_NODE )
+		return -1;
+
+	nodeId = node_count++;
+
+	ProfileNode* nodePtr = node_array+nodeId;
+
+	nodePtr->name_id = nameId;
+	nodePtr->parent_id = parentId;
+	nodePtr->first_child_id = -1;
+	nodePtr->next_sibling_id = -1;
+	nodePtr->call_count = 0;
+	nodePtr->total_time = 0;
+
+	//--- append it to the end of the child list, so nodes are listed in the order they are first reached ---//
+
+	if( lastChildId > 0 )
+		node_array[lastChildId].next_sibling_id = nodeId;
+	else
+		node_array[parentId].first_child_id = nodeId;
+
+	return nodeId;
+}
+//--------- End of function Profiler::get_child ---------//
+
+
+//-------- Begin of function Profiler::begin --------//
+
+void Profiler::begin(int nameId)
+{
+	int nodeId = -1;
+
+	if( !skip_depth && cur_depth < MAX_PROFILE_DEPTH )
+		nodeId = get_child(cur_node_id, nameId);
+
+	if( nodeId < 0 )
+	{
+		skip_depth++;
+		return;
+	}
+
+	cur_node_id = nodeId;
+	start_time_array[cur_depth++] = get_counter();
+}
+//--------- End of function Profiler::begin ---------//
+
+
+//-------- Begin of function Profiler::end --------//
+
+void Profiler::end()
+{
+	if( skip_depth )
+	{
+		skip_depth--;
+		return;
+	}
+
+	if( cur_depth==0 )
+		return;
+
+	uint64_t endTime   = get_counter();
+	uint64_t startTime = start_time_array[--cur_depth];
+
+	ProfileNode* nodePtr = node_array+cur_node_id;
+
+	nodePtr->call_count++;
+	nodePtr->total_time += endTime - startTime;
+
+	//------- add the event to the ring buffer --------//
+
+	ProfileEvent* eventPtr = event_array + (event_count & (MAX_PROFILE_EVENT-1));
+
+	eventPtr->node_id     = cur_node_id;
+	eventPtr->depth       = cur_depth;
+	eventPtr->frame_count = sys.frame_count;
+	eventPtr->start_time  = startTime;
+	eventPtr->end_time    = endTime;
+
+	event_count++;
+
+	cur_node_id = nodePtr->parent_id;
+}
+//--------- End of function Profiler::end ---------//
+
+
+//-------- Begin of function Profiler::add_count --------//
+
+void Profiler::add_count(int nameId, int addCount)
+{
+	int i;
+
+	for( i=0 ; i<counter_count ; i++ )
+	{
+		if( counter_array[i].name_id == nameId )
+			break;
+	}
+
+	if( i==counter_count )
+	{
+		if( counter_count >= MAX_PROFILE_COUNTER )
+			return;
+
+		counter_array[i].name_id = nameId;
+		counter_array[i].total = 0;
+		counter_count++;
+	}
+
+	counter_array[i].total += addCount;
+}
+//--------- End of function Profiler::add_count ---------//
+
+
+//-------- Begin of function Profiler::dump_trace --------//
+//
+// Write the events in the ring buffer to a file in the Chrome trace
+// event format, which can be viewed in chrome://tracing.
+//
+// return : <int> 1 - the file is written
+//                0 - the file cannot be created
+//
+int Profiler::dump_trace(const char* filePath)
+{
+	FILE* filePtr = fopen(filePath, "w");
+
+	if( !filePtr )
+		return 0;
+
+	double usPerTick = 1000000.0 / get_frequency();
+
+	uint32_t firstEvent = event_count > MAX_PROFILE_EVENT ? event_count-MAX_PROFILE_EVENT : 0;
+
+	fprintf( filePtr, "{\"traceEvents\":[\n" );
+
+	for( uint32_t i=firstEvent ; i<event_count ; i++ )
+	{
+		ProfileEvent* eventPtr = event_array + (i & (MAX_PROFILE_EVENT-1));
+
+		fprintf( filePtr, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+			i>firstEvent ? ",\n" : "",
+			name_array[node_array[eventPtr->node_id].name_id],
+			(eventPtr->start_time - base_time) * usPerTick,
+			(eventPtr->end_time - eventPtr->start_time) * usPerTick,
+			eventPtr->frame_count );
+	}
+
+	fprintf( filePtr, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+	fclose(filePtr);
+
+	return 1;
+}
+//--------- End of function Profiler::dump_trace ---------//
+
+
+//-------- Begin of function Profiler::print_tree --------//
+//
+// Print the accumulated time of every node in the timer tree, followed
+// by the counters.
+//
+// <FILE*> filePtr    - the file to print to
+// <int>   frameCount - no. of frames the times were accumulated over
+//
+void Profiler::print_tree(FILE* filePtr, int frameCount)
+{
+	double freq = (double) get_frequency();
+	uint64_t rootTime = 0;
+
+	for( int nodeId=node_array[0].first_child_id ; nodeId>0 ; nodeId=node_array[nodeId].next_sibling_id )
+		rootTime += node_array[nodeId].total_time;
+
+	fprintf( filePtr, "%-40s %10s %12s %12s %7s\n", "Section", "Calls", "Total ms", "Avg us/frame", "%" );
+
+	for( int nodeId=node_array[0].first_child_id ; nodeId>0 ; nodeId=node_array[nodeId].next_sibling_id )
+		print_node(filePtr, nodeId, 0, frameCount, rootTime, freq);
+
+	//------------ print the counters -------------//
+
+	if( counter_count )
+	{
+		fprintf( filePtr, "\n%-40s %10s %12s\n", "Counter", "Total", "Avg/frame" );
+
+		for( int i=0 ; i<counter_count ; i++ )
+		{
+			fprintf( filePtr, "%-40s %10llu %12.2f\n", name_array[counter_array[i].name_id],
+				(unsigned long long) counter_array[i].total,
+				frameCount ? (double) counter_array[i].total / frameCount : 0.0 );
+		}
+	}
+}
+//--------- End of function Profiler::print_tree ---------//
+
+
+//-------- Begin of function Profiler::print_node --------//
+
+void Profiler::print_node(FILE* filePtr, int nodeId, int depth, int frameCount, uint64_t rootTime, double freq)
+{
+	ProfileNode* nodePtr = node_array+nodeId;
+	char nameStr[41];
+
+	snprintf( nameStr, sizeof(nameStr), "%*s%s", depth*2, "", name_array[nodePtr->name_id] );
+
+	double totalMs = nodePtr->total_time * 1000.0 / freq;
+
+	fprintf( filePtr, "%-40s %10u %12.2f %12.2f %6.1f%%\n", nameStr, nodePtr->call_count, totalMs,
+		frameCount ? totalMs * 1000.0 / frameCount : 0.0,
+		rootTime ? nodePtr->total_time * 100.0 / rootTime : 0.0 );
+
+	for( int childId=nodePtr->first_child_id ; childId>0 ; childId=node_array[childId].next_sibling_id )
+		print_node(filePtr, childId, depth+1, frameCount, rootTime, freq);
+}
+//--------- End of function Profiler::print_node ---------//
+
+
+//-------- Begin of function Profiler::get_counter --------//
+
+uint64_t Profiler::get_counter()
+{
+	return SDL_GetPerformanceCounter();
+}
+//--------- End of function Profiler::get_counter ---------//
+
+
+//-------- Begin of function Profiler::get_frequency --------//
+
+uint64_t Profiler::get_frequency()
+{
+	return SDL_GetPerformanceFrequency();
+}
+//--------- End of function Profiler::get_frequency ---------//
@@ -60,8 +60,10 @@ void RegionArray::init(int maxRegion)
 		region_info_array = (RegionInfo *)mem_add( sizeof(RegionInfo) * maxRegion);
 		memset(region_info_array, 0, sizeof(RegionInfo) * maxRegion );
 
+		region_sorted_array = (uint16_t *)mem_add( sizeof(uint16_t) * maxRegion );
+
 		// ---- calculate the no. of bit required to store connection ----//
-		connectBit = (maxRegion-1) * (maxRegion) /2;
+		connectBit = connect_bit_count(maxRegion);
 		// region 1 needs 0 bit
 		// region 2 needs 1 bit
 		// region 3 needs 2 bits
@@ -70,6 +72,7 @@ void RegionArray::init(int maxRegion)
 	else
 	{
 		region_info_array = NULL;
+		region_sorted_array = NULL;
 		connectBit = 0;
 	}
 
@@ -83,6 +86,9 @@ void RegionArray::init(int maxRegion)
 		connect_bits = NULL;
 	}
 
+	region_stat_array = NULL;
+	sea_path_matrix	= NULL;
+
 	//------ initialize adj_offset_bit and area -------//
 
 	int j = 0;
@@ -112,10 +118,14 @@ void RegionArray::deinit()
 	{
 		if(region_info_array)
 			mem_del( region_info_array );
+		if(region_sorted_array)
+			mem_del( region_sorted_array );
 		if(region_stat_array)
 			mem_del( region_stat_array );
 		if(connect_bits)
 			mem_del( connect_bits );
+		if(sea_path_matrix)
+			mem_del( sea_path_matrix );
 
 		init_flag = 0;
 	}
@@ -123,6 +133,22 @@ void RegionArray::deinit()
 // --------- End of function RegionArray::deinit -------//
 
 
+// --------- Begin of function RegionArray::connect_bit_count -------//
+//
+// Return the no. of bits needed to store whether each two of the given
+// no. of regions are adjacent. It is calculated in 64-bit, as the product
+// overflows an int when there are close to MAX_REGION regions.
+//
+int RegionArray::connect_bit_count(int regionCount)
+{
+	if( regionCount <= 0 )
+		return 0;
+
+	return (int) ( (int64_t) (regionCount-1) * regionCount / 2 );
+}
+// --------- End of function RegionArray::connect_bit_count -------//
+
+
 //--------- Begin of function RegionArray::next_day -------//
 
 void RegionArray::next_day()
@@ -217,7 +243,7 @@ void RegionArray::sort_region()
 //
 static int sort_region_function( const void *a, const void *b )
 {
-	return region_array[*((uint8_t*)b)]->region_size - region_array[*((uint8_t*)a)]->region_size;
+	return region_array[*((uint16_t*)b)]->region_size - region_array[*((uint16_t*)a)]->region_size;
 }
 //------- End of function sort_region_function ------//
 
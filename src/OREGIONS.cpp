@@ -76,7 +76,7 @@ void RegionArray::init_region_stat()
 		err_when( regionStatId<1 || regionStatId>region_stat_count );
 
 		region_stat_array[regionStatId-1].region_id = regionInfo->region_id;
-		regionInfo->region_stat_id	= static_cast<uint8_t>(regionStatId);
+		regionInfo->region_stat_id	= static_cast<uint16_t>(regionStatId);
 
 		if( ++regionStatId > region_stat_count )
 			break;
@@ -87,6 +87,8 @@ void RegionArray::init_region_stat()
 	for( i=0 ; i<region_stat_count ; i++ )
 		region_stat_array[i].init();
 
+	init_region_path();
+
 	update_region_stat();
 }
 //--------- End of function RegionArray::init_region_stat -------//
@@ -102,6 +104,24 @@ void RegionArray::update_region_stat()
 //--------- End of function RegionArray::update_region_stat -------//
 
 
+//--------- Begin of function RegionArray::update_region_stat -------//
+//
+// Update the statistics of one region only, when a change is known
+// not to affect the others.
+//
+// <int> regionId - id. of the region, regions too small to have
+//                  statistics are ignored
+//
+void RegionArray::update_region_stat(int regionId)
+{
+	int regionStatId = region_info_array[regionId-1].region_stat_id;
+
+	if( regionStatId )
+		region_stat_array[regionStatId-1].update_stat();
+}
+//--------- End of function RegionArray::update_region_stat -------//
+
+
 //--------- Begin of function RegionStat::init -------//
 
 void RegionStat::init()
@@ -292,24 +312,60 @@ void RegionStat::update_stat()
 //--------- End of function RegionStat::update_stat -------//
 
 
-//--------- Begin of function RegionArray::get_sea_path_region_id -------//
+//--------- Begin of function RegionArray::init_region_path -------//
 //
-// Return the region id. of the sea path between the two given regions.
+// Build sea_path_matrix from the reachable regions of each RegionStat.
+// Called after the map is generated and after a game is loaded, as the
+// table is derived from the saved RegionStat.
 //
-int RegionArray::get_sea_path_region_id(int regionId1, int regionId2)
+void RegionArray::init_region_path()
 {
-	RegionStat* regionStat = region_array.get_region_stat(regionId1);
-	int			regionStatId2 = region_array[regionId2]->region_stat_id;
+	if( sea_path_matrix )
+		mem_del( sea_path_matrix );
+
+	if( region_stat_count <= 0 )
+	{
+		sea_path_matrix = NULL;
+		return;
+	}
+
+	int matrixSize = region_stat_count * region_stat_count;
 
-	RegionPath* regionPath = regionStat->reachable_region_array;
+	sea_path_matrix = (uint16_t*) mem_add( matrixSize * sizeof(uint16_t) );
 
-	for( int i=0 ; i<regionStat->reachable_region_count ; i++, regionPath++ )
+	memset( sea_path_matrix, 0, matrixSize * sizeof(uint16_t) );
+
+	//--- the first path in reachable_region_array is the one used, as when it was scanned ---//
+
+	for( int i=0 ; i<region_stat_count ; i++ )
 	{
-		if( regionPath->land_region_stat_id == regionStatId2 )
-			return regionPath->sea_region_id;
+		RegionStat* regionStat = region_stat_array+i;
+		uint16_t*	seaPathRow = sea_path_matrix + i*region_stat_count;
+
+		for( int j=regionStat->reachable_region_count-1 ; j>=0 ; j-- )
+		{
+			RegionPath* regionPath = regionStat->reachable_region_array+j;
+
+			seaPathRow[regionPath->land_region_stat_id-1] = regionPath->sea_region_id;
+		}
 	}
+}
+//--------- End of function RegionArray::init_region_path -------//
 
-	return 0;
+
+//--------- Begin of function RegionArray::get_sea_path_region_id -------//
+//
+// Return the region id. of the sea path between the two given regions.
+//
+int RegionArray::get_sea_path_region_id(int regionId1, int regionId2)
+{
+	int regionStatId1 = region_info_array[regionId1-1].region_stat_id;
+	int regionStatId2 = region_info_array[regionId2-1].region_stat_id;
+
+	if( !regionStatId1 || !regionStatId2 )
+		return 0;
+
+	return sea_path_matrix[(regionStatId1-1)*region_stat_count + regionStatId2-1];
 }
 //--------- End of function RegionArray::get_sea_path_region_id -------//
 
@@ -77,9 +77,9 @@ void Rock::draw()
 	rock_res.draw(rock_recno, loc_x, loc_y, cur_frame);
 }
 
-void Rock::draw_block(short xLoc, short yLoc)
+void Rock::draw_block(short xLoc, short yLoc, int clipY1, int clipY2)
 {
-	rock_res.draw_block(rock_recno, xLoc, yLoc, xLoc-loc_x, yLoc-loc_y, cur_frame);
+	rock_res.draw_block(rock_recno, xLoc, yLoc, xLoc-loc_x, yLoc-loc_y, cur_frame, clipY1, clipY2);
 }
 
 RockArray::RockArray(int initArraySize) : DynArrayB(sizeof(Rock),initArraySize, DEFAULT_REUSE_INTERVAL_DAYS)
@@ -481,8 +481,9 @@ void RockRes::draw(short rockRecno, short xLoc, short yLoc, char curFrame)
 // <short> offsetX, offsetY  which cell of a rock
 // <short> xLoc,yLoc         where the rock is drawn
 // <char> curFrame           frame no.
+// <int> clipY1, clipY2      only draw on these rows of the zoom area, -1 for all rows (default: -1)
 void RockRes::draw_block(short rockRecno, short xLoc, short yLoc, 
-	short offsetX, short offsetY, char curFrame)
+	short offsetX, short offsetY, char curFrame, int clipY1, int clipY2)
 {
 	RockInfo *rockInfo = rock_res.get_rock_info(rockRecno);
 	short rockBlockRecno, rockBitmapRecno;
@@ -493,7 +494,7 @@ void RockRes::draw_block(short rockRecno, short xLoc, short yLoc,
 	if( (rockBlockRecno = locate_block(rockRecno, offsetX, offsetY)) != 0 
 		&& (rockBitmapRecno = get_bitmap_recno(rockBlockRecno, curFrame)) != 0 )
 	{
-		get_bitmap_info(rockBitmapRecno)->draw(xLoc, yLoc);
+		get_bitmap_info(rockBitmapRecno)->draw(xLoc, yLoc, clipY1, clipY2);
 	}
 }
 // ------------ end of function RockRes::draw_block -----------//
@@ -642,8 +643,18 @@ short RockRes::get_anim_recno(short rockRecno, char curFrame)
 
 
 // ------------ begin of function RockBitmapInfo::draw ---------//
-void RockBitmapInfo::draw(short xLoc, short yLoc)
+//
+// <int> clipY1, clipY2 - only draw on these rows of the zoom area,
+//                        -1 for all rows (default: -1)
+//
+void RockBitmapInfo::draw(short xLoc, short yLoc, int clipY1, int clipY2)
 {
+	if( clipY1 < 0 )
+	{
+		clipY1 = 0;
+		clipY2 = ZOOM_HEIGHT-1;
+	}
+
 	//-------- check if the firm is within the view area --------//
 
 	int x1 = xLoc * ZOOM_LOC_WIDTH - World::view_top_x;
@@ -653,17 +664,17 @@ void RockBitmapInfo::draw(short xLoc, short yLoc)
 
 	int y1 = yLoc * ZOOM_LOC_HEIGHT - World::view_top_y;
 	int y2 = y1 + height() -1;
-	if( y1 >= ZOOM_HEIGHT || y2 < 0)
+	if( y1 > clipY2 || y2 < clipY1)
 		return;
 
 	//---- only portion of the sprite is inside the view area ------//
 
-	if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < 0 || y2 >= ZOOM_HEIGHT )
+	if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < clipY1 || y2 > clipY2 )
 	{
 		int srcX1 = x1<0 ? -x1 : 0;
-		int srcY1 = y1<0 ? -y1 : 0;
+		int srcY1 = y1<clipY1 ? clipY1-y1 : 0;
 		int srcX2 = (x2>=ZOOM_WIDTH ? ZOOM_WIDTH-1-x1 : width()-1);
-		int srcY2 = (y2>=ZOOM_HEIGHT ? ZOOM_HEIGHT-1-y1 : height()-1);
+		int srcY2 = (y2>clipY2 ? clipY2-y1 : height()-1);
 
 		// ########## begin Gilbert 7/4 ###########//
 		vga_back.put_bitmap_area_trans( x1+ZOOM_X1, y1+ZOOM_Y1,
@@ -223,9 +223,9 @@ void SiteArray::generate_raw_site(int rawGenCount)
 	//----- count the no. of existing raw sites in each ragion ------//
 
 	int   regionId;
-	char	regionRawCountArray[MAX_REGION];
+	char*	regionRawCountArray = (char*) mem_add( region_array.region_info_count );
 
-	memset( regionRawCountArray, 0, sizeof(regionRawCountArray) );
+	memset( regionRawCountArray, 0, region_array.region_info_count );
 
 	for( i=size() ; i>0 ; i-- )
 	{
@@ -273,11 +273,16 @@ void SiteArray::generate_raw_site(int rawGenCount)
 				if( create_raw_site(regionInfo->region_id) )
 				{
 					if( ++existRawSiteCount == std_raw_site_count )
+					{
+						mem_del( regionRawCountArray );
 						return;
+					}
 				}
 			}
 		}
 	}
+
+	mem_del( regionRawCountArray );
 }
 //--------- End of function SiteArray::generate_raw_site ----------//
 
@@ -177,6 +177,7 @@ void SiteArray::draw_dot()
 	// ###### begin Gilbert 7/7 #######//
 	int		vgaBufPitch = vga_back.buf_pitch();
 	// ###### end Gilbert 7/7 #######//
+	int		locScale = MAP_LOC_SCALE;
 
 	for(i=1; i <=size() ; i++)
 	{
@@ -185,8 +186,8 @@ void SiteArray::draw_dot()
 
 		rawPtr = operator[](i);
 
-		mapX = MAP_X1 + rawPtr->map_x_loc;
-		mapY = MAP_Y1 + rawPtr->map_y_loc;
+		mapX = MAP_X1 + rawPtr->map_x_loc/locScale;
+		mapY = MAP_Y1 + rawPtr->map_y_loc/locScale;
 
 		if( mapX == MAP_WIDTH-1 )
 			mapX = MAP_WIDTH-2;
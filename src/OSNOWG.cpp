@@ -162,17 +162,17 @@ void SnowGroundArray::process()
 // ------ Begin of function SnowGroundArray::has_snow -------//
 int SnowGroundArray::has_snow(short x, short y)
 {
-	seed = (snow_pattern << 16) + (x+y+257)*(5*x+y+1);
-	(void) rand_seed();
-	long height = (rand_seed() & 0xffff) - (0xffff - snow_thick);
+	unsigned randSeed = (snow_pattern << 16) + (x+y+257)*(5*x+y+1);
+	(void) rand_seed(randSeed);
+	long height = (rand_seed(randSeed) & 0xffff) - (0xffff - snow_thick);
 	if( height <= 0)
 		return 0;
 
 	int snowGrade = height / SNOW_GRADE_FACTOR;
-	SnowInfo *snowInfo = snow_res[snow_res.rand_root(rand_seed()/4)];
+	SnowInfo *snowInfo = snow_res[snow_res.rand_root(rand_seed(randSeed)/4)];
 	for( ; snowGrade > 0; --snowGrade)
 	{
-		snowInfo = snowInfo->rand_next_ptr(rand_seed()/4);
+		snowInfo = snowInfo->rand_next_ptr(rand_seed(randSeed)/4);
 	}
 	return snowInfo->snow_map_id;
 }
@@ -180,11 +180,11 @@ int SnowGroundArray::has_snow(short x, short y)
 
 
 // ------ Begin of function SnowGroundArray::random -------//
-unsigned SnowGroundArray::rand_seed()
+unsigned SnowGroundArray::rand_seed(unsigned& randSeed)
 {
    #define MULTIPLIER      0x015a4e35L
    #define INCREMENT       1
-   seed = MULTIPLIER * seed + INCREMENT;
-	return seed;
+   randSeed = MULTIPLIER * randSeed + INCREMENT;
+	return randSeed;
 }
 // ------ End of function SnowGroundArray::random -------//
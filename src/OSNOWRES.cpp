@@ -36,8 +36,18 @@
 
 
 // ------- Begin of function SnowInfo::draw_at ------//
-void SnowInfo::draw_at(short absX, short absY)
+//
+// <int> clipY1, clipY2 - only draw on these rows of the zoom area,
+//                        -1 for all rows (default: -1)
+//
+void SnowInfo::draw_at(short absX, short absY, int clipY1, int clipY2)
 {
+	if( clipY1 < 0 )
+	{
+		clipY1 = 0;
+		clipY2 = ZOOM_HEIGHT-1;
+	}
+
 	//----------- calculate absolute positions ------------//
 
 	int absX1   = absX + offset_x;
@@ -56,7 +66,7 @@ void SnowInfo::draw_at(short absX, short absY)
 		return;
 
 	int y1 = absY1 - World::view_top_y;
-	if( y1 <= -bitmapHeight || y1 >= ZOOM_HEIGHT )
+	if( y1 <= clipY1-bitmapHeight || y1 > clipY2 )
 		return;
 
 	//------- decide which approach to use for displaying -----//
@@ -65,11 +75,11 @@ void SnowInfo::draw_at(short absX, short absY)
 	int y2 = absY2 - World::view_top_y;
 
 	//---- only portion of the sprite is inside the view area ------//
-	if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < 0 || y2 >= ZOOM_HEIGHT )
+	if( x1 < 0 || x2 >= ZOOM_WIDTH || y1 < clipY1 || y2 > clipY2 )
 	{
 		// no put_bitmap_area_remap
 		vga_back.put_bitmap_area_trans_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, bitmap_ptr,
-			MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1);
+			MAX(0,x1)-x1, MAX(clipY1,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(clipY2,y2)-y1);
 	}
 	else
 	//---- the whole sprite is inside the view area ------//
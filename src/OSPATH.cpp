@@ -32,6 +32,7 @@
 #include <OUNIT.h>
 #include <OSYS.h>
 #include <ONATION.h>
+#include <OPROFILE.h>
 
 #ifdef NO_DEBUG_SEARCH
 #undef err_when
@@ -61,7 +62,7 @@ static char	  	   mobile_type;
 static char			seek_nation_recno;
 static int			attack_range;	// used in search_mode = SEARCH_MODE_ATTACK_UNIT_BY_RANGE
 static short		target_recno;	// used in search_mode = SEARCH_MODE_TO_ATTACK or SEARCH_MODE_TO_VEHICLE, get from miscNo
-static uint8_t		region_id;		// used in search_mode = SEARCH_MODE_TO_LAND_FOR_SHIP
+static uint16_t	region_id;		// used in search_mode = SEARCH_MODE_TO_LAND_FOR_SHIP
 static short		building_id;	// used in search_mode = SEARCH_MODE_TO_FIRM or SEARCH_MODE_TO_TOWN, get from miscNo
 //======================================================================//
 // 1) if search_mode = SEARCH_MODE_TO_FIRM or SEARCH_MODE_TO_TOWN
@@ -83,17 +84,118 @@ static short		final_dest_y;	// i.e. the value used finally may not be the real d
 static SeekPath* 	cur_seek_path;
 static short  		cur_dest_x, cur_dest_y;
 static short* 		cur_node_matrix;
+static uint16_t*	cur_node_stamp_matrix;
+static uint16_t	cur_node_stamp;
+static short*		cur_base_node_matrix;	// the path-reuse node matrix in SEARCH_MODE_REUSE, entries not set in the current search are read from it
 static Node*  		cur_node_array;
 static short 		cur_border_x1, cur_border_y1, cur_border_x2, cur_border_y2;
 
 static char			nation_passable[MAX_NATION+1] = {0}; // Note: position 0 is not used for faster access
 static char			search_sub_mode;
 
+//----------- Define struct SeekRequest -----------//
+//
+// The parameters of a resumable seek() call. A suspended search is only
+// resumed by a later call with exactly the same parameters.
+//
+struct SeekRequest
+{
+	short		owner_recno;		// sprite recno of the unit, 0 if the current search is not resumable
+	short		sour_x, sour_y;
+	short		dest_x, dest_y;
+	uint32_t	group_id;
+	short		search_mode;
+	short		misc_no;
+	short		num_of_path;
+	char		nation_recno;
+	char		sub_mode;
+	int		attack_range;
+	char		nation_passable[MAX_NATION+1];
+};
+
+//----------- Define struct SuspendedSearch -----------//
+//
+// A land search which has used up its node budget of the frame before
+// reaching the destination. It carries on from its open and closed lists
+// when the same unit makes the same request in a later frame, instead of
+// searching again from scratch.
+//
+struct SuspendedSearch
+{
+	SeekRequest	request;
+	uint32_t		last_frame;			// the frame in which the search was suspended
+
+	//------- SeekPath member vars --------//
+	short		real_sour_x, real_sour_y;
+	short		real_dest_x, real_dest_y;
+	short		dest_x, dest_y;
+	char		is_dest_blocked;
+	short		border_x1, border_y1, border_x2, border_y2;
+	int		node_count;
+
+	Node*		node_array;				// swapped with those of SeekPath instead of copied, as the nodes point to each other
+	short*	node_matrix;
+	uint16_t* node_stamp_matrix;
+	uint16_t	node_stamp;
+
+	NodePriorityQueue	open_node_list;
+	NodePriorityQueue	closed_node_list;
+
+	//-------- static search vars ---------//
+	short		target_recno;
+	short		building_id;
+	int		building_x1, building_y1, building_x2, building_y2;
+	FirmInfo	*search_firm_info;
+	short		final_dest_x, final_dest_y;
+};
+
+static SeekRequest		cur_request;
+static SuspendedSearch*	suspended_search_array;	// MAX_SUSPENDED_SEARCH entries
+
 //----------- Define static functions -----------//
 
 static void  stack_push(Node *nodePtr);
 static Node* stack_pop();
 
+//------- Begin of static function get_node_recno -------//
+//
+// Return the recno of the node at the given index of the node matrix,
+// 0 if no node has been created there in the current search.
+//
+inline static short get_node_recno(int matrixIndex)
+{
+	if( cur_node_stamp_matrix[matrixIndex] == cur_node_stamp )
+		return cur_node_matrix[matrixIndex];
+
+	return cur_base_node_matrix ? cur_base_node_matrix[matrixIndex] : 0;
+}
+//-------- End of static function get_node_recno --------//
+
+
+//------- Begin of static function set_node_recno -------//
+
+inline static void set_node_recno(int matrixIndex, short nodeRecno)
+{
+	cur_node_matrix[matrixIndex] = nodeRecno;
+	cur_node_stamp_matrix[matrixIndex] = cur_node_stamp;
+}
+//-------- End of static function set_node_recno --------//
+
+
+//------- Begin of static function update_node_heap -------//
+//
+// Restore the order of the open or closed list after node_f of a node
+// in it has been reduced.
+//
+inline static void update_node_heap(Node* nodePtr)
+{
+	if( nodePtr->closed_flag )
+		SeekPath::closed_node_list.decrease_key(nodePtr);
+	else
+		SeekPath::open_node_list.decrease_key(nodePtr);
+}
+//-------- End of static function update_node_heap --------//
+
 //-***************************************************************************-//
 //-*************************** for debuging **********************************-//
 //-***************************************************************************-//
@@ -470,14 +572,33 @@ inline short SeekPath::result_node_distance(ResultNode *node1, ResultNode *node2
 void SeekPath::init(int maxNode)
 {
 	max_node = maxNode;
-	node_array = (Node*) mem_add( max_node * sizeof(Node) );
+	node_array = (Node*) mem_add( MAX(max_node, MAX_RESUMABLE_SEARCH_NODE) * sizeof(Node) );		// a resumed search can use more nodes than max_node
 	node_matrix = (short*) mem_add(sizeof(short)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+	node_stamp_matrix = (uint16_t*) mem_add(sizeof(uint16_t)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+	memset(node_stamp_matrix, 0, sizeof(uint16_t)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+	node_stamp = 0;
 
 	path_status = PATH_WAIT;
 	open_node_list.reset_priority_queue();
 	closed_node_list.reset_priority_queue();
 
 	reset_total_node_avail();
+
+	//------ allocate the buffers of suspended searches -------//
+
+	if( !suspended_search_array )
+	{
+		suspended_search_array = (SuspendedSearch*) mem_add( MAX_SUSPENDED_SEARCH * sizeof(SuspendedSearch) );
+		memset( suspended_search_array, 0, MAX_SUSPENDED_SEARCH * sizeof(SuspendedSearch) );
+
+		for( int i=0 ; i<MAX_SUSPENDED_SEARCH ; i++ )
+		{
+			suspended_search_array[i].node_array = (Node*) mem_add( MAX_RESUMABLE_SEARCH_NODE * sizeof(Node) );
+			suspended_search_array[i].node_matrix = (short*) mem_add(sizeof(short)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+			suspended_search_array[i].node_stamp_matrix = (uint16_t*) mem_add(sizeof(uint16_t)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+			memset(suspended_search_array[i].node_stamp_matrix, 0, sizeof(uint16_t)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+		}
+	}
 }
 //--------- End of function SeekPath::init ---------//
 
@@ -496,6 +617,25 @@ void SeekPath::deinit()
 		mem_del(node_matrix);
 		node_matrix = NULL;
 	}
+
+	if( node_stamp_matrix )
+	{
+		mem_del(node_stamp_matrix);
+		node_stamp_matrix = NULL;
+	}
+
+	if( suspended_search_array )
+	{
+		for( int i=0 ; i<MAX_SUSPENDED_SEARCH ; i++ )
+		{
+			mem_del(suspended_search_array[i].node_array);
+			mem_del(suspended_search_array[i].node_matrix);
+			mem_del(suspended_search_array[i].node_stamp_matrix);
+		}
+
+		mem_del(suspended_search_array);
+		suspended_search_array = NULL;
+	}
 }
 //--------- End of function SeekPath::deinit ---------//
 
@@ -542,6 +682,14 @@ void SeekPath::reset_attack_range_para()
 //--------- End of function SeekPath::reset_attack_range_para ---------//
 
 
+//-------- Begin of function SeekPath::get_attack_range_para ---------//
+int SeekPath::get_attack_range_para()
+{
+	return attack_range;
+}
+//--------- End of function SeekPath::get_attack_range_para ---------//
+
+
 //-------- Begin of function SeekPath::set_nation_recno ---------//
 // store the nation_recno of the unit calling searching
 //
@@ -568,6 +716,552 @@ void SeekPath::set_sub_mode(char subMode)
 //--------- End of function SeekPath::set_sub_mode ---------//
 
 
+//-------- Begin of function SeekPath::is_territory_passable ---------//
+//
+// Whether the current sub mode allows the search to pass the territory
+// of the given location.
+//
+int SeekPath::is_territory_passable(int xLoc, int yLoc)
+{
+	char powerNationRecno = world.get_loc(xLoc, yLoc)->power_nation_recno;
+
+	return search_sub_mode!=SEARCH_SUB_MODE_PASSABLE || !powerNationRecno || nation_passable[powerNationRecno];
+}
+//--------- End of function SeekPath::is_territory_passable ---------//
+
+
+//-------- Begin of function SeekPath::get_sub_mode ---------//
+char SeekPath::get_sub_mode()
+{
+	return search_sub_mode;
+}
+//--------- End of function SeekPath::get_sub_mode ---------//
+
+
+//-------- Begin of function SeekPath::get_nation_passable ---------//
+char* SeekPath::get_nation_passable()
+{
+	return nation_passable;
+}
+//--------- End of function SeekPath::get_nation_passable ---------//
+
+
+//-------- Begin of function SeekPath::clear_suspended_search ---------//
+//
+// Discard all suspended searches. It is called when a game is started,
+// or loaded from a game file of an older version which does not save
+// them.
+//
+void SeekPath::clear_suspended_search()
+{
+	if( !suspended_search_array )
+		return;
+
+	for( int i=0 ; i<MAX_SUSPENDED_SEARCH ; i++ )
+		suspended_search_array[i].request.owner_recno = 0;
+}
+//--------- End of function SeekPath::clear_suspended_search ---------//
+
+
+//------- Begin of static function node_to_recno -------//
+//
+// Return the recno of a node in the node array of a suspended search,
+// 0 for NULL. Nodes are saved by recno as they point to each other.
+//
+inline static short node_to_recno(Node* nodeArray, Node* nodePtr)
+{
+	return nodePtr ? (short)(nodePtr-nodeArray+1) : 0;
+}
+//-------- End of static function node_to_recno --------//
+
+
+//------- Begin of static function recno_to_node -------//
+
+inline static Node* recno_to_node(Node* nodeArray, short nodeRecno)
+{
+	return nodeRecno ? nodeArray+nodeRecno-1 : NULL;
+}
+//-------- End of static function recno_to_node --------//
+
+
+//-------- Begin of function SeekPath::write_suspended_search ---------//
+//
+// Save the suspended searches, so that a loaded game resumes them the
+// same way as the game which was saved. Only the nodes created by each
+// search and the valid entries of its node matrix are saved.
+//
+int SeekPath::write_suspended_search(File* filePtr)
+{
+	SuspendedSearch* searchPtr = suspended_search_array;
+	int i, j, k;
+
+	for( i=0 ; i<MAX_SUSPENDED_SEARCH ; i++, searchPtr++ )
+	{
+		SeekRequest* reqPtr = &searchPtr->request;
+
+		filePtr->file_put_short(reqPtr->owner_recno);
+
+		if( !reqPtr->owner_recno )
+			continue;
+
+		//----------- save the request -----------//
+
+		filePtr->file_put_short(reqPtr->sour_x);
+		filePtr->file_put_short(reqPtr->sour_y);
+		filePtr->file_put_short(reqPtr->dest_x);
+		filePtr->file_put_short(reqPtr->dest_y);
+		filePtr->file_put_long(reqPtr->group_id);
+		filePtr->file_put_short(reqPtr->search_mode);
+		filePtr->file_put_short(reqPtr->misc_no);
+		filePtr->file_put_short(reqPtr->num_of_path);
+		filePtr->file_put_short(reqPtr->nation_recno);
+		filePtr->file_put_short(reqPtr->sub_mode);
+		filePtr->file_put_long(reqPtr->attack_range);
+		filePtr->file_write(reqPtr->nation_passable, sizeof(reqPtr->nation_passable));
+
+		filePtr->file_put_long(searchPtr->last_frame);
+
+		//------- save the vars of the search --------//
+
+		filePtr->file_put_short(searchPtr->real_sour_x);
+		filePtr->file_put_short(searchPtr->real_sour_y);
+		filePtr->file_put_short(searchPtr->real_dest_x);
+		filePtr->file_put_short(searchPtr->real_dest_y);
+		filePtr->file_put_short(searchPtr->dest_x);
+		filePtr->file_put_short(searchPtr->dest_y);
+		filePtr->file_put_short(searchPtr->is_dest_blocked);
+		filePtr->file_put_short(searchPtr->border_x1);
+		filePtr->file_put_short(searchPtr->border_y1);
+		filePtr->file_put_short(searchPtr->border_x2);
+		filePtr->file_put_short(searchPtr->border_y2);
+
+		filePtr->file_put_short(searchPtr->target_recno);
+		filePtr->file_put_short(searchPtr->building_id);
+		filePtr->file_put_long(searchPtr->building_x1);
+		filePtr->file_put_long(searchPtr->building_y1);
+		filePtr->file_put_long(searchPtr->building_x2);
+		filePtr->file_put_long(searchPtr->building_y2);
+		filePtr->file_put_short(searchPtr->search_firm_info ? searchPtr->search_firm_info->firm_id : 0);
+		filePtr->file_put_short(searchPtr->final_dest_x);
+		filePtr->file_put_short(searchPtr->final_dest_y);
+
+		//------------- save the nodes -------------//
+
+		Node* nodeArray = searchPtr->node_array;
+		Node* nodePtr = nodeArray;
+
+		filePtr->file_put_long(searchPtr->node_count);
+
+		for( j=0 ; j<searchPtr->node_count ; j++, nodePtr++ )
+		{
+			filePtr->file_put_short(nodePtr->node_x);
+			filePtr->file_put_short(nodePtr->node_y);
+			filePtr->file_put_long(nodePtr->node_f);
+			filePtr->file_put_long(nodePtr->node_h);
+			filePtr->file_put_short(nodePtr->node_g);
+			filePtr->file_put_short(nodePtr->node_type);
+			filePtr->file_put_short(nodePtr->closed_flag);
+			filePtr->file_put_long(nodePtr->heap_pos);
+			filePtr->file_put_short(nodePtr->enter_direction);
+
+			filePtr->file_put_short(node_to_recno(nodeArray, nodePtr->parent_node));
+
+			for( k=0 ; k<MAX_CHILD_NODE ; k++ )
+				filePtr->file_put_short(node_to_recno(nodeArray, nodePtr->child_node[k]));
+
+			filePtr->file_put_short(node_to_recno(nodeArray, nodePtr->next_node));
+		}
+
+		//------ save the open and closed lists ------//
+
+		filePtr->file_put_long(searchPtr->open_node_list.size);
+
+		for( j=1 ; j<=(int)searchPtr->open_node_list.size ; j++ )
+			filePtr->file_put_short(node_to_recno(nodeArray, searchPtr->open_node_list.elements[j]));
+
+		filePtr->file_put_long(searchPtr->closed_node_list.size);
+
+		for( j=1 ; j<=(int)searchPtr->closed_node_list.size ; j++ )
+			filePtr->file_put_short(node_to_recno(nodeArray, searchPtr->closed_node_list.elements[j]));
+
+		//---- save the valid entries of the node matrix ----//
+
+		const int matrixSize = MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4;
+		int entryCount = 0;
+
+		for( j=0 ; j<matrixSize ; j++ )
+		{
+			if( searchPtr->node_stamp_matrix[j] == searchPtr->node_stamp )
+				entryCount++;
+		}
+
+		filePtr->file_put_long(entryCount);
+
+		for( j=0 ; j<matrixSize ; j++ )
+		{
+			if( searchPtr->node_stamp_matrix[j] == searchPtr->node_stamp )
+			{
+				filePtr->file_put_long(j);
+				filePtr->file_put_short(searchPtr->node_matrix[j]);
+			}
+		}
+	}
+
+	return 1;
+}
+//--------- End of function SeekPath::write_suspended_search ---------//
+
+
+//-------- Begin of function SeekPath::read_suspended_search ---------//
+//
+// Restore the suspended searches saved by write_suspended_search().
+//
+// The stamps of the node matrix of each slot are restarted from 1, only
+// the saved entries are valid.
+//
+int SeekPath::read_suspended_search(File* filePtr)
+{
+	SuspendedSearch* searchPtr = suspended_search_array;
+	int i, j, k;
+
+	for( i=0 ; i<MAX_SUSPENDED_SEARCH ; i++, searchPtr++ )
+	{
+		SeekRequest* reqPtr = &searchPtr->request;
+
+		reqPtr->owner_recno = filePtr->file_get_short();
+
+		if( !reqPtr->owner_recno )
+			continue;
+
+		//----------- read the request -----------//
+
+		reqPtr->sour_x		  = filePtr->file_get_short();
+		reqPtr->sour_y		  = filePtr->file_get_short();
+		reqPtr->dest_x		  = filePtr->file_get_short();
+		reqPtr->dest_y		  = filePtr->file_get_short();
+		reqPtr->group_id	  = (uint32_t) filePtr->file_get_long();
+		reqPtr->search_mode  = filePtr->file_get_short();
+		reqPtr->misc_no	  = filePtr->file_get_short();
+		reqPtr->num_of_path  = filePtr->file_get_short();
+		reqPtr->nation_recno = (char) filePtr->file_get_short();
+		reqPtr->sub_mode	  = (char) filePtr->file_get_short();
+		reqPtr->attack_range = filePtr->file_get_long();
+
+		if( !filePtr->file_read(reqPtr->nation_passable, sizeof(reqPtr->nation_passable)) )
+			return 0;
+
+		searchPtr->last_frame = (uint32_t) filePtr->file_get_long();
+
+		//------- read the vars of the search --------//
+
+		searchPtr->real_sour_x	  = filePtr->file_get_short();
+		searchPtr->real_sour_y	  = filePtr->file_get_short();
+		searchPtr->real_dest_x	  = filePtr->file_get_short();
+		searchPtr->real_dest_y	  = filePtr->file_get_short();
+		searchPtr->dest_x			  = filePtr->file_get_short();
+		searchPtr->dest_y			  = filePtr->file_get_short();
+		searchPtr->is_dest_blocked = (char) filePtr->file_get_short();
+		searchPtr->border_x1		  = filePtr->file_get_short();
+		searchPtr->border_y1		  = filePtr->file_get_short();
+		searchPtr->border_x2		  = filePtr->file_get_short();
+		searchPtr->border_y2		  = filePtr->file_get_short();
+
+		searchPtr->target_recno = filePtr->file_get_short();
+		searchPtr->building_id  = filePtr->file_get_short();
+		searchPtr->building_x1  = filePtr->file_get_long();
+		searchPtr->building_y1  = filePtr->file_get_long();
+		searchPtr->building_x2  = filePtr->file_get_long();
+		searchPtr->building_y2  = filePtr->file_get_long();
+
+		int firmId = filePtr->file_get_short();
+
+		searchPtr->search_firm_info = firmId ? firm_res[firmId] : NULL;
+		searchPtr->final_dest_x = filePtr->file_get_short();
+		searchPtr->final_dest_y = filePtr->file_get_short();
+
+		//------------- read the nodes -------------//
+
+		Node* nodeArray = searchPtr->node_array;
+		Node* nodePtr = nodeArray;
+
+		searchPtr->node_count = filePtr->file_get_long();
+
+		if( searchPtr->node_count < 0 || searchPtr->node_count > MAX_RESUMABLE_SEARCH_NODE )
+			return 0;
+
+		for( j=0 ; j<searchPtr->node_count ; j++, nodePtr++ )
+		{
+			nodePtr->node_x			 = filePtr->file_get_short();
+			nodePtr->node_y			 = filePtr->file_get_short();
+			nodePtr->node_f			 = filePtr->file_get_long();
+			nodePtr->node_h			 = filePtr->file_get_long();
+			nodePtr->node_g			 = filePtr->file_get_short();
+			nodePtr->node_type		 = (char) filePtr->file_get_short();
+			nodePtr->closed_flag		 = (char) filePtr->file_get_short();
+			nodePtr->heap_pos			 = filePtr->file_get_long();
+			nodePtr->enter_direction = (char) filePtr->file_get_short();
+
+			nodePtr->parent_node = recno_to_node(nodeArray, filePtr->file_get_short());
+
+			for( k=0 ; k<MAX_CHILD_NODE ; k++ )
+				nodePtr->child_node[k] = recno_to_node(nodeArray, filePtr->file_get_short());
+
+			nodePtr->next_node = recno_to_node(nodeArray, filePtr->file_get_short());
+		}
+
+		//------ read the open and closed lists ------//
+
+		searchPtr->open_node_list.size = filePtr->file_get_long();
+
+		if( searchPtr->open_node_list.size >= MAX_ARRAY_SIZE )
+			return 0;
+
+		for( j=1 ; j<=(int)searchPtr->open_node_list.size ; j++ )
+			searchPtr->open_node_list.elements[j] = recno_to_node(nodeArray, filePtr->file_get_short());
+
+		searchPtr->closed_node_list.size = filePtr->file_get_long();
+
+		if( searchPtr->closed_node_list.size >= MAX_ARRAY_SIZE )
+			return 0;
+
+		for( j=1 ; j<=(int)searchPtr->closed_node_list.size ; j++ )
+			searchPtr->closed_node_list.elements[j] = recno_to_node(nodeArray, filePtr->file_get_short());
+
+		//---- read the valid entries of the node matrix ----//
+
+		const int matrixSize = MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4;
+
+		memset(searchPtr->node_stamp_matrix, 0, sizeof(uint16_t)*matrixSize);
+		searchPtr->node_stamp = 1;
+
+		int entryCount = filePtr->file_get_long();
+
+		for( j=0 ; j<entryCount ; j++ )
+		{
+			int matrixIndex = filePtr->file_get_long();
+
+			if( matrixIndex < 0 || matrixIndex >= matrixSize )
+				return 0;
+
+			searchPtr->node_matrix[matrixIndex] = filePtr->file_get_short();
+			searchPtr->node_stamp_matrix[matrixIndex] = 1;
+		}
+	}
+
+	return 1;
+}
+//--------- End of function SeekPath::read_suspended_search ---------//
+
+
+//-------- Begin of function SeekPath::suspend_search ---------//
+//
+// Move the state of the current search into a suspended search slot,
+// so that it can be resumed by resume_search() in a later frame.
+//
+// return : <int> 1 - the search has been suspended
+//                0 - there is no free slot
+//
+int SeekPath::suspend_search()
+{
+	SuspendedSearch* searchPtr = NULL;
+	SuspendedSearch* slotPtr;
+	int i;
+
+	//--- use the slot of the same unit first, then a free or expired slot ---//
+
+	for( i=0, slotPtr=suspended_search_array ; i<MAX_SUSPENDED_SEARCH ; i++, slotPtr++ )
+	{
+		if( slotPtr->request.owner_recno == cur_request.owner_recno )
+		{
+			searchPtr = slotPtr;
+			break;
+		}
+
+		if( !searchPtr && ( !slotPtr->request.owner_recno ||
+			 sys.frame_count - slotPtr->last_frame > SUSPENDED_SEARCH_EXPIRY ) )
+		{
+			searchPtr = slotPtr;
+		}
+	}
+
+	if( !searchPtr )
+		return 0;
+
+	searchPtr->request	  = cur_request;
+	searchPtr->last_frame  = sys.frame_count;
+
+	searchPtr->real_sour_x = real_sour_x;
+	searchPtr->real_sour_y = real_sour_y;
+	searchPtr->real_dest_x = real_dest_x;
+	searchPtr->real_dest_y = real_dest_y;
+	searchPtr->dest_x		  = dest_x;
+	searchPtr->dest_y		  = dest_y;
+	searchPtr->is_dest_blocked = is_dest_blocked;
+	searchPtr->border_x1	  = border_x1;
+	searchPtr->border_y1	  = border_y1;
+	searchPtr->border_x2	  = border_x2;
+	searchPtr->border_y2	  = border_y2;
+	searchPtr->node_count  = node_count;
+
+	searchPtr->target_recno = target_recno;
+	searchPtr->building_id  = building_id;
+	searchPtr->building_x1  = building_x1;
+	searchPtr->building_y1  = building_y1;
+	searchPtr->building_x2  = building_x2;
+	searchPtr->building_y2  = building_y2;
+	searchPtr->search_firm_info = search_firm_info;
+	searchPtr->final_dest_x = final_dest_x;
+	searchPtr->final_dest_y = final_dest_y;
+
+	//------ swap the node buffers with the slot ------//
+
+	Node* nodeArray = searchPtr->node_array;
+	searchPtr->node_array = node_array;
+	node_array = nodeArray;
+
+	short* nodeMatrix = searchPtr->node_matrix;
+	searchPtr->node_matrix = node_matrix;
+	node_matrix = nodeMatrix;
+
+	uint16_t* stampMatrix = searchPtr->node_stamp_matrix;
+	searchPtr->node_stamp_matrix = node_stamp_matrix;
+	node_stamp_matrix = stampMatrix;
+
+	uint16_t nodeStamp = searchPtr->node_stamp;
+	searchPtr->node_stamp = node_stamp;
+	node_stamp = nodeStamp;
+
+	//------ move the open and closed lists to the slot ------//
+
+	searchPtr->open_node_list.size = open_node_list.size;
+	memcpy( searchPtr->open_node_list.elements, open_node_list.elements, sizeof(Node*)*(open_node_list.size+1) );
+
+	searchPtr->closed_node_list.size = closed_node_list.size;
+	memcpy( searchPtr->closed_node_list.elements, closed_node_list.elements, sizeof(Node*)*(closed_node_list.size+1) );
+
+	open_node_list.reset_priority_queue();
+	closed_node_list.reset_priority_queue();
+
+	result_node_ptr = NULL;		// get_result() will return no path until the search completes
+
+	return 1;
+}
+//--------- End of function SeekPath::suspend_search ---------//
+
+
+//-------- Begin of function SeekPath::resume_search ---------//
+//
+// Restore the suspended search of the current request, if there is one.
+//
+// return : <int> 1 - the search has been restored, call continue_seek() to carry on
+//                0 - there is no suspended search for this request
+//
+int SeekPath::resume_search()
+{
+	SuspendedSearch* searchPtr = suspended_search_array;
+	int i;
+
+	for( i=0 ; i<MAX_SUSPENDED_SEARCH ; i++, searchPtr++ )
+	{
+		if( searchPtr->request.owner_recno == cur_request.owner_recno )
+			break;
+	}
+
+	if( i==MAX_SUSPENDED_SEARCH )
+		return 0;
+
+	//--- the slot is freed whether it is resumed or not, a different request of the same unit replaces the old one ---//
+
+	searchPtr->request.owner_recno = 0;
+
+	SeekRequest* reqPtr = &searchPtr->request;
+
+	if( sys.frame_count - searchPtr->last_frame > SUSPENDED_SEARCH_EXPIRY ||
+		 reqPtr->sour_x != cur_request.sour_x || reqPtr->sour_y != cur_request.sour_y ||
+		 reqPtr->dest_x != cur_request.dest_x || reqPtr->dest_y != cur_request.dest_y ||
+		 reqPtr->group_id != cur_request.group_id || reqPtr->search_mode != cur_request.search_mode ||
+		 reqPtr->misc_no != cur_request.misc_no || reqPtr->num_of_path != cur_request.num_of_path ||
+		 reqPtr->nation_recno != cur_request.nation_recno || reqPtr->sub_mode != cur_request.sub_mode ||
+		 reqPtr->attack_range != cur_request.attack_range ||
+		 memcmp(reqPtr->nation_passable, cur_request.nation_passable, sizeof(cur_request.nation_passable)) )
+	{
+		return 0;
+	}
+
+	real_sour_x		 = searchPtr->real_sour_x;
+	real_sour_y		 = searchPtr->real_sour_y;
+	real_dest_x		 = searchPtr->real_dest_x;
+	real_dest_y		 = searchPtr->real_dest_y;
+	dest_x			 = searchPtr->dest_x;
+	dest_y			 = searchPtr->dest_y;
+	is_dest_blocked = searchPtr->is_dest_blocked;
+	border_x1		 = searchPtr->border_x1;
+	border_y1		 = searchPtr->border_y1;
+	border_x2		 = searchPtr->border_x2;
+	border_y2		 = searchPtr->border_y2;
+	node_count		 = searchPtr->node_count;
+
+	target_recno	 = searchPtr->target_recno;
+	building_id		 = searchPtr->building_id;
+	building_x1		 = searchPtr->building_x1;
+	building_y1		 = searchPtr->building_y1;
+	building_x2		 = searchPtr->building_x2;
+	building_y2		 = searchPtr->building_y2;
+	search_firm_info = searchPtr->search_firm_info;
+	final_dest_x	 = searchPtr->final_dest_x;
+	final_dest_y	 = searchPtr->final_dest_y;
+	max_node_num	 = 0xFFFF;
+
+	//------ swap the node buffers back ------//
+
+	Node* nodeArray = searchPtr->node_array;
+	searchPtr->node_array = node_array;
+	node_array = nodeArray;
+
+	short* nodeMatrix = searchPtr->node_matrix;
+	searchPtr->node_matrix = node_matrix;
+	node_matrix = nodeMatrix;
+
+	uint16_t* stampMatrix = searchPtr->node_stamp_matrix;
+	searchPtr->node_stamp_matrix = node_stamp_matrix;
+	node_stamp_matrix = stampMatrix;
+
+	uint16_t nodeStamp = searchPtr->node_stamp;
+	searchPtr->node_stamp = node_stamp;
+	node_stamp = nodeStamp;
+
+	//------ restore the open and closed lists ------//
+
+	open_node_list.size = searchPtr->open_node_list.size;
+	memcpy( open_node_list.elements, searchPtr->open_node_list.elements, sizeof(Node*)*(open_node_list.size+1) );
+
+	closed_node_list.size = searchPtr->closed_node_list.size;
+	memcpy( closed_node_list.elements, searchPtr->closed_node_list.elements, sizeof(Node*)*(closed_node_list.size+1) );
+
+	result_node_ptr = NULL;
+
+	return 1;
+}
+//--------- End of function SeekPath::resume_search ---------//
+
+
+//-------- Begin of function SeekPath::reset_node_matrix ---------//
+//
+// Invalidate all entries of node_matrix for a new search. Instead of
+// clearing the whole matrix, the stamp of the search is changed, so only
+// the entries written by the new search are valid.
+//
+void SeekPath::reset_node_matrix()
+{
+	if( ++node_stamp == 0 )		// the stamp has wrapped around, clear the old stamps once
+	{
+		memset(node_stamp_matrix, 0, sizeof(uint16_t)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
+		node_stamp = 1;
+	}
+}
+//--------- End of function SeekPath::reset_node_matrix ---------//
+
+
 //-------- Begin of function SeekPath::add_result_node ---------//
 inline void SeekPath::add_result_node(int x, int y, ResultNode** curPtr, ResultNode** prePtr, int& count)
 {
@@ -623,6 +1317,12 @@ inline void SeekPath::add_result_node(int x, int y, ResultNode** curPtr, ResultN
 //
 // Note: if maxTries==max_node, incremental seek (PATH_SEEKING) won't happen.
 //
+// If resume_owner_recno is set and maxTries is 0, a land search which uses up
+// the nodes available in this frame is suspended and PATH_SEEKING is returned.
+// The same call made by the same unit in a later frame will carry on the
+// search instead of starting again, until MAX_RESUMABLE_SEARCH_NODE nodes
+// have been used.
+//
 // return : <int> seekStatus - PATH_FOUND, PATH_SEEKING, PATH_NODE_USED_UP, or PATH_IMPOSSIBLE
 //						if PATH_FOUND, or PATH_NODE_USED_UP, can call get_result() to retrieve the result.
 //
@@ -630,6 +1330,8 @@ int SeekPath::seek(int sx,int sy,int dx,int dy, uint32_t groupId, char mobileTyp
 						 short searchMode, short miscNo, short numOfPath, int maxTries,
 						 int borderX1,int borderY1,int borderX2,int borderY2)
 {
+	PROFILE_SCOPE("SeekPath::seek");
+
 	err_when(is_yielding);
 
 	if(total_node_avail<=0)
@@ -655,9 +1357,34 @@ int SeekPath::seek(int sx,int sy,int dx,int dy, uint32_t groupId, char mobileTyp
 	//------------------------------------------------------------------------------//
 	// using another searching for unit sea or unit air
 	//------------------------------------------------------------------------------//
+	cur_request.owner_recno = 0;
+
 	if(mobile_type!=UNIT_LAND)
 		return seek2(sx, sy, dx, dy, miscNo, numOfPath, maxTries);	// redirect entry of UNIT_SEA or UNIT_AIR
 
+	//------------------------------------------------------------------------------//
+	// resume the search of the same request suspended in an earlier frame
+	//------------------------------------------------------------------------------//
+	if(resume_owner_recno && search_mode!=SEARCH_MODE_REUSE && !maxTries)
+	{
+		cur_request.owner_recno	= resume_owner_recno;
+		cur_request.sour_x		= sx;
+		cur_request.sour_y		= sy;
+		cur_request.dest_x		= dx;
+		cur_request.dest_y		= dy;
+		cur_request.group_id		= groupId;
+		cur_request.search_mode	= searchMode;
+		cur_request.misc_no		= miscNo;
+		cur_request.num_of_path	= numOfPath;
+		cur_request.nation_recno = seek_nation_recno;
+		cur_request.sub_mode		= search_sub_mode;
+		cur_request.attack_range = attack_range;
+		memcpy(cur_request.nation_passable, nation_passable, sizeof(nation_passable));
+
+		if( resume_search() )
+			return continue_seek(RESUMED_SEARCH_NODE_PER_FRAME);
+	}
+
 	//------------------------------------------------------------------------------//
 	// extract informaton from the parameter "miscNo"
 	//------------------------------------------------------------------------------//
@@ -789,15 +1516,11 @@ int SeekPath::seek(int sx,int sy,int dx,int dy, uint32_t groupId, char mobileTyp
 	// reset node_matrix
 	//-----------------------------------------//
 	if(search_mode!=SEARCH_MODE_REUSE)
-	{
 		max_node_num = 0xFFFF;
-		memset(node_matrix, 0, sizeof(short)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
-	}
 	else
-	{
 		max_node_num = max_node;
-		memcpy(node_matrix, reuse_node_matrix_ptr, sizeof(short)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
-	}
+
+	reset_node_matrix();
 
 	//--------- create the first node ---------//
 	node_count  = 0;
@@ -882,6 +1605,9 @@ int SeekPath::continue_seek(int maxTries, char firstSeek)
 	cur_dest_x	    = dest_x;
 	cur_dest_y	  	 = dest_y;
 	cur_node_matrix = node_matrix;
+	cur_node_stamp_matrix = node_stamp_matrix;
+	cur_node_stamp  = node_stamp;
+	cur_base_node_matrix = search_mode==SEARCH_MODE_REUSE ? reuse_node_matrix_ptr : NULL;
 	cur_node_array  = node_array;
 
    cur_border_x1 	 = border_x1;
@@ -894,9 +1620,20 @@ int SeekPath::continue_seek(int maxTries, char firstSeek)
 	maxNode -= MAX_CHILD_NODE; // generate_successors() can generate a MAX of MAX_CHILD_NODE new nodes per call
 	Node *bestNodePtr;
 
+	//--- a resumable search counts its nodes from where it was suspended, up to MAX_RESUMABLE_SEARCH_NODE ---//
+
+	int nodeLimit = maxNode;
+
+	if( cur_request.owner_recno )
+		nodeLimit = MIN(node_count+maxNode, MAX_RESUMABLE_SEARCH_NODE-MAX_CHILD_NODE);
+
 	int i;
 	for(i=0; i<maxNode; i++)
 	{
+		//--- suspend a resumable search before taking its next node off the open list ---//
+		if( cur_request.owner_recno && node_count >= nodeLimit )
+			break;
+
 		bestNodePtr = return_best_node();
 
 		//if(i%20==0)
@@ -910,7 +1647,7 @@ int SeekPath::continue_seek(int maxTries, char firstSeek)
 		}
 
 		//----- exceed the object's MAX's node limitation, return the closest path ----//
-		if( node_count >= maxNode )
+		if( node_count >= nodeLimit )
 		{
 			path_status = PATH_NODE_USED_UP;
 			break;
@@ -939,6 +1676,17 @@ int SeekPath::continue_seek(int maxTries, char firstSeek)
 
 	err_when( cur_stack_pos!=0 );		// it should be zero all the times, all pushes should have been poped
 	current_search_node_used = i+1;		// store the number of nodes used in this searching
+
+	//---- the nodes of this frame are used up, suspend the search and resume it in a later frame ----//
+
+	if( path_status==PATH_SEEKING && cur_request.owner_recno )
+	{
+		if( node_count < MAX_RESUMABLE_SEARCH_NODE-MAX_CHILD_NODE && suspend_search() )
+			return path_status;
+
+		path_status = PATH_NODE_USED_UP;		// no free slot or no more nodes, return the closest path
+	}
+
 	return path_status;
 }
 //------ End of function SeekPath::continue_seek ---------//
@@ -2274,7 +3022,7 @@ short Node::generate_succ(short x, short y, short enter_direct,short cost)
 	short c, g = node_g+cost;	    	 // g(Successor)=g(BestNode)+cost of getting from BestNode to Successor
 	short nodeRecno;
 
-	if( (nodeRecno=cur_node_matrix[y*MAX_WORLD_X_LOC/2+x]) > 0 &&
+	if( (nodeRecno=get_node_recno(y*MAX_WORLD_X_LOC/2+x)) > 0 &&
 		 nodeRecno<max_node_num)
 	{
 		Node* oldNode = cur_node_array+nodeRecno-1;
@@ -2290,6 +3038,7 @@ short Node::generate_succ(short x, short y, short enter_direct,short cost)
 			oldNode->node_g 	   = g;
 			oldNode->node_f	 	= g+oldNode->node_h;
 			oldNode->enter_direction = (char)enter_direct;
+			update_node_heap(oldNode);
 
 			//-------- if it's a closed node ---------//
 			if(oldNode->child_node[0] )
@@ -2354,7 +3103,7 @@ short Node::generate_succ(short x, short y, short enter_direct,short cost)
 			}	// else continue until reuse node is found and connection point can be walked
 		}
 
-		cur_node_matrix[y*MAX_WORLD_X_LOC/2+x] = cur_seek_path->node_count;
+		set_node_recno(y*MAX_WORLD_X_LOC/2+x, cur_seek_path->node_count);
 		cur_seek_path->open_node_list.insert_node(succNode);
 		for(c=0 ; c<MAX_CHILD_NODE && child_node[c] ; c++);   // Add oldNode to the list of BestNode's child_noderen (or succNodes).
 		child_node[c]=succNode;
@@ -2462,6 +3211,7 @@ void Node::propagate_down()
 			{
 				childNode->node_g 	  = g+cost;
 				childNode->node_f 	  = childNode->node_g+childNode->node_h;
+				update_node_heap(childNode);
 				childNode->parent_node = this;// reset parent to new path.
 				childNode->enter_direction = childEnterDirection;
 				stack_push(childNode);			// Now the childNode's branch need to be checked out. Remember the new cost must be propagated down.
@@ -2561,6 +3311,7 @@ void Node::propagate_down()
 				{
 					childNode->node_g 	  = g+cost;
 					childNode->node_f 	  = childNode->node_g+childNode->node_h;
+					update_node_heap(childNode);
 					childNode->parent_node = fatherNode;
 					childNode->enter_direction = childEnterDirection;
 					stack_push(childNode);
@@ -2661,7 +3412,7 @@ int SeekPath::seek2(int sx, int sy, int dx, int dy, short miscNo, short numOfPat
 				break;
 	
 		case SEARCH_MODE_TO_LAND_FOR_SHIP:
-				region_id = static_cast<uint8_t>(miscNo);
+				region_id = static_cast<uint16_t>(miscNo);
 				break;
 	}
 	
@@ -2738,15 +3489,11 @@ int SeekPath::seek2(int sx, int sy, int dx, int dy, short miscNo, short numOfPat
 	// reset node_matrix
 	//-----------------------------------------//
 	if(search_mode!=SEARCH_MODE_REUSE)
-	{
 		max_node_num = 0xFFFF;
-		memset(node_matrix, 0, sizeof(short)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
-	}
 	else
-	{
 		max_node_num = max_node;
-		memcpy(node_matrix, reuse_node_matrix_ptr, sizeof(short)*MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC/4);
-	}
+
+	reset_node_matrix();
 
 	//--------- create the first node ---------//
 	node_count  = 0;
@@ -2845,6 +3592,9 @@ int SeekPath::continue_seek2(int maxTries, char firstSeek)
 	cur_dest_x	    = dest_x;
 	cur_dest_y	  	 = dest_y;
 	cur_node_matrix = node_matrix;
+	cur_node_stamp_matrix = node_stamp_matrix;
+	cur_node_stamp  = node_stamp;
+	cur_base_node_matrix = search_mode==SEARCH_MODE_REUSE ? reuse_node_matrix_ptr : NULL;
 	cur_node_array  = node_array;
 
    cur_border_x1 	 = border_x1;
@@ -3160,7 +3910,7 @@ short Node::generate_succ2(short x, short y, short cost)
 	short c, g = node_g+1;	    	 // g(Successor)=g(BestNode)+cost of getting from BestNode to Successor
 	short nodeRecno;
 
-	if((nodeRecno=cur_node_matrix[y*MAX_WORLD_X_LOC/2+x]) > 0 && nodeRecno<max_node_num)
+	if((nodeRecno=get_node_recno(y*MAX_WORLD_X_LOC/2+x)) > 0 && nodeRecno<max_node_num)
 	{
 		Node* oldNode = cur_node_array+nodeRecno-1;
 
@@ -3174,6 +3924,7 @@ short Node::generate_succ2(short x, short y, short cost)
 			oldNode->parent_node = this;
 			oldNode->node_g 	   = g;
 			oldNode->node_f	 	= g+oldNode->node_h;
+			update_node_heap(oldNode);
 
 			//-------- if it's a closed node ---------//
 			if(oldNode->child_node[0] )
@@ -3213,7 +3964,7 @@ short Node::generate_succ2(short x, short y, short cost)
 			}	// else continue until reuse node is found and connection point can be walked
 		}
 
-		cur_node_matrix[y*MAX_WORLD_X_LOC/2+x] = cur_seek_path->node_count;
+		set_node_recno(y*MAX_WORLD_X_LOC/2+x, cur_seek_path->node_count);
 		cur_seek_path->open_node_list.insert_node(succNode);
 		for(c=0 ; c<MAX_CHILD_NODE && child_node[c] ; c++);   // Add oldNode to the list of BestNode's child_noderen (or succNodes).
 		child_node[c]=succNode;
@@ -3251,6 +4002,7 @@ void Node::propagate_down2()
 			{
 				childNode->node_g 	  = g+cost;
 				childNode->node_f 	  = childNode->node_g+childNode->node_h;
+				update_node_heap(childNode);
 				childNode->parent_node = this;     		// reset parent to new path.
 
 				stack_push(childNode);                 		// Now the childNode's branch need to be
@@ -3280,6 +4032,7 @@ void Node::propagate_down2()
 				{
 					childNode->node_g 	  = g+cost;
 					childNode->node_f 	  = childNode->node_g+childNode->node_h;
+					update_node_heap(childNode);
 					childNode->parent_node = fatherNode;
 					stack_push(childNode);
 				}
@@ -40,8 +40,8 @@ NodePriorityQueue SeekPath::closed_node_list;
 //-------- Begin of function NodePriorityQueue::reset_priority_queue -------//
 void NodePriorityQueue::reset_priority_queue()
 {
+	memset(elements, 0, sizeof(Node*)*(size+1));		// only the used part needs clearing, the array is large enough for resumed searches
 	size = 0U;
-	memset(elements, 0, sizeof(Node*)*(MAX_ARRAY_SIZE));
 }
 //-------- End of function NodePriorityQueue::reset_priority_queue ---------//
 
@@ -56,14 +56,42 @@ void NodePriorityQueue::insert_node(Node *insertNode)
 	while(i>1 && localElements[i/2]->node_f > f)
 	{
 		localElements[i] = localElements[i/2];
+		localElements[i]->heap_pos = i;
 		i /= 2;
 	}
 
 	localElements[i] = insertNode;
+	insertNode->heap_pos = i;
 }
 //-------- End of function NodePriorityQueue::insert_node ---------//
 
 
+//-------- Begin of function NodePriorityQueue::decrease_key -------//
+//
+// Move a node in the list up to its new place after its node_f has
+// been reduced.
+//
+void NodePriorityQueue::decrease_key(Node *nodePtr)
+{
+	unsigned int i = nodePtr->heap_pos;
+	int f=nodePtr->node_f;
+	Node **localElements = elements;
+
+	err_when(i<1 || i>size || localElements[i]!=nodePtr);
+
+	while(i>1 && localElements[i/2]->node_f > f)
+	{
+		localElements[i] = localElements[i/2];
+		localElements[i]->heap_pos = i;
+		i /= 2;
+	}
+
+	localElements[i] = nodePtr;
+	nodePtr->heap_pos = i;
+}
+//-------- End of function NodePriorityQueue::decrease_key ---------//
+
+
 //-------- Begin of function NodePriorityQueue::return_min -------//
 Node* NodePriorityQueue::return_min()
 {
@@ -86,12 +114,17 @@ Node* NodePriorityQueue::return_min()
 			child++;
 
 		if(lastF > localElements[child]->node_f)
+		{
 			localElements[i] = localElements[child];
+			localElements[i]->heap_pos = i;
+		}
 		else
 			break;
 	}
 
 	localElements[i] = lastElement;
+	lastElement->heap_pos = i;
+	minElement->heap_pos = 0;
 
 	return minElement;
 }
@@ -108,7 +141,10 @@ Node* SeekPath::return_best_node()
 	Node *tempNode = open_node_list.return_min();
 	
 	if(tempNode)
+	{
+		tempNode->closed_flag = 1;
 		closed_node_list.insert_node(tempNode);
+	}
 
 	return tempNode;
 }
@@ -0,0 +1,407 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPCACHE.CPP
+//Description : Object SeekPathCache, cache of path seeking results
+
+#include <stdlib.h>
+#include <string.h>
+#include <ALL.h>
+#include <OWORLD.h>
+#include <OUNIT.h>
+#include <OSPATH.h>
+#include <OPROFILE.h>
+#include <OSPCACHE.h>
+
+//-------- Begin of function SeekPathCache::SeekPathCache --------//
+
+SeekPathCache::SeekPathCache()
+{
+	memset( this, 0, sizeof(SeekPathCache) );
+
+	for( int i=0 ; i<PATH_CACHE_SIZE ; i++ )
+		entry_array[i].next_entry = PATH_CACHE_FREE_ENTRY;
+
+	for( int i=0 ; i<PATH_CACHE_BUCKET ; i++ )
+		bucket_array[i] = -1;
+}
+//--------- End of function SeekPathCache::SeekPathCache ---------//
+
+
+//-------- Begin of function SeekPathCache::~SeekPathCache --------//
+
+SeekPathCache::~SeekPathCache()
+{
+	deinit();
+}
+//--------- End of function SeekPathCache::~SeekPathCache ---------//
+
+
+//-------- Begin of function SeekPathCache::deinit --------//
+
+void SeekPathCache::deinit()
+{
+	clear();
+}
+//--------- End of function SeekPathCache::deinit ---------//
+
+
+//-------- Begin of function SeekPathCache::clear --------//
+//
+// Discard all cached paths. It is called when a game is started, or
+// loaded from a game file of an older version which does not save the
+// cache.
+//
+void SeekPathCache::clear()
+{
+	for( int i=0 ; i<PATH_CACHE_SIZE ; i++ )
+	{
+		if( entry_array[i].next_entry != PATH_CACHE_FREE_ENTRY )
+			del_entry(i);
+	}
+
+	use_count = 0;
+}
+//--------- End of function SeekPathCache::clear ---------//
+
+
+//-------- Begin of function SeekPathCache::is_cacheable --------//
+//
+// Whether the result of a search of the given mode can be cached. Only
+// searches to fixed destinations are cached, not those to moving targets.
+//
+int SeekPathCache::is_cacheable(short searchMode, char mobileType)
+{
+	return mobileType==UNIT_LAND &&
+			 (searchMode==SEARCH_MODE_IN_A_GROUP || searchMode==SEARCH_MODE_TO_FIRM || searchMode==SEARCH_MODE_TO_TOWN);
+}
+//--------- End of function SeekPathCache::is_cacheable ---------//
+
+
+//-------- Begin of function SeekPathCache::get_path --------//
+//
+// Look up a path for the given search in the cache.
+//
+// <int>   sx, sy           - the start location
+// <int>   dx, dy           - the destination passed to SeekPath::seek()
+// <char>  mobileType       - mobile type of the unit
+// <short> searchMode, miscNo, numOfPath - as passed to SeekPath::seek()
+// <char>  subMode          - the sub mode of SeekPath
+// <char*> nationPassable   - the nation_passable array of SeekPath
+// <int&>  resultNodeCount  - for returning the no. of nodes
+// <short&> pathDist        - for returning the distance of the path
+//
+// return : <ResultNode*> a copy of the path allocated by mem_add(), starting from (sx, sy)
+//          NULL if there is no such path in the cache
+//
+ResultNode* SeekPathCache::get_path(int sx, int sy, int dx, int dy, char mobileType, short searchMode, short miscNo, short numOfPath,
+												char subMode, char* nationPassable, int& resultNodeCount, short& pathDist)
+{
+	resultNodeCount = pathDist = 0;
+
+	int regionId = world.get_loc(sx, sy)->region_id;
+	int sourCell = get_cell(sx, sy);
+	int destCell = get_cell(dx, dy);
+	int entryId, startNodeId, skipDist;
+	PathCacheEntry* entryPtr;
+
+	for( entryId=bucket_array[get_bucket(mobileType, regionId, sourCell, destCell)] ; entryId>=0 ; entryId=entryPtr->next_entry )
+	{
+		entryPtr = entry_array+entryId;
+
+		if( entryPtr->mobile_type != mobileType || entryPtr->region_id != regionId ||
+			 entryPtr->sour_cell != sourCell || entryPtr->dest_cell != destCell ||
+			 entryPtr->dest_x_loc != dx || entryPtr->dest_y_loc != dy ||
+			 entryPtr->search_mode != searchMode || entryPtr->misc_no != miscNo ||
+			 entryPtr->num_of_path != numOfPath || entryPtr->sub_mode != subMode )
+		{
+			continue;
+		}
+
+		if( subMode==SEARCH_SUB_MODE_PASSABLE &&
+			 memcmp(entryPtr->nation_passable, nationPassable, sizeof(entryPtr->nation_passable)) )
+		{
+			continue;
+		}
+
+		if( (startNodeId = find_start_node(entryPtr, sx, sy, skipDist)) < 0 )
+			continue;
+
+		//------ copy the path from the start location ------//
+
+		resultNodeCount = 1 + entryPtr->node_count - startNodeId;
+		pathDist = entryPtr->path_dist - skipDist;
+
+		ResultNode* nodeArray = (ResultNode*) mem_add( sizeof(ResultNode) * resultNodeCount );
+
+		nodeArray->node_x = sx;
+		nodeArray->node_y = sy;
+
+		memcpy( nodeArray+1, entryPtr->node_array+startNodeId, sizeof(ResultNode) * (resultNodeCount-1) );
+
+		entryPtr->last_use = ++use_count;
+
+		PROFILE_COUNT("Path cache hit", 1);
+		return nodeArray;
+	}
+
+	PROFILE_COUNT("Path cache miss", 1);
+	return NULL;
+}
+//--------- End of function SeekPathCache::get_path ---------//
+
+
+//-------- Begin of function SeekPathCache::add_path --------//
+//
+// Add a path found by SeekPath to the cache. The least recently used
+// path is dropped if the cache is full.
+//
+void SeekPathCache::add_path(int sx, int sy, int dx, int dy, char mobileType, short searchMode, short miscNo, short numOfPath,
+									  char subMode, char* nationPassable, ResultNode* nodeArray, int nodeCount, short pathDist)
+{
+	if( nodeCount < 2 || nodeCount > PATH_CACHE_MAX_NODE || pathDist < PATH_CACHE_MIN_DIST )
+		return;
+
+	err_when( nodeArray->node_x != sx || nodeArray->node_y != sy );
+
+	//------- select the entry to use -------//
+
+	int entryId=0, i;
+
+	for( i=0 ; i<PATH_CACHE_SIZE ; i++ )
+	{
+		if( entry_array[i].next_entry == PATH_CACHE_FREE_ENTRY )
+		{
+			entryId = i;
+			break;
+		}
+
+		if( entry_array[i].last_use < entry_array[entryId].last_use )
+			entryId = i;
+	}
+
+	if( entry_array[entryId].next_entry != PATH_CACHE_FREE_ENTRY )
+		del_entry(entryId);
+
+	//------- set the entry -------//
+
+	PathCacheEntry* entryPtr = entry_array+entryId;
+
+	entryPtr->mobile_type = mobileType;
+	entryPtr->region_id	 = world.get_loc(sx, sy)->region_id;
+	entryPtr->sour_cell	 = get_cell(sx, sy);
+	entryPtr->dest_cell	 = get_cell(dx, dy);
+	entryPtr->sour_x_loc	 = sx;
+	entryPtr->sour_y_loc	 = sy;
+	entryPtr->dest_x_loc	 = dx;
+	entryPtr->dest_y_loc	 = dy;
+	entryPtr->search_mode = searchMode;
+	entryPtr->misc_no		 = miscNo;
+	entryPtr->num_of_path = numOfPath;
+	entryPtr->sub_mode	 = subMode;
+	entryPtr->path_dist	 = pathDist;
+	entryPtr->node_count	 = nodeCount;
+	entryPtr->last_use	 = ++use_count;
+
+	if( subMode==SEARCH_SUB_MODE_PASSABLE )
+		memcpy( entryPtr->nation_passable, nationPassable, sizeof(entryPtr->nation_passable) );
+	else
+		memset( entryPtr->nation_passable, 0, sizeof(entryPtr->nation_passable) );
+
+	entryPtr->node_array = (ResultNode*) mem_add( sizeof(ResultNode) * nodeCount );
+	memcpy( entryPtr->node_array, nodeArray, sizeof(ResultNode) * nodeCount );
+
+	//---- the straight lines between the nodes are within the rectangle bounding the nodes ----//
+
+	entryPtr->x_loc1 = entryPtr->x_loc2 = sx;
+	entryPtr->y_loc1 = entryPtr->y_loc2 = sy;
+
+	for( i=1 ; i<nodeCount ; i++ )
+	{
+		entryPtr->x_loc1 = MIN(entryPtr->x_loc1, nodeArray[i].node_x);
+		entryPtr->y_loc1 = MIN(entryPtr->y_loc1, nodeArray[i].node_y);
+		entryPtr->x_loc2 = MAX(entryPtr->x_loc2, nodeArray[i].node_x);
+		entryPtr->y_loc2 = MAX(entryPtr->y_loc2, nodeArray[i].node_y);
+	}
+
+	//------- add it to its hash bucket -------//
+
+	short* bucketPtr = bucket_array + get_bucket(mobileType, entryPtr->region_id, entryPtr->sour_cell, entryPtr->dest_cell);
+
+	entryPtr->next_entry = *bucketPtr;
+	*bucketPtr = entryId;
+}
+//--------- End of function SeekPathCache::add_path ---------//
+
+
+//-------- Begin of function SeekPathCache::invalidate_loc --------//
+//
+// The walkability of the given location has changed. Drop all paths
+// which may pass it.
+//
+void SeekPathCache::invalidate_loc(int xLoc, int yLoc)
+{
+	for( int i=0 ; i<PATH_CACHE_SIZE ; i++ )
+	{
+		PathCacheEntry* entryPtr = entry_array+i;
+
+		if( entryPtr->next_entry != PATH_CACHE_FREE_ENTRY &&
+			 xLoc >= entryPtr->x_loc1 && xLoc <= entryPtr->x_loc2 &&
+			 yLoc >= entryPtr->y_loc1 && yLoc <= entryPtr->y_loc2 )
+		{
+			del_entry(i);
+			PROFILE_COUNT("Path cache invalidate", 1);
+		}
+	}
+}
+//--------- End of function SeekPathCache::invalidate_loc ---------//
+
+
+//-------- Begin of function SeekPathCache::invalidate_power --------//
+//
+// The territory of the nations has changed in the given area. Drop the
+// paths found in SEARCH_SUB_MODE_PASSABLE which may pass it, as they
+// depend on Location::power_nation_recno.
+//
+void SeekPathCache::invalidate_power(int xLoc1, int yLoc1, int xLoc2, int yLoc2)
+{
+	for( int i=0 ; i<PATH_CACHE_SIZE ; i++ )
+	{
+		PathCacheEntry* entryPtr = entry_array+i;
+
+		if( entryPtr->next_entry != PATH_CACHE_FREE_ENTRY &&
+			 entryPtr->sub_mode == SEARCH_SUB_MODE_PASSABLE &&
+			 xLoc2 >= entryPtr->x_loc1 && xLoc1 <= entryPtr->x_loc2 &&
+			 yLoc2 >= entryPtr->y_loc1 && yLoc1 <= entryPtr->y_loc2 )
+		{
+			del_entry(i);
+			PROFILE_COUNT("Path cache invalidate", 1);
+		}
+	}
+}
+//--------- End of function SeekPathCache::invalidate_power ---------//
+
+
+//-------- Begin of function SeekPathCache::get_bucket --------//
+
+int SeekPathCache::get_bucket(char mobileType, int regionId, int sourCell, int destCell)
+{
+	uint32_t hashValue = ((uint32_t) sourCell * 31 + (uint32_t) destCell) * 31 + regionId * 7 + mobileType;
+
+	hashValue ^= hashValue >> 11;
+
+	return hashValue & (PATH_CACHE_BUCKET-1);
+}
+//--------- End of function SeekPathCache::get_bucket ---------//
+
+
+//-------- Begin of function SeekPathCache::del_entry --------//
+
+void SeekPathCache::del_entry(int entryId)
+{
+	PathCacheEntry* entryPtr = entry_array+entryId;
+
+	err_when( entryPtr->next_entry == PATH_CACHE_FREE_ENTRY );
+
+	//------- unlink it from its hash bucket -------//
+
+	short* linkPtr = bucket_array + get_bucket(entryPtr->mobile_type, entryPtr->region_id, entryPtr->sour_cell, entryPtr->dest_cell);
+
+	while( *linkPtr != entryId )
+	{
+		err_when( *linkPtr < 0 );
+		linkPtr = &entry_array[*linkPtr].next_entry;
+	}
+
+	*linkPtr = entryPtr->next_entry;
+
+	mem_del( entryPtr->node_array );
+	entryPtr->node_array = NULL;
+	entryPtr->next_entry = PATH_CACHE_FREE_ENTRY;
+}
+//--------- End of function SeekPathCache::del_entry ---------//
+
+
+//-------- Begin of function SeekPathCache::find_start_node --------//
+//
+// Find where a unit at the given location can join the cached path. It
+// can join if it is on the path, or next to the start of the path.
+//
+// <int>  sx, sy   - the location of the unit
+// <int&> skipDist - for returning the distance of the path skipped,
+//                   -1 if the unit has to take a step to the start of the path
+//
+// return : <int> the id. of the first node to move to from (sx, sy), -1 if the unit cannot join the path
+//
+int SeekPathCache::find_start_node(PathCacheEntry* entryPtr, int sx, int sy, int& skipDist)
+{
+	ResultNode* nodeArray = entryPtr->node_array;
+	int nodeCount = entryPtr->node_count;
+
+	skipDist = 0;
+
+	//------- check if it is on the path -------//
+
+	for( int i=0 ; i<nodeCount-1 ; i++ )
+	{
+		int x1 = nodeArray[i].node_x, y1 = nodeArray[i].node_y;
+		int x2 = nodeArray[i+1].node_x, y2 = nodeArray[i+1].node_y;
+		int segDist = MAX(abs(x2-x1), abs(y2-y1));
+
+		//--- the unit is on the line if it is in the same direction from the first node, at no further than the second ---//
+
+		int unitDist = MAX(abs(sx-x1), abs(sy-y1));
+
+		if( unitDist <= segDist &&
+			 (sx-x1)*segDist == (x2-x1)*unitDist && (sy-y1)*segDist == (y2-y1)*unitDist )
+		{
+			skipDist += unitDist;
+
+			if( unitDist==segDist )		// it is on the second node
+				return i+2 < nodeCount ? i+2 : -1;
+			else
+				return i+1;
+		}
+
+		skipDist += segDist;
+	}
+
+	//------- check if it is next to the start of the path -------//
+
+	if( MAX(abs(sx-nodeArray->node_x), abs(sy-nodeArray->node_y)) == 1 )
+	{
+		skipDist = -1;
+		return 0;
+	}
+
+	return -1;
+}
+//--------- End of function SeekPathCache::find_start_node ---------//
+
+
+//-------- Begin of function SeekPathCache::get_cell --------//
+
+int SeekPathCache::get_cell(int xLoc, int yLoc)
+{
+	int cellXCount = (MAX_WORLD_X_LOC + (1<<PATH_CACHE_CELL_SHIFT) - 1) >> PATH_CACHE_CELL_SHIFT;
+
+	return (yLoc >> PATH_CACHE_CELL_SHIFT) * cellXCount + (xLoc >> PATH_CACHE_CELL_SHIFT);
+}
+//--------- End of function SeekPathCache::get_cell ---------//
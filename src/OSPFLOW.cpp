@@ -0,0 +1,444 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPFLOW.CPP
+//Description : Object FlowField, shared movement field for large group orders
+
+#include <stdlib.h>
+#include <string.h>
+#include <ALL.h>
+#include <OWORLD.h>
+#include <ONATION.h>
+#include <OSPATH.h>
+#include <OPROFILE.h>
+#include <OSPFLOW.h>
+
+//--- Define the location offset of each direction (N, NE, E, SE, S, SW, W, NW) ---//
+
+static char flow_x_offset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static char flow_y_offset[] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+//-------- Begin of function FlowField::FlowField --------//
+
+FlowField::FlowField()
+{
+	memset( this, 0, sizeof(FlowField) );
+}
+//--------- End of function FlowField::FlowField ---------//
+
+
+//-------- Begin of function FlowField::~FlowField --------//
+
+FlowField::~FlowField()
+{
+	deinit();
+}
+//--------- End of function FlowField::~FlowField ---------//
+
+
+//-------- Begin of function FlowField::init --------//
+//
+// It is called whenever a map has been generated or loaded. The fields
+// themselves are allocated when they are first built.
+//
+void FlowField::init()
+{
+	deinit();
+
+	queue_array = (int*) mem_add( sizeof(int) * MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC );
+}
+//--------- End of function FlowField::init ---------//
+
+
+//-------- Begin of function FlowField::deinit --------//
+
+void FlowField::deinit()
+{
+	for( int i=0 ; i<MAX_FLOW_FIELD ; i++ )
+	{
+		FlowFieldInfo* fieldPtr = field_array+i;
+
+		if( fieldPtr->dist_matrix )
+		{
+			mem_del( fieldPtr->dist_matrix );
+			mem_del( fieldPtr->dir_matrix );
+
+			fieldPtr->dist_matrix = NULL;
+			fieldPtr->dir_matrix = NULL;
+		}
+	}
+
+	if( queue_array )
+	{
+		mem_del( queue_array );
+		queue_array = NULL;
+	}
+
+	clear();
+}
+//--------- End of function FlowField::deinit ---------//
+
+
+//-------- Begin of function FlowField::clear --------//
+//
+// Discard all fields. It is called when a game is started, or loaded
+// from a game file of an older version which does not save the fields.
+//
+void FlowField::clear()
+{
+	for( int i=0 ; i<MAX_FLOW_FIELD ; i++ )
+	{
+		field_array[i].group_id = 0;
+		field_array[i].last_use = 0;
+	}
+
+	use_count = 0;
+}
+//--------- End of function FlowField::clear ---------//
+
+
+//-------- Begin of function FlowField::build --------//
+//
+// Build the field of a group move order. It replaces the field of the
+// same group and region, or the least recently used one.
+//
+// <uint32_t> groupId            - unit_group_id of the units moving
+// <int>      destXLoc, destYLoc - the destination
+// <int>      destRadius         - the formation locations of the units are within this distance of the destination
+// <short>    nationRecno        - nation recno of the units, 0 if they may pass any territory
+//
+// return : <int> 1 - the field is built
+//                0 - the destination cannot be reached by land units
+//
+int FlowField::build(uint32_t groupId, int destXLoc, int destYLoc, int destRadius, short nationRecno)
+{
+	if( !queue_array )
+		return 0;
+
+	Location* destLocPtr = world.get_loc(destXLoc, destYLoc);
+
+	if( !destLocPtr->walkable() )
+		return 0;
+
+	//------- select the slot to use -------//
+
+	FlowFieldInfo* fieldPtr = get_field(groupId, destLocPtr->region_id);
+
+	if( !fieldPtr )
+	{
+		fieldPtr = field_array;
+
+		for( int i=1 ; i<MAX_FLOW_FIELD && fieldPtr->group_id ; i++ )
+		{
+			if( !field_array[i].group_id || field_array[i].last_use < fieldPtr->last_use )
+				fieldPtr = field_array+i;
+		}
+	}
+
+	if( !fieldPtr->dist_matrix )
+	{
+		fieldPtr->dist_matrix = (uint16_t*) mem_add( sizeof(uint16_t) * MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC );
+		fieldPtr->dir_matrix  = (uint8_t*) mem_add( sizeof(uint8_t) * MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC );
+	}
+
+	fieldPtr->group_id	 = groupId;
+	fieldPtr->dest_x_loc  = destXLoc;
+	fieldPtr->dest_y_loc  = destYLoc;
+	fieldPtr->dest_radius = destRadius;
+	fieldPtr->region_id	 = destLocPtr->region_id;
+	fieldPtr->last_use	 = ++use_count;
+
+	//---------------------------------------------------------------//
+	// as Unit::select_search_sub_mode(), only pass territories of
+	// friendly nations if the destination is not in a hostile one
+	//---------------------------------------------------------------//
+
+	fieldPtr->sub_mode = SEARCH_SUB_MODE_NORMAL;
+
+	if( nationRecno )
+	{
+		Nation* nationPtr = nation_array[nationRecno];
+
+		if( !destLocPtr->power_nation_recno || nationPtr->get_relation_passable(destLocPtr->power_nation_recno) )
+		{
+			fieldPtr->sub_mode = SEARCH_SUB_MODE_PASSABLE;
+			fieldPtr->nation_passable[0] = 0;
+			memcpy( fieldPtr->nation_passable+1, nationPtr->relation_passable_array, sizeof(char)*MAX_NATION );
+		}
+	}
+
+	cal_field(fieldPtr);
+
+	return 1;
+}
+//--------- End of function FlowField::build ---------//
+
+
+//-------- Begin of function FlowField::invalidate_loc --------//
+//
+// The walkability of the given location has changed. Fields which have
+// reached the location or its neighbours are calculated again when they
+// are next used.
+//
+void FlowField::invalidate_loc(int xLoc, int yLoc)
+{
+	int x1 = MAX(xLoc-1, 0), x2 = MIN(xLoc+1, MAX_WORLD_X_LOC-1);
+	int y1 = MAX(yLoc-1, 0), y2 = MIN(yLoc+1, MAX_WORLD_Y_LOC-1);
+
+	for( int i=0 ; i<MAX_FLOW_FIELD ; i++ )
+	{
+		FlowFieldInfo* fieldPtr = field_array+i;
+
+		if( !fieldPtr->group_id || fieldPtr->dirty_flag )
+			continue;
+
+		for( int y=y1 ; y<=y2 && !fieldPtr->dirty_flag ; y++ )
+		{
+			uint16_t* distPtr = fieldPtr->dist_matrix + y*MAX_WORLD_X_LOC;
+
+			for( int x=x1 ; x<=x2 ; x++ )
+			{
+				if( distPtr[x] != FLOW_FIELD_UNREACHED )
+				{
+					fieldPtr->dirty_flag = 1;
+					break;
+				}
+			}
+		}
+	}
+}
+//--------- End of function FlowField::invalidate_loc ---------//
+
+
+//-------- Begin of function FlowField::get_path --------//
+//
+// Follow the field of the unit's group from the start location until
+// the unit is within FLOW_FIELD_LOCAL_DIST of its own destination. The
+// rest of the way is left to SeekPath when the unit arrives there.
+//
+// <uint32_t> groupId - unit_group_id of the unit
+// <int>      sx, sy  - the start location
+// <int>      dx, dy  - the destination of the unit
+// <int&>     resultNodeCount - for returning the no. of nodes
+// <short&>   pathDist        - for returning the no. of steps
+//
+// return : <ResultNode*> the turning points of the path, allocated by mem_add()
+//          NULL if the unit is not covered by a field
+//
+ResultNode* FlowField::get_path(uint32_t groupId, int sx, int sy, int dx, int dy, int& resultNodeCount, short& pathDist)
+{
+	resultNodeCount = pathDist = 0;
+
+	if( !groupId || MAX(abs(sx-dx), abs(sy-dy)) <= FLOW_FIELD_LOCAL_DIST )
+		return NULL;
+
+	FlowFieldInfo* fieldPtr = get_field(groupId, world.get_loc(sx, sy)->region_id);
+
+	//--- the unit may have been given another order since, without changing its group ---//
+
+	if( !fieldPtr || MAX(abs(dx-fieldPtr->dest_x_loc), abs(dy-fieldPtr->dest_y_loc)) > fieldPtr->dest_radius )
+		return NULL;
+
+	if( fieldPtr->dirty_flag )
+		cal_field(fieldPtr);
+
+	int startDist = fieldPtr->dist_matrix[sy*MAX_WORLD_X_LOC+sx];
+
+	if( startDist==FLOW_FIELD_UNREACHED || startDist==0 )
+		return NULL;
+
+	fieldPtr->last_use = ++use_count;
+
+	//---- a path of n steps has at most n+1 turning points ----//
+
+	ResultNode* nodeArray = (ResultNode*) mem_add( sizeof(ResultNode) * (startDist+1) );
+	ResultNode* nodePtr = nodeArray;
+
+	nodePtr->node_x = sx;
+	nodePtr->node_y = sy;
+	nodePtr++;
+
+	int xLoc=sx, yLoc=sy, lastDir=-1, stepCount=0;
+
+	while( fieldPtr->dist_matrix[yLoc*MAX_WORLD_X_LOC+xLoc] > 0 &&
+			 MAX(abs(xLoc-dx), abs(yLoc-dy)) > FLOW_FIELD_LOCAL_DIST )
+	{
+		//--- only the first step avoids units, the ones further ahead will have moved by the time the unit gets there ---//
+
+		int dir = get_next_loc(fieldPtr, xLoc, yLoc, stepCount==0);
+
+		if( dir != lastDir && lastDir != -1 )		// add the turning point
+		{
+			nodePtr->node_x = xLoc;
+			nodePtr->node_y = yLoc;
+			nodePtr++;
+		}
+
+		xLoc += flow_x_offset[dir];
+		yLoc += flow_y_offset[dir];
+		lastDir = dir;
+		stepCount++;
+	}
+
+	nodePtr->node_x = xLoc;
+	nodePtr->node_y = yLoc;
+	nodePtr++;
+
+	resultNodeCount = int(nodePtr - nodeArray);
+	pathDist = stepCount;
+
+	err_when( resultNodeCount > startDist+1 );
+
+	return (ResultNode*) mem_resize( nodeArray, sizeof(ResultNode) * resultNodeCount );
+}
+//--------- End of function FlowField::get_path ---------//
+
+
+//-------- Begin of function FlowField::get_field --------//
+
+FlowFieldInfo* FlowField::get_field(uint32_t groupId, int regionId)
+{
+	for( int i=0 ; i<MAX_FLOW_FIELD ; i++ )
+	{
+		if( field_array[i].group_id==groupId && field_array[i].region_id==regionId )
+			return field_array+i;
+	}
+
+	return NULL;
+}
+//--------- End of function FlowField::get_field ---------//
+
+
+//-------- Begin of function FlowField::cal_field --------//
+//
+// Calculate the integration field by a breadth-first search from the
+// destination, and the direction field from it. A unit takes the same
+// time for a straight and a diagonal step, so each step costs 1.
+//
+void FlowField::cal_field(FlowFieldInfo* fieldPtr)
+{
+	PROFILE_SCOPE("FlowField::cal_field");
+
+	uint16_t* distMatrix = fieldPtr->dist_matrix;
+	uint8_t*  dirMatrix  = fieldPtr->dir_matrix;
+
+	memset( distMatrix, 0xFF, sizeof(uint16_t) * MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC );
+	memset( dirMatrix, FLOW_DIR_NONE, sizeof(uint8_t) * MAX_WORLD_X_LOC * MAX_WORLD_Y_LOC );
+
+	fieldPtr->dirty_flag = 0;
+
+	if( !is_passable(fieldPtr, fieldPtr->dest_x_loc, fieldPtr->dest_y_loc) )
+		return;
+
+	int queueHead=0, queueTail=0;
+	int destIndex = fieldPtr->dest_y_loc*MAX_WORLD_X_LOC + fieldPtr->dest_x_loc;
+
+	distMatrix[destIndex] = 0;
+	queue_array[queueTail++] = destIndex;
+
+	while( queueHead < queueTail )
+	{
+		int locIndex = queue_array[queueHead++];
+		int xLoc = locIndex % MAX_WORLD_X_LOC;
+		int yLoc = locIndex / MAX_WORLD_X_LOC;
+		int newDist = distMatrix[locIndex] + 1;
+
+		for( int dir=0 ; dir<8 ; dir++ )
+		{
+			int nextXLoc = xLoc + flow_x_offset[dir];
+			int nextYLoc = yLoc + flow_y_offset[dir];
+
+			if( nextXLoc<0 || nextXLoc>=MAX_WORLD_X_LOC || nextYLoc<0 || nextYLoc>=MAX_WORLD_Y_LOC )
+				continue;
+
+			int nextIndex = nextYLoc*MAX_WORLD_X_LOC + nextXLoc;
+
+			if( distMatrix[nextIndex] != FLOW_FIELD_UNREACHED || !is_passable(fieldPtr, nextXLoc, nextYLoc) )
+				continue;
+
+			//--- don't cut corners, as units cannot squeeze between two diagonal obstacles ---//
+
+			if( (dir & 1) && (!is_passable(fieldPtr, nextXLoc, yLoc) || !is_passable(fieldPtr, xLoc, nextYLoc)) )
+				continue;
+
+			distMatrix[nextIndex] = newDist;
+			dirMatrix[nextIndex]  = (dir+4) % 8;		// the opposite direction, back towards the destination
+			queue_array[queueTail++] = nextIndex;
+		}
+	}
+}
+//--------- End of function FlowField::cal_field ---------//
+
+
+//-------- Begin of function FlowField::is_passable --------//
+
+int FlowField::is_passable(FlowFieldInfo* fieldPtr, int xLoc, int yLoc)
+{
+	Location* locPtr = world.get_loc(xLoc, yLoc);
+
+	if( !locPtr->walkable() )
+		return 0;
+
+	int powerNationRecno = locPtr->power_nation_recno;
+
+	return fieldPtr->sub_mode!=SEARCH_SUB_MODE_PASSABLE || !powerNationRecno ||
+			 fieldPtr->nation_passable[powerNationRecno];
+}
+//--------- End of function FlowField::is_passable ---------//
+
+
+//-------- Begin of function FlowField::get_next_loc --------//
+//
+// Return the direction to move from the given location. If the location
+// in the direction field is occupied, another neighbour which is one step
+// closer to the destination is taken if there is one.
+//
+int FlowField::get_next_loc(FlowFieldInfo* fieldPtr, int xLoc, int yLoc, int checkUnit)
+{
+	int bestDir = fieldPtr->dir_matrix[yLoc*MAX_WORLD_X_LOC+xLoc];
+
+	err_when( bestDir==FLOW_DIR_NONE );
+
+	if( !checkUnit || world.get_loc(xLoc+flow_x_offset[bestDir], yLoc+flow_y_offset[bestDir])->can_move(UNIT_LAND) )
+		return bestDir;
+
+	int nextDist = fieldPtr->dist_matrix[yLoc*MAX_WORLD_X_LOC+xLoc] - 1;
+
+	for( int dir=0 ; dir<8 ; dir++ )
+	{
+		int nextXLoc = xLoc + flow_x_offset[dir];
+		int nextYLoc = yLoc + flow_y_offset[dir];
+
+		if( dir==bestDir || nextXLoc<0 || nextXLoc>=MAX_WORLD_X_LOC || nextYLoc<0 || nextYLoc>=MAX_WORLD_Y_LOC )
+			continue;
+
+		if( fieldPtr->dist_matrix[nextYLoc*MAX_WORLD_X_LOC+nextXLoc] != nextDist )
+			continue;
+
+		if( (dir & 1) && (!is_passable(fieldPtr, nextXLoc, yLoc) || !is_passable(fieldPtr, xLoc, nextYLoc)) )
+			continue;
+
+		if( world.get_loc(nextXLoc, nextYLoc)->can_move(UNIT_LAND) )
+			return dir;
+	}
+
+	return bestDir;
+}
+//--------- End of function FlowField::get_next_loc ---------//
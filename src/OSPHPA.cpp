@@ -0,0 +1,812 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPHPA.CPP
+//Description : Object SeekPathHPA, the cluster layer of hierarchical path seeking
+
+#include <stdlib.h>
+#include <string.h>
+#include <ALL.h>
+#include <OWORLD.h>
+#include <OUNIT.h>
+#include <OPROFILE.h>
+#include <OSPHPA.h>
+
+//----------- Define static functions -----------//
+
+static int  loc_distance(int x1, int y1, int x2, int y2);
+static int  is_same_border(HpaBorder* border1, HpaBorder* border2);
+
+//-------- Begin of function SeekPathHPA::SeekPathHPA --------//
+
+SeekPathHPA::SeekPathHPA()
+{
+	memset( this, 0, sizeof(SeekPathHPA) );
+}
+//--------- End of function SeekPathHPA::SeekPathHPA ---------//
+
+
+//-------- Begin of function SeekPathHPA::~SeekPathHPA --------//
+
+SeekPathHPA::~SeekPathHPA()
+{
+	deinit();
+}
+//--------- End of function SeekPathHPA::~SeekPathHPA ---------//
+
+
+//-------- Begin of function SeekPathHPA::init --------//
+//
+// Allocate the clusters for the current map size and mark them all
+// dirty. It is called whenever a map has been generated or loaded.
+// The clusters are built when they are first used.
+//
+void SeekPathHPA::init()
+{
+	deinit();
+
+	cluster_x_count = (MAX_WORLD_X_LOC+HPA_CLUSTER_SIZE-1) / HPA_CLUSTER_SIZE;
+	cluster_y_count = (MAX_WORLD_Y_LOC+HPA_CLUSTER_SIZE-1) / HPA_CLUSTER_SIZE;
+	cluster_count	 = cluster_x_count * cluster_y_count;
+
+	for( int layer=0 ; layer<HPA_LAYER_COUNT ; layer++ )
+	{
+		cluster_array[layer] = (HpaCluster*) mem_add( sizeof(HpaCluster) * cluster_count );
+		east_border_array[layer] = (HpaBorder*) mem_add( sizeof(HpaBorder) * cluster_count );
+		south_border_array[layer] = (HpaBorder*) mem_add( sizeof(HpaBorder) * cluster_count );
+
+		memset( cluster_array[layer], 0, sizeof(HpaCluster) * cluster_count );
+		memset( east_border_array[layer], 0, sizeof(HpaBorder) * cluster_count );
+		memset( south_border_array[layer], 0, sizeof(HpaBorder) * cluster_count );
+
+		for( int i=0 ; i<cluster_count ; i++ )
+			cluster_array[layer][i].dirty_flag = HPA_DIRTY_TERRAIN;
+
+		layer_dirty_flag[layer] = 1;
+	}
+
+	//------ allocate the buffers for searching the cluster graph ------//
+
+	node_count = cluster_count * MAX_CLUSTER_ENTRANCE + 1;		// the last one is the goal node
+
+	node_g_array		= (int*) mem_add( sizeof(int) * node_count );
+	node_parent_array = (int*) mem_add( sizeof(int) * node_count );
+	node_stamp_array	= (uint32_t*) mem_add( sizeof(uint32_t) * node_count );
+	path_node_array	= (int*) mem_add( sizeof(int) * node_count );
+
+	memset( node_stamp_array, 0, sizeof(uint32_t) * node_count );
+	cur_stamp = 0;
+
+	open_heap_max = node_count * 4;
+	open_heap	  = (HpaOpenNode*) mem_add( sizeof(HpaOpenNode) * (open_heap_max+1) );
+	open_heap_size = 0;
+}
+//--------- End of function SeekPathHPA::init ---------//
+
+
+//-------- Begin of function SeekPathHPA::deinit --------//
+
+void SeekPathHPA::deinit()
+{
+	for( int layer=0 ; layer<HPA_LAYER_COUNT ; layer++ )
+	{
+		if( cluster_array[layer] )
+		{
+			mem_del( cluster_array[layer] );
+			mem_del( east_border_array[layer] );
+			mem_del( south_border_array[layer] );
+
+			cluster_array[layer] = NULL;
+			east_border_array[layer] = NULL;
+			south_border_array[layer] = NULL;
+		}
+	}
+
+	if( node_g_array )
+	{
+		mem_del( node_g_array );
+		mem_del( node_parent_array );
+		mem_del( node_stamp_array );
+		mem_del( path_node_array );
+		mem_del( open_heap );
+
+		node_g_array = NULL;
+		node_parent_array = NULL;
+		node_stamp_array = NULL;
+		path_node_array = NULL;
+		open_heap = NULL;
+	}
+
+	cluster_count = 0;
+}
+//--------- End of function SeekPathHPA::deinit ---------//
+
+
+//-------- Begin of function SeekPathHPA::invalidate_loc --------//
+//
+// The walkability of the given location has changed, the cluster it is
+// in will be rebuilt before it is used again.
+//
+void SeekPathHPA::invalidate_loc(int xLoc, int yLoc)
+{
+	if( !cluster_array[0] )
+		return;
+
+	int clusterX = xLoc / HPA_CLUSTER_SIZE;
+	int clusterY = yLoc / HPA_CLUSTER_SIZE;
+
+	if( clusterX >= cluster_x_count || clusterY >= cluster_y_count )
+		return;
+
+	int clusterId = clusterY * cluster_x_count + clusterX;
+
+	for( int layer=0 ; layer<HPA_LAYER_COUNT ; layer++ )
+	{
+		cluster_array[layer][clusterId].dirty_flag = HPA_DIRTY_TERRAIN;
+		layer_dirty_flag[layer] = 1;
+	}
+}
+//--------- End of function SeekPathHPA::invalidate_loc ---------//
+
+
+//-------- Begin of function SeekPathHPA::get_way_point --------//
+//
+// Find a path on the cluster graph and return the location SeekPath
+// should search to first.
+//
+// <int>  sx, sy		  - the starting location
+// <int>  dx, dy		  - the destination
+// <char> mobileType   - UNIT_LAND or UNIT_SEA
+// <int&> wayXLoc, wayYLoc - for returning the way point
+//
+// return : <int> 1 - a way point is returned
+//                0 - the destination is near or it cannot be reached on the
+//                    cluster graph, search to the destination directly
+//
+int SeekPathHPA::get_way_point(int sx, int sy, int dx, int dy, char mobileType, int& wayXLoc, int& wayYLoc)
+{
+	int layer;
+
+	switch( mobileType )
+	{
+		case UNIT_LAND:
+			layer = HPA_LAYER_LAND;
+			break;
+
+		case UNIT_SEA:
+			layer = HPA_LAYER_SEA;
+			break;
+
+		default:
+			return 0;
+	}
+
+	if( !cluster_array[layer] || loc_distance(sx, sy, dx, dy) <= HPA_MIN_SEEK_DIST )
+		return 0;
+
+	PROFILE_SCOPE("SeekPathHPA::get_way_point");
+
+	update_layer(layer);
+
+	int startClusterId = get_cluster_id(sx, sy);
+	int goalClusterId  = get_cluster_id(dx, dy);
+
+	if( startClusterId == goalClusterId )
+		return 0;
+
+	cal_entrance_dist(layer, startClusterId, sx, sy, start_dist_array);
+	cal_entrance_dist(layer, goalClusterId, dx, dy, goal_dist_array);
+
+	int pathCount = search_graph(layer, startClusterId, goalClusterId, dx, dy);
+
+	if( !pathCount )
+		return 0;
+
+	//---- the way point is the last entrance on the path within HPA_WAY_POINT_DIST of the start ----//
+
+	HpaCluster*  clusterArray = cluster_array[layer];
+	HpaEntrance* wayPointPtr = NULL;
+
+	for( int i=0 ; i<pathCount ; i++ )
+	{
+		int nodeId = path_node_array[i];
+		HpaEntrance* entrancePtr = clusterArray[nodeId/MAX_CLUSTER_ENTRANCE].entrance_array + nodeId%MAX_CLUSTER_ENTRANCE;
+
+		if( wayPointPtr && loc_distance(sx, sy, entrancePtr->x_loc, entrancePtr->y_loc) > HPA_WAY_POINT_DIST )
+			break;
+
+		wayPointPtr = entrancePtr;
+	}
+
+	if( wayPointPtr->x_loc==sx && wayPointPtr->y_loc==sy )
+		return 0;
+
+	wayXLoc = wayPointPtr->x_loc;
+	wayYLoc = wayPointPtr->y_loc;
+
+	return 1;
+}
+//--------- End of function SeekPathHPA::get_way_point ---------//
+
+
+//-------- Begin of function SeekPathHPA::update_layer --------//
+//
+// Rebuild the dirty clusters of a layer. The borders of a cluster whose
+// terrain has changed are scanned again, and a neighbor cluster is only
+// rebuilt if their shared border has changed.
+//
+void SeekPathHPA::update_layer(int layer)
+{
+	if( !layer_dirty_flag[layer] )
+		return;
+
+	PROFILE_SCOPE("SeekPathHPA::update_layer");
+
+	HpaCluster* clusterArray = cluster_array[layer];
+	HpaBorder	newBorder;
+	HpaBorder*	borderPtr;
+	int			clusterId, clusterX, clusterY, i;
+	int			borderClusterId, borderDir, neighborClusterId;
+
+	for( clusterId=0 ; clusterId<cluster_count ; clusterId++ )
+	{
+		if( clusterArray[clusterId].dirty_flag != HPA_DIRTY_TERRAIN )
+			continue;
+
+		clusterX = clusterId % cluster_x_count;
+		clusterY = clusterId / cluster_x_count;
+
+		//------ west, north, east and south borders ------//
+
+		for( i=0 ; i<4 ; i++ )
+		{
+			switch(i)
+			{
+				case 0:
+					if( clusterX==0 )
+						continue;
+					borderClusterId = neighborClusterId = clusterId-1;
+					borderDir = HPA_BORDER_EAST;
+					break;
+
+				case 1:
+					if( clusterY==0 )
+						continue;
+					borderClusterId = neighborClusterId = clusterId-cluster_x_count;
+					borderDir = HPA_BORDER_SOUTH;
+					break;
+
+				case 2:
+					if( clusterX==cluster_x_count-1 )
+						continue;
+					borderClusterId = clusterId;
+					neighborClusterId = clusterId+1;
+					borderDir = HPA_BORDER_EAST;
+					break;
+
+				default:
+					if( clusterY==cluster_y_count-1 )
+						continue;
+					borderClusterId = clusterId;
+					neighborClusterId = clusterId+cluster_x_count;
+					borderDir = HPA_BORDER_SOUTH;
+					break;
+			}
+
+			scan_border(layer, borderClusterId, borderDir, &newBorder);
+
+			if( borderDir==HPA_BORDER_EAST )
+				borderPtr = east_border_array[layer] + borderClusterId;
+			else
+				borderPtr = south_border_array[layer] + borderClusterId;
+
+			if( !is_same_border(borderPtr, &newBorder) )
+			{
+				*borderPtr = newBorder;
+
+				if( clusterArray[neighborClusterId].dirty_flag == HPA_CLEAN )
+					clusterArray[neighborClusterId].dirty_flag = HPA_DIRTY_ENTRANCE;
+			}
+		}
+	}
+
+	//------ rebuild the entrances and distances of the dirty clusters ------//
+
+	for( clusterId=0 ; clusterId<cluster_count ; clusterId++ )
+	{
+		if( clusterArray[clusterId].dirty_flag != HPA_CLEAN )
+		{
+			build_cluster(layer, clusterId);
+			clusterArray[clusterId].dirty_flag = HPA_CLEAN;
+		}
+	}
+
+	layer_dirty_flag[layer] = 0;
+}
+//--------- End of function SeekPathHPA::update_layer ---------//
+
+
+//-------- Begin of function SeekPathHPA::scan_border --------//
+//
+// Find the transitions on the east or south border of a cluster. Each
+// run of locations passable on both sides of the border gets one
+// transition in its middle, or one at each end if it is long.
+//
+// <int>        layer			 - HPA_LAYER_LAND or HPA_LAYER_SEA
+// <int>        clusterId		 - the west or north cluster of the border
+// <int>        borderDir		 - HPA_BORDER_EAST or HPA_BORDER_SOUTH
+// <HpaBorder*> borderPtr		 - for returning the transitions
+//
+void SeekPathHPA::scan_border(int layer, int clusterId, int borderDir, HpaBorder* borderPtr)
+{
+	int teraMask = layer==HPA_LAYER_LAND ? LOCATE_WALK_LAND : LOCATE_WALK_SEA;
+	int clusterX = clusterId % cluster_x_count;
+	int clusterY = clusterId / cluster_x_count;
+	int xLoc, yLoc, stepX, stepY, crossX, crossY, borderLen;
+
+	if( borderDir==HPA_BORDER_EAST )
+	{
+		xLoc = clusterX*HPA_CLUSTER_SIZE + HPA_CLUSTER_SIZE-1;
+		yLoc = clusterY*HPA_CLUSTER_SIZE;
+		borderLen = MIN(HPA_CLUSTER_SIZE, MAX_WORLD_Y_LOC-yLoc);
+		stepX = 0;
+		stepY = 1;
+		crossX = 1;
+		crossY = 0;
+	}
+	else
+	{
+		xLoc = clusterX*HPA_CLUSTER_SIZE;
+		yLoc = clusterY*HPA_CLUSTER_SIZE + HPA_CLUSTER_SIZE-1;
+		borderLen = MIN(HPA_CLUSTER_SIZE, MAX_WORLD_X_LOC-xLoc);
+		stepX = 1;
+		stepY = 0;
+		crossX = 0;
+		crossY = 1;
+	}
+
+	memset( borderPtr, 0, sizeof(HpaBorder) );
+
+	int runStart = -1;
+
+	for( int i=0 ; i<=borderLen ; i++ )
+	{
+		int x = xLoc + stepX*i;
+		int y = yLoc + stepY*i;
+
+		if( i<borderLen && world.get_loc(x, y)->walkable(teraMask) &&
+			 world.get_loc(x+crossX, y+crossY)->walkable(teraMask) )
+		{
+			if( runStart < 0 )
+				runStart = i;
+
+			continue;
+		}
+
+		if( runStart < 0 )
+			continue;
+
+		//------- add the transitions of the run -------//
+
+		int runLen = i-runStart;
+		int posArray[2], posCount;
+
+		if( runLen >= HPA_LONG_TRANSITION )
+		{
+			posArray[0] = runStart;
+			posArray[1] = i-1;
+			posCount = 2;
+		}
+		else
+		{
+			posArray[0] = runStart + runLen/2;
+			posCount = 1;
+		}
+
+		for( int j=0 ; j<posCount && borderPtr->transition_count<MAX_BORDER_TRANSITION ; j++ )
+		{
+			HpaTransition* transitionPtr = borderPtr->transition_array + borderPtr->transition_count++;
+
+			transitionPtr->x_loc1 = xLoc + stepX*posArray[j];
+			transitionPtr->y_loc1 = yLoc + stepY*posArray[j];
+			transitionPtr->x_loc2 = transitionPtr->x_loc1 + crossX;
+			transitionPtr->y_loc2 = transitionPtr->y_loc1 + crossY;
+		}
+
+		runStart = -1;
+	}
+}
+//--------- End of function SeekPathHPA::scan_border ---------//
+
+
+//-------- Begin of function SeekPathHPA::build_cluster --------//
+//
+// Collect the entrances of a cluster from its four borders and calculate
+// the distances between them.
+//
+void SeekPathHPA::build_cluster(int layer, int clusterId)
+{
+	HpaCluster* clusterPtr = cluster_array[layer] + clusterId;
+	int clusterX = clusterId % cluster_x_count;
+	int clusterY = clusterId / cluster_x_count;
+
+	clusterPtr->entrance_count = 0;
+
+	if( clusterX > 0 )
+		add_entrance(clusterPtr, east_border_array[layer]+clusterId-1, clusterId-1, HPA_BORDER_EAST, 2, clusterId-1);
+
+	if( clusterY > 0 )
+		add_entrance(clusterPtr, south_border_array[layer]+clusterId-cluster_x_count, clusterId-cluster_x_count, HPA_BORDER_SOUTH, 2, clusterId-cluster_x_count);
+
+	if( clusterX < cluster_x_count-1 )
+		add_entrance(clusterPtr, east_border_array[layer]+clusterId, clusterId, HPA_BORDER_EAST, 1, clusterId+1);
+
+	if( clusterY < cluster_y_count-1 )
+		add_entrance(clusterPtr, south_border_array[layer]+clusterId, clusterId, HPA_BORDER_SOUTH, 1, clusterId+cluster_x_count);
+
+	//------ calculate the distances between the entrances ------//
+
+	for( int i=0 ; i<clusterPtr->entrance_count ; i++ )
+	{
+		HpaEntrance* entrancePtr = clusterPtr->entrance_array + i;
+
+		cal_entrance_dist(layer, clusterId, entrancePtr->x_loc, entrancePtr->y_loc, clusterPtr->dist_matrix[i]);
+	}
+}
+//--------- End of function SeekPathHPA::build_cluster ---------//
+
+
+//-------- Begin of function SeekPathHPA::add_entrance --------//
+//
+// Add an entrance to the cluster for each transition on the given border.
+//
+// <int> side - 1 if the cluster is the west or north one of the border, 2 otherwise
+//
+void SeekPathHPA::add_entrance(HpaCluster* clusterPtr, HpaBorder* borderPtr, int borderClusterId, int borderDir, int side, int neighborClusterId)
+{
+	for( int i=0 ; i<borderPtr->transition_count ; i++ )
+	{
+		err_when( clusterPtr->entrance_count >= MAX_CLUSTER_ENTRANCE );
+
+		HpaTransition* transitionPtr = borderPtr->transition_array + i;
+		HpaEntrance*	entrancePtr = clusterPtr->entrance_array + clusterPtr->entrance_count;
+
+		if( side==1 )
+		{
+			entrancePtr->x_loc = transitionPtr->x_loc1;
+			entrancePtr->y_loc = transitionPtr->y_loc1;
+			transitionPtr->entrance1 = clusterPtr->entrance_count;
+		}
+		else
+		{
+			entrancePtr->x_loc = transitionPtr->x_loc2;
+			entrancePtr->y_loc = transitionPtr->y_loc2;
+			transitionPtr->entrance2 = clusterPtr->entrance_count;
+		}
+
+		entrancePtr->border_cluster_id	= borderClusterId;
+		entrancePtr->border_dir			= borderDir;
+		entrancePtr->transition_id		= i;
+		entrancePtr->side					= side;
+		entrancePtr->neighbor_cluster_id = neighborClusterId;
+
+		clusterPtr->entrance_count++;
+	}
+}
+//--------- End of function SeekPathHPA::add_entrance ---------//
+
+
+//-------- Begin of function SeekPathHPA::cal_loc_dist --------//
+//
+// Breadth-first search from the given location, within the cluster, and
+// store the no. of steps to each location of the cluster in loc_dist_array[].
+// The given location itself doesn't need to be passable, so that it can
+// be a building.
+//
+void SeekPathHPA::cal_loc_dist(int layer, int clusterId, int xLoc, int yLoc)
+{
+	static const int dirX[8] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+	static const int dirY[8] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+
+	int teraMask = layer==HPA_LAYER_LAND ? LOCATE_WALK_LAND : LOCATE_WALK_SEA;
+	int clusterX1 = (clusterId % cluster_x_count) * HPA_CLUSTER_SIZE;
+	int clusterY1 = (clusterId / cluster_x_count) * HPA_CLUSTER_SIZE;
+	int width  = MIN(HPA_CLUSTER_SIZE, MAX_WORLD_X_LOC-clusterX1);
+	int height = MIN(HPA_CLUSTER_SIZE, MAX_WORLD_Y_LOC-clusterY1);
+
+	memset( loc_dist_array, HPA_UNREACHABLE, sizeof(loc_dist_array) );
+
+	int startIndex = (yLoc-clusterY1)*HPA_CLUSTER_SIZE + (xLoc-clusterX1);
+	int queueHead=0, queueTail=0;
+
+	loc_dist_array[startIndex] = 0;
+	loc_queue_array[queueTail++] = startIndex;
+
+	while( queueHead < queueTail )
+	{
+		int index = loc_queue_array[queueHead++];
+		int x = index % HPA_CLUSTER_SIZE;
+		int y = index / HPA_CLUSTER_SIZE;
+		int nextDist = MIN(loc_dist_array[index]+1, HPA_UNREACHABLE-1);
+
+		for( int dir=0 ; dir<8 ; dir++ )
+		{
+			int nextX = x + dirX[dir];
+			int nextY = y + dirY[dir];
+
+			if( nextX<0 || nextX>=width || nextY<0 || nextY>=height )
+				continue;
+
+			int nextIndex = nextY*HPA_CLUSTER_SIZE + nextX;
+
+			if( loc_dist_array[nextIndex] != HPA_UNREACHABLE ||
+				 !world.get_loc(clusterX1+nextX, clusterY1+nextY)->walkable(teraMask) )
+			{
+				continue;
+			}
+
+			loc_dist_array[nextIndex] = nextDist;
+			loc_queue_array[queueTail++] = nextIndex;
+		}
+	}
+}
+//--------- End of function SeekPathHPA::cal_loc_dist ---------//
+
+
+//-------- Begin of function SeekPathHPA::cal_entrance_dist --------//
+//
+// Calculate the no. of steps from the given location to each entrance
+// of the cluster.
+//
+void SeekPathHPA::cal_entrance_dist(int layer, int clusterId, int xLoc, int yLoc, uint8_t* distArray)
+{
+	HpaCluster* clusterPtr = cluster_array[layer] + clusterId;
+
+	cal_loc_dist(layer, clusterId, xLoc, yLoc);
+
+	int clusterX1 = (clusterId % cluster_x_count) * HPA_CLUSTER_SIZE;
+	int clusterY1 = (clusterId / cluster_x_count) * HPA_CLUSTER_SIZE;
+
+	for( int i=0 ; i<clusterPtr->entrance_count ; i++ )
+	{
+		HpaEntrance* entrancePtr = clusterPtr->entrance_array + i;
+
+		distArray[i] = loc_dist_array[ (entrancePtr->y_loc-clusterY1)*HPA_CLUSTER_SIZE + (entrancePtr->x_loc-clusterX1) ];
+	}
+}
+//--------- End of function SeekPathHPA::cal_entrance_dist ---------//
+
+
+//-------- Begin of function SeekPathHPA::search_graph --------//
+//
+// A* search on the entrance graph, from the entrances of the start cluster
+// reachable from the start location to a goal node connected to the
+// entrances of the goal cluster which can reach the destination.
+//
+// return : <int> the no. of entrances on the path stored in path_node_array[],
+//                0 if no path is found
+//
+int SeekPathHPA::search_graph(int layer, int startClusterId, int goalClusterId, int dx, int dy)
+{
+	HpaCluster* clusterArray = cluster_array[layer];
+	int goalNodeId = node_count-1;
+	int i;
+
+	//----- a new stamp marks all nodes as unvisited -----//
+
+	if( cur_stamp >= 0xFFFFFFF0 )
+	{
+		memset( node_stamp_array, 0, sizeof(uint32_t) * node_count );
+		cur_stamp = 0;
+	}
+
+	cur_stamp += 2;
+	open_heap_size = 0;
+
+	//----- open the entrances of the start cluster ------//
+
+	HpaCluster* clusterPtr = clusterArray + startClusterId;
+
+	for( i=0 ; i<clusterPtr->entrance_count ; i++ )
+	{
+		if( start_dist_array[i] == HPA_UNREACHABLE )
+			continue;
+
+		HpaEntrance* entrancePtr = clusterPtr->entrance_array + i;
+
+		open_node( startClusterId*MAX_CLUSTER_ENTRANCE+i, start_dist_array[i], -1,
+			loc_distance(entrancePtr->x_loc, entrancePtr->y_loc, dx, dy) );
+	}
+
+	//------------ search the graph -------------//
+
+	while( open_heap_size > 0 )
+	{
+		//------- take the top node off the heap --------//
+
+		int nodeId = open_heap[1].node_id;
+		HpaOpenNode lastNode = open_heap[open_heap_size--];
+		int parent=1, child;
+
+		while( (child=parent*2) <= open_heap_size )
+		{
+			if( child < open_heap_size && open_heap[child+1].node_f < open_heap[child].node_f )
+				child++;
+
+			if( lastNode.node_f <= open_heap[child].node_f )
+				break;
+
+			open_heap[parent] = open_heap[child];
+			parent = child;
+		}
+
+		open_heap[parent] = lastNode;
+
+		if( node_stamp_array[nodeId] == cur_stamp+1 )		// already closed by a shorter path
+			continue;
+
+		node_stamp_array[nodeId] = cur_stamp+1;
+
+		//------- the goal is reached, trace back the path -------//
+
+		if( nodeId == goalNodeId )
+		{
+			int pathCount=0;
+
+			for( int pathNodeId=node_parent_array[goalNodeId] ; pathNodeId>=0 ; pathNodeId=node_parent_array[pathNodeId] )
+				path_node_array[pathCount++] = pathNodeId;
+
+			for( i=0 ; i<pathCount/2 ; i++ )
+			{
+				int tempId = path_node_array[i];
+				path_node_array[i] = path_node_array[pathCount-1-i];
+				path_node_array[pathCount-1-i] = tempId;
+			}
+
+			return pathCount;
+		}
+
+		//------- expand the entrance --------//
+
+		int clusterId  = nodeId / MAX_CLUSTER_ENTRANCE;
+		int entranceId = nodeId % MAX_CLUSTER_ENTRANCE;
+		int nodeG		= node_g_array[nodeId];
+
+		clusterPtr = clusterArray + clusterId;
+
+		if( clusterId==goalClusterId && goal_dist_array[entranceId] != HPA_UNREACHABLE )
+			open_node( goalNodeId, nodeG+goal_dist_array[entranceId], nodeId, 0 );
+
+		//--- the other entrances of the same cluster ---//
+
+		uint8_t* distArray = clusterPtr->dist_matrix[entranceId];
+
+		for( i=0 ; i<clusterPtr->entrance_count ; i++ )
+		{
+			if( i==entranceId || distArray[i]==HPA_UNREACHABLE )
+				continue;
+
+			HpaEntrance* entrancePtr = clusterPtr->entrance_array + i;
+
+			open_node( clusterId*MAX_CLUSTER_ENTRANCE+i, nodeG+distArray[i], nodeId,
+				loc_distance(entrancePtr->x_loc, entrancePtr->y_loc, dx, dy) );
+		}
+
+		//--- the entrance on the other side of the border ---//
+
+		HpaEntrance* entrancePtr = clusterPtr->entrance_array + entranceId;
+		HpaBorder*	 borderPtr;
+
+		if( entrancePtr->border_dir==HPA_BORDER_EAST )
+			borderPtr = east_border_array[layer] + entrancePtr->border_cluster_id;
+		else
+			borderPtr = south_border_array[layer] + entrancePtr->border_cluster_id;
+
+		HpaTransition* transitionPtr = borderPtr->transition_array + entrancePtr->transition_id;
+		int partnerId = entrancePtr->side==1 ? transitionPtr->entrance2 : transitionPtr->entrance1;
+		HpaEntrance* partnerPtr = clusterArray[entrancePtr->neighbor_cluster_id].entrance_array + partnerId;
+
+		open_node( entrancePtr->neighbor_cluster_id*MAX_CLUSTER_ENTRANCE+partnerId, nodeG+1, nodeId,
+			loc_distance(partnerPtr->x_loc, partnerPtr->y_loc, dx, dy) );
+	}
+
+	return 0;
+}
+//--------- End of function SeekPathHPA::search_graph ---------//
+
+
+//-------- Begin of function SeekPathHPA::open_node --------//
+//
+// Add a node to the open heap if it is not visited yet or a shorter path
+// to it is found. A node may be on the heap more than once, the entries
+// of a closed node are skipped when they are taken off.
+//
+void SeekPathHPA::open_node(int nodeId, int nodeG, int parentId, int nodeH)
+{
+	uint32_t nodeStamp = node_stamp_array[nodeId];
+
+	if( nodeStamp == cur_stamp+1 ||
+		 (nodeStamp == cur_stamp && node_g_array[nodeId] <= nodeG) )
+	{
+		return;
+	}
+
+	if( open_heap_size >= open_heap_max )		// the heap is full, the search may fail and the unit will search to the destination directly
+		return;
+
+	node_stamp_array[nodeId]  = cur_stamp;
+	node_g_array[nodeId]		  = nodeG;
+	node_parent_array[nodeId] = parentId;
+
+	//------- add it to the heap ---------//
+
+	int nodeF = nodeG + nodeH;
+	int i = ++open_heap_size;
+
+	while( i>1 && open_heap[i/2].node_f > nodeF )
+	{
+		open_heap[i] = open_heap[i/2];
+		i /= 2;
+	}
+
+	open_heap[i].node_f  = nodeF;
+	open_heap[i].node_id = nodeId;
+}
+//--------- End of function SeekPathHPA::open_node ---------//
+
+
+//------- Begin of static function loc_distance ------//
+//
+// The no. of steps between two locations when moving in eight directions.
+//
+static int loc_distance(int x1, int y1, int x2, int y2)
+{
+	int xDist = abs(x1-x2);
+	int yDist = abs(y1-y2);
+
+	return xDist > yDist ? xDist : yDist;
+}
+//-------- End of static function loc_distance ------//
+
+
+//------- Begin of static function is_same_border ------//
+//
+// Whether two scans of a border have the same transitions.
+//
+static int is_same_border(HpaBorder* border1, HpaBorder* border2)
+{
+	if( border1->transition_count != border2->transition_count )
+		return 0;
+
+	for( int i=0 ; i<border1->transition_count ; i++ )
+	{
+		HpaTransition* transition1 = border1->transition_array + i;
+		HpaTransition* transition2 = border2->transition_array + i;
+
+		if( transition1->x_loc1 != transition2->x_loc1 || transition1->y_loc1 != transition2->y_loc1 ||
+			 transition1->x_loc2 != transition2->x_loc2 || transition1->y_loc2 != transition2->y_loc2 )
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+//-------- End of static function is_same_border ------//
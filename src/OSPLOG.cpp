@@ -0,0 +1,316 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPLOG.CPP
+//Description : Object SeekPathLog, recording and replaying path seeking queries
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ALL.h>
+#include <OSYS.h>
+#include <OSPATH.h>
+#include <OPROFILE.h>
+#include <OSPLOG.h>
+
+//-------- Begin of function SeekPathLog::SeekPathLog --------//
+
+SeekPathLog::SeekPathLog()
+{
+	record_file = NULL;
+}
+//--------- End of function SeekPathLog::SeekPathLog ---------//
+
+
+//-------- Begin of function SeekPathLog::~SeekPathLog --------//
+
+SeekPathLog::~SeekPathLog()
+{
+	close();
+}
+//--------- End of function SeekPathLog::~SeekPathLog ---------//
+
+
+//-------- Begin of function SeekPathLog::open --------//
+//
+// Start recording the searches to the given file.
+//
+// return : <int> 1 - the file has been created
+//                0 - the file could not be created
+//
+int SeekPathLog::open(const char* filePath)
+{
+	close();
+
+	record_file = fopen(filePath, "w");
+
+	if( !record_file )
+		return 0;
+
+	fprintf( record_file, "# 7KPATHLOG %d\n", SEEK_PATH_LOG_VERSION );
+	fprintf( record_file, "# frame sx sy dx dy group mobile_type search_mode misc_no num_of_path max_tries attack_range sub_mode nation_passable\n" );
+
+	return 1;
+}
+//--------- End of function SeekPathLog::open ---------//
+
+
+//-------- Begin of function SeekPathLog::close --------//
+
+void SeekPathLog::close()
+{
+	if( record_file )
+	{
+		fclose(record_file);
+		record_file = NULL;
+	}
+}
+//--------- End of function SeekPathLog::close ---------//
+
+
+//-------- Begin of function SeekPathLog::record --------//
+//
+// Write a search to the log. The parameters are the same as those
+// passed to SeekPath::seek(). The sub mode, the passable nations and the
+// attack range set in seek_path are recorded with them.
+//
+void SeekPathLog::record(int sx, int sy, int dx, int dy, uint32_t groupId, char mobileType,
+								 short searchMode, short miscNo, short numOfPath, int maxTries)
+{
+	if( !record_file )
+		return;
+
+	char* nationPassable = seek_path.get_nation_passable();
+	char  passableStr[MAX_NATION+1];
+
+	for( int i=1 ; i<=MAX_NATION ; i++ )
+		passableStr[i-1] = nationPassable[i] ? '1' : '0';
+
+	passableStr[MAX_NATION] = '\0';
+
+	fprintf( record_file, "%u %d %d %d %d %u %d %d %d %d %d %d %d %s\n",
+		sys.frame_count, sx, sy, dx, dy, groupId, mobileType, searchMode, miscNo, numOfPath,
+		maxTries, seek_path.get_attack_range_para(), seek_path.get_sub_mode(), passableStr );
+}
+//--------- End of function SeekPathLog::record ---------//
+
+
+//-------- Begin of function SeekPathLog::read_query --------//
+//
+// Read the next query from the log, skipping comment lines.
+//
+// return : <int> 1 - a query has been read
+//                0 - the end of the log has been reached
+//
+int SeekPathLog::read_query(FILE* filePtr, SeekPathQuery* queryPtr)
+{
+	char lineStr[256];
+
+	while( fgets(lineStr, sizeof(lineStr), filePtr) )
+	{
+		if( lineStr[0]=='#' )
+			continue;
+
+		int  sx, sy, dx, dy, mobileType, searchMode, miscNo, numOfPath, subMode;
+		char passableStr[32];
+
+		if( sscanf( lineStr, "%u %d %d %d %d %u %d %d %d %d %d %d %d %31s",
+				&queryPtr->frame_count, &sx, &sy, &dx, &dy, &queryPtr->group_id, &mobileType, &searchMode,
+				&miscNo, &numOfPath, &queryPtr->max_tries, &queryPtr->attack_range, &subMode, passableStr ) != 14 )
+		{
+			continue;
+		}
+
+		if( sx<0 || sx>=MAX_WORLD_X_LOC || sy<0 || sy>=MAX_WORLD_Y_LOC ||
+			 dx<0 || dx>=MAX_WORLD_X_LOC || dy<0 || dy>=MAX_WORLD_Y_LOC ||
+			 searchMode<SEARCH_MODE_IN_A_GROUP || searchMode>MAX_SEARCH_MODE_TYPE )
+		{
+			continue;
+		}
+
+		queryPtr->sour_x_loc  = sx;
+		queryPtr->sour_y_loc  = sy;
+		queryPtr->dest_x_loc  = dx;
+		queryPtr->dest_y_loc  = dy;
+		queryPtr->mobile_type = mobileType;
+		queryPtr->search_mode = searchMode;
+		queryPtr->misc_no		 = miscNo;
+		queryPtr->num_of_path = numOfPath;
+		queryPtr->sub_mode	 = subMode;
+
+		memset( queryPtr->nation_passable, 0, sizeof(queryPtr->nation_passable) );
+
+		for( int i=0 ; i<MAX_NATION && passableStr[i] ; i++ )
+			queryPtr->nation_passable[i+1] = passableStr[i]=='1';
+
+		return 1;
+	}
+
+	return 0;
+}
+//--------- End of function SeekPathLog::read_query ---------//
+
+
+//-------- Begin of function SeekPathLog::compare_time --------//
+
+int SeekPathLog::compare_time(const void* a, const void* b)
+{
+	uint64_t timeA = *(const uint64_t*) a;
+	uint64_t timeB = *(const uint64_t*) b;
+
+	return timeA < timeB ? -1 : (timeA > timeB ? 1 : 0);
+}
+//--------- End of function SeekPathLog::compare_time ---------//
+
+
+//-------- Begin of function SeekPathLog::replay --------//
+//
+// Run all the searches in the given log against the current world and
+// print the no. of nodes expanded, the latency percentiles and the
+// success rate. The game the log was recorded from must be loaded first.
+//
+// Each search is given the full node budget of a frame and is never
+// suspended, so that the results don't depend on the order of the
+// searches.
+//
+// return : <int> 1 - the log has been replayed
+//                0 - the log could not be read
+//
+int SeekPathLog::replay(const char* filePath)
+{
+	FILE* filePtr = fopen(filePath, "r");
+
+	if( !filePtr )
+		return 0;
+
+	int		 queryCount=0, timeArraySize=1024;
+	uint64_t* timeArray = (uint64_t*) mem_add( sizeof(uint64_t) * timeArraySize );
+	uint64_t  totalTime=0, totalNode=0;
+	int		 maxNode=0, foundCount=0;
+	int		 resultCount[PATH_REUSE_FOUND+1];
+	int		 modeQueryCount[SEARCH_MODE_LAST], modeFoundCount[SEARCH_MODE_LAST];
+	uint64_t  modeNodeCount[SEARCH_MODE_LAST];
+
+	memset( resultCount, 0, sizeof(resultCount) );
+	memset( modeQueryCount, 0, sizeof(modeQueryCount) );
+	memset( modeFoundCount, 0, sizeof(modeFoundCount) );
+	memset( modeNodeCount, 0, sizeof(modeNodeCount) );
+
+	SeekPathQuery query;
+
+	while( read_query(filePtr, &query) )
+	{
+		seek_path.reset_total_node_avail();
+		seek_path.set_resume_owner();
+		seek_path.set_sub_mode(query.sub_mode);
+		seek_path.set_nation_passable(query.nation_passable+1);
+
+		if( query.attack_range )
+			seek_path.set_attack_range_para(query.attack_range);
+
+		uint64_t startTime = Profiler::get_counter();
+
+		int seekResult = seek_path.seek(query.sour_x_loc, query.sour_y_loc, query.dest_x_loc, query.dest_y_loc,
+									query.group_id, query.mobile_type, query.search_mode, query.misc_no, query.num_of_path, query.max_tries);
+
+		int resultNodeCount;
+		short pathDist;
+		ResultNode* resultNodeArray = seek_path.get_result(resultNodeCount, pathDist);
+
+		uint64_t seekTime = Profiler::get_counter() - startTime;
+
+		if( resultNodeArray )
+			mem_del(resultNodeArray);
+
+		seek_path.reset_attack_range_para();
+		seek_path.set_sub_mode();
+
+		//---------- update statistics ----------//
+
+		if( queryCount == timeArraySize )
+		{
+			timeArraySize *= 2;
+			timeArray = (uint64_t*) mem_resize( timeArray, sizeof(uint64_t) * timeArraySize );
+		}
+
+		timeArray[queryCount++] = seekTime;
+		totalTime += seekTime;
+
+		int nodeUsed = seek_path.current_search_node_used;
+
+		totalNode += nodeUsed;
+		maxNode = MAX(maxNode, nodeUsed);
+
+		if( seekResult>=0 && seekResult<=PATH_REUSE_FOUND )
+			resultCount[seekResult]++;
+
+		modeQueryCount[query.search_mode]++;
+		modeNodeCount[query.search_mode] += nodeUsed;
+
+		if( seekResult==PATH_FOUND )
+		{
+			foundCount++;
+			modeFoundCount[query.search_mode]++;
+		}
+	}
+
+	fclose(filePtr);
+
+	//------------ print the report -------------//
+
+	double usPerTick = 1000000.0 / (double) Profiler::get_frequency();
+
+	printf( "Path log: %s\n", filePath );
+	printf( "Queries: %d  Found: %d (%.1f%%)  Nodes used up: %d  Impossible: %d\n",
+		queryCount, foundCount, queryCount ? 100.0 * foundCount / queryCount : 0.0,
+		resultCount[PATH_NODE_USED_UP], resultCount[PATH_IMPOSSIBLE] );
+
+	if( queryCount )
+	{
+		qsort( timeArray, queryCount, sizeof(uint64_t), compare_time );
+
+		printf( "Nodes expanded: total %llu  avg %.1f  max %d\n",
+			(unsigned long long) totalNode, (double) totalNode / queryCount, maxNode );
+		printf( "Latency us: avg %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f  total %.1f\n",
+			totalTime * usPerTick / queryCount,
+			timeArray[queryCount*50/100] * usPerTick,
+			timeArray[queryCount*90/100] * usPerTick,
+			timeArray[queryCount*99/100] * usPerTick,
+			timeArray[queryCount-1] * usPerTick,
+			totalTime * usPerTick );
+
+		printf( "%-12s %10s %10s %12s\n", "Search mode", "Queries", "Found %", "Avg nodes" );
+
+		for( int i=SEARCH_MODE_IN_A_GROUP ; i<SEARCH_MODE_LAST ; i++ )
+		{
+			if( !modeQueryCount[i] )
+				continue;
+
+			printf( "%-12d %10d %10.1f %12.1f\n", i, modeQueryCount[i],
+				100.0 * modeFoundCount[i] / modeQueryCount[i], (double) modeNodeCount[i] / modeQueryCount[i] );
+		}
+	}
+
+	fflush(stdout);
+
+	mem_del(timeArray);
+	return 1;
+}
+//--------- End of function SeekPathLog::replay ---------//
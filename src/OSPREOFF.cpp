@@ -53,6 +53,34 @@ int SeekPathReuse::can_walk(int xLoc, int yLoc)
 	if(xLoc>=MAX_WORLD_X_LOC || yLoc>=MAX_WORLD_Y_LOC)
 		return 0;
 
+	//---- check the terrain and the occupancy in walk_matrix first ----//
+
+	uint8_t walkBits = *world.get_walk_bits(xLoc, yLoc);
+
+	switch(mobile_type)
+	{
+		case UNIT_LAND:
+			if(!(walkBits & WALK_MATRIX_LAND))
+				return 0;
+
+			if(!(walkBits & WALK_MATRIX_CARGO) && reuse_search_sub_mode!=SEARCH_SUB_MODE_PASSABLE)
+				return 1;
+			break;
+
+		case UNIT_SEA:
+			if(!(walkBits & WALK_MATRIX_SEA))
+				return 0;
+
+			if(!(walkBits & WALK_MATRIX_CARGO))
+				return 1;
+			break;
+
+		case UNIT_AIR:
+			if(!(walkBits & WALK_MATRIX_AIR_CARGO))
+				return 1;
+			break;
+	}
+
 	Location *locPtr = world.get_loc(xLoc, yLoc);
 	short	recno = (mobile_type!=UNIT_AIR) ? locPtr->cargo_recno : locPtr->air_cargo_recno;
 	Unit *unitPtr;
@@ -67,9 +95,6 @@ int SeekPathReuse::can_walk(int xLoc, int yLoc)
 				!reuse_nation_passable[locPtr->power_nation_recno])
 				return 0;
 
-			if(!locPtr->walkable())
-				return 0;
-			
 			if(!recno)
 				return 1;
 
@@ -88,9 +113,6 @@ int SeekPathReuse::can_walk(int xLoc, int yLoc)
 			break;
 
 		case UNIT_SEA:
-			if(!locPtr->sailable())
-				return 0;
-
 			if(!recno)
 				return 1;
 
@@ -28,6 +28,7 @@
 #include <OWORLD.h>
 #include <OUNIT.h>
 #include <OSYS.h>
+#include <OPROFILE.h>
 
 #ifdef NO_DEBUG_SEARCH
 #undef err_when
@@ -634,6 +635,8 @@ int SeekPathReuse::seek(int sx,int sy,int dx,int dy,short unitSize, uint32_t gro
 								short numOfPath, short reuseMode, short pathReuseStatus,
 								int maxTries,int borderX1, int borderY1, int borderX2, int borderY2)
 {
+	PROFILE_SCOPE("SeekPathReuse::seek");
+
 	//---------------------- error checking ---------------------//
 	err_when(numOfPath<0 || searchMode!=4 || numOfPath<1);
 	err_when(pathReuseStatus!=REUSE_PATH_INITIAL && numOfPath!=total_num_of_path);
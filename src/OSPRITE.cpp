@@ -21,6 +21,7 @@
 //Filename    : OSPRITE.CPP
 //Description : Object Sprite
 
+#include <stdlib.h>
 #include <ALL.h>
 #include <OSTR.h>
 #include <OVGA.h>
@@ -28,12 +29,14 @@
 #include <OGAME.h>
 #include <ONATION.h>
 #include <OSPRITE.h>
+#include <OSPRSPAN.h>
 #include <OCOLTBL.h>
 
 //----------- Define static class member variables -----------//
 
 short Sprite::abs_x1, Sprite::abs_y1;		// the absolute postion, taking in account of sprite offset
 short Sprite::abs_x2, Sprite::abs_y2;
+short Sprite::draw_fraction;
 
 
 //-------- Begin of function Sprite::Sprite --------//
@@ -206,6 +209,67 @@ void Sprite::update_abs_pos(SpriteFrame *spriteFrame)
 //----------- End of function Sprite::update_abs_pos -----------//
 
 
+//--------- Begin of function Sprite::get_draw_offset ---------//
+//
+// When the screen is redrawn between two frames, a moving sprite is
+// displayed part of the way to where it will be in the next frame.
+// Only the display position is offset, cur_x & cur_y are unchanged.
+//
+// <int*> offsetX, offsetY - for returning the display offset in pixels
+//
+void Sprite::get_draw_offset(int* offsetX, int* offsetY)
+{
+	*offsetX = 0;
+	*offsetY = 0;
+
+	if( !draw_fraction || cur_action != SPRITE_MOVE )
+		return;
+
+	static short vector_x_array[] = {  0,  1, 1, 1, 0, -1, -1, -1 };	// same as in Sprite::process_move()
+	static short vector_y_array[] = { -1, -1, 0, 1, 1,  1,  0, -1 };
+
+	int speed = sprite_info->speed;
+	int stepX, stepY;
+
+	//---- the same as Sprite::process_move(), it fits to the destination when it gets very close ----//
+
+	if( abs(cur_x-go_x) <= speed )
+		stepX = go_x-cur_x;
+	else
+		stepX = vector_x_array[final_dir] * speed;
+
+	if( abs(cur_y-go_y) <= speed )
+		stepY = go_y-cur_y;
+	else
+		stepY = vector_y_array[final_dir] * speed;
+
+	int divisor = 256 * MAX(1, sprite_info->frames_per_step);
+
+	*offsetX = stepX * draw_fraction / divisor;
+	*offsetY = stepY * draw_fraction / divisor;
+}
+//----------- End of function Sprite::get_draw_offset -----------//
+
+
+//--------- Begin of function Sprite::interpolate_abs_pos ---------//
+//
+// Offset abs_x1, abs_y1, abs_x2 & abs_y2 set by update_abs_pos()
+// by the display offset of a moving sprite.
+//
+void Sprite::interpolate_abs_pos()
+{
+	int offsetX, offsetY;
+
+	get_draw_offset(&offsetX, &offsetY);
+
+	abs_x1 += offsetX;
+	abs_y1 += offsetY;
+	abs_x2 += offsetX;
+	abs_y2 += offsetY;
+}
+//----------- End of function Sprite::interpolate_abs_pos -----------//
+
+
 //--------- Begin of function Sprite::draw ---------//
 //
 void Sprite::draw()
@@ -215,6 +279,7 @@ void Sprite::draw()
 	int needMirror;
 	SpriteFrame* spriteFrame = cur_sprite_frame(&needMirror);
 	update_abs_pos(spriteFrame);
+	interpolate_abs_pos();
 
 	err_when( !sprite_info->res_bitmap.initialized() );
 
@@ -245,8 +310,8 @@ void Sprite::draw()
 		{
 			if( !sprite_info->remap_bitmap_flag )
 			{
-				vga_back.put_bitmap_area_trans_decompress_hmirror( x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
-					MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1 );
+				sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
+					MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, NULL, 1 );
 			}
 			else
 			{
@@ -259,7 +324,7 @@ void Sprite::draw()
 		{
 			if( !sprite_info->remap_bitmap_flag )
 			{
-				vga_back.put_bitmap_area_trans_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
+				sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
 					MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1 );
 			}
 			else
@@ -281,8 +346,8 @@ void Sprite::draw()
 		{
 			if( !sprite_info->remap_bitmap_flag )
 			{
-				vga_back.put_bitmap_trans_decompress_hmirror( x1+ZOOM_X1, y1+ZOOM_Y1,
-					bitmapPtr );
+				sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1,
+					bitmapPtr, NULL, 1 );
 			}
 			else
 			{
@@ -294,7 +359,7 @@ void Sprite::draw()
 		{
 			if( !sprite_info->remap_bitmap_flag )
 			{
-				vga_back.put_bitmap_trans_decompress( x1+ZOOM_X1, y1+ZOOM_Y1,
+				sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1,
 					bitmapPtr );
 			}
 			else
@@ -373,6 +438,6 @@ int Sprite::need_mirror(uint8_t dispDir)
 int Sprite::is_shealth()
 {
 	// if the visibility of location is just explored, consider shealth
-	return config.fog_of_war && world.get_loc(cur_x_loc(), cur_y_loc())->visibility() <= EXPLORED_VISIBILITY;
+	return config.fog_of_war && world.get_visibility(cur_x_loc(), cur_y_loc()) <= EXPLORED_VISIBILITY;
 }
 // ---------- End of function Sprite::is_shealth --------//
@@ -0,0 +1,392 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OSPRSPAN.CPP
+//Description : Object SpriteSpanCache, compressed bitmaps decoded into spans
+
+#include <string.h>
+#include <ALL.h>
+#include <COLCODE.h>
+#include <OSPRSPAN.h>
+
+//-------- Begin of function SpriteSpanCache::SpriteSpanCache --------//
+
+SpriteSpanCache::SpriteSpanCache()
+{
+	memset( this, 0, sizeof(SpriteSpanCache) );
+}
+//--------- End of function SpriteSpanCache::SpriteSpanCache ---------//
+
+
+//-------- Begin of function SpriteSpanCache::~SpriteSpanCache --------//
+
+SpriteSpanCache::~SpriteSpanCache()
+{
+	deinit();
+}
+//--------- End of function SpriteSpanCache::~SpriteSpanCache ---------//
+
+
+//-------- Begin of function SpriteSpanCache::deinit --------//
+//
+// Release all decoded bitmaps. Called when the sprite or firm bitmap
+// resources are released, as their addresses may be reused.
+//
+void SpriteSpanCache::deinit()
+{
+	while( lru_first )
+		del_span_bitmap( lru_first );
+
+	err_when( mem_used != 0 );
+}
+//--------- End of function SpriteSpanCache::deinit ---------//
+
+
+//-------- Begin of function SpriteSpanCache::put_bitmap --------//
+//
+// Same as VgaBuf::put_bitmap_trans_decompress(), or the remap and
+// hmirror versions of it.
+//
+// <char*> imageBuf, pitch - the surface buffer
+// <int>   desX, desY      - where to put the bitmap
+// <char*> bitmapPtr       - the compressed bitmap
+// [char*] colorTable      - the color remap table, NULL for no remapping
+//                           (default: NULL)
+// [int]   mirrorFlag      - whether to mirror the bitmap horizontally
+//                           (default: 0)
+//
+void SpriteSpanCache::put_bitmap(char* imageBuf, int pitch, int desX, int desY, char* bitmapPtr,
+											char* colorTable, int mirrorFlag)
+{
+	int bitmapWidth  = ((unsigned char*)bitmapPtr)[0] + (((unsigned char*)bitmapPtr)[1]<<8);
+	int bitmapHeight = ((unsigned char*)bitmapPtr)[2] + (((unsigned char*)bitmapPtr)[3]<<8);
+
+	put_bitmap_area( imageBuf, pitch, desX, desY, bitmapPtr, 0, 0, bitmapWidth-1, bitmapHeight-1,
+						  colorTable, mirrorFlag );
+}
+//--------- End of function SpriteSpanCache::put_bitmap ---------//
+
+
+//-------- Begin of function SpriteSpanCache::put_bitmap_area --------//
+//
+// Same as VgaBuf::put_bitmap_area_trans_decompress(), or the remap and
+// hmirror versions of it. The area is given in the coordinates of the
+// bitmap as it appears on the surface, that is after mirroring.
+//
+// As with the remap versions, a pixel remapped to TRANSPARENT_CODE is
+// not drawn.
+//
+void SpriteSpanCache::put_bitmap_area(char* imageBuf, int pitch, int desX, int desY, char* bitmapPtr,
+												  int srcX1, int srcY1, int srcX2, int srcY2, char* colorTable, int mirrorFlag)
+{
+	SpanBitmap* spanBitmap = get_span_bitmap(bitmapPtr);
+
+	int   	lastX = spanBitmap->width-1;
+	char* 	destLine = imageBuf + (desY+srcY1)*pitch + desX;
+	uint8_t* remapTable = (uint8_t*) colorTable;
+
+	for( int y=srcY1 ; y<=srcY2 ; y++, destLine+=pitch )
+	{
+		SpriteSpan* spanPtr = spanBitmap->span_array + spanBitmap->row_span_array[y];
+		SpriteSpan* spanEnd = spanBitmap->span_array + spanBitmap->row_span_array[y+1];
+
+		for( ; spanPtr<spanEnd ; spanPtr++ )
+		{
+			//--- the columns of the span on the surface, clipped to the area ---//
+
+			int spanX1, spanX2;
+
+			if( mirrorFlag )
+			{
+				spanX1 = lastX - (spanPtr->x + spanPtr->len - 1);
+				spanX2 = lastX - spanPtr->x;
+			}
+			else
+			{
+				spanX1 = spanPtr->x;
+				spanX2 = spanPtr->x + spanPtr->len - 1;
+			}
+
+			int x1 = MAX(spanX1, srcX1);
+			int x2 = MIN(spanX2, srcX2);
+
+			if( x1 > x2 )
+				continue;
+
+			int		 pixelCount = x2-x1+1;
+			uint8_t* srcPtr;
+			uint8_t* destPtr = (uint8_t*) destLine + x1;
+
+			//-------- copy the pixels of the span ---------//
+
+			if( !mirrorFlag )
+			{
+				srcPtr = spanBitmap->pixel_array + spanPtr->pixel_offset + (x1-spanX1);
+
+				if( !remapTable )
+				{
+					memcpy( destPtr, srcPtr, pixelCount );
+				}
+				else
+				{
+					for( int i=0 ; i<pixelCount ; i++ )
+					{
+						uint8_t pixel = remapTable[srcPtr[i]];
+
+						if( pixel < MIN_TRANSPARENT_CODE )
+							destPtr[i] = pixel;
+					}
+				}
+			}
+			else		// the source pixels are read backwards
+			{
+				srcPtr = spanBitmap->pixel_array + spanPtr->pixel_offset + (spanX2-x1);
+
+				if( !remapTable )
+				{
+					for( int i=0 ; i<pixelCount ; i++ )
+						destPtr[i] = srcPtr[-i];
+				}
+				else
+				{
+					for( int i=0 ; i<pixelCount ; i++ )
+					{
+						uint8_t pixel = remapTable[srcPtr[-i]];
+
+						if( pixel < MIN_TRANSPARENT_CODE )
+							destPtr[i] = pixel;
+					}
+				}
+			}
+		}
+	}
+}
+//--------- End of function SpriteSpanCache::put_bitmap_area ---------//
+
+
+//-------- Begin of function SpriteSpanCache::get_span_bitmap --------//
+//
+// Return the decoded bitmap of the given compressed bitmap, decode it
+// if it is not in the cache.
+//
+SpanBitmap* SpriteSpanCache::get_span_bitmap(char* bitmapPtr)
+{
+	int hashId = get_hash(bitmapPtr);
+
+	SpanBitmap* spanBitmap;
+
+	for( spanBitmap=hash_array[hashId] ; spanBitmap ; spanBitmap=spanBitmap->hash_next )
+	{
+		if( spanBitmap->bitmap_ptr == bitmapPtr )
+			break;
+	}
+
+	if( spanBitmap )
+	{
+		if( spanBitmap == lru_first )
+			return spanBitmap;
+
+		//------ unlink it from the lru list ------//
+
+		spanBitmap->lru_prev->lru_next = spanBitmap->lru_next;
+
+		if( spanBitmap->lru_next )
+			spanBitmap->lru_next->lru_prev = spanBitmap->lru_prev;
+		else
+			lru_last = spanBitmap->lru_prev;
+	}
+	else
+	{
+		//--- release the least recently used bitmaps to make room for it ---//
+
+		spanBitmap = decode(bitmapPtr);
+
+		while( lru_last && mem_used + spanBitmap->mem_size > SPRITE_SPAN_CACHE_SIZE )
+			del_span_bitmap( lru_last );
+
+		spanBitmap->hash_next = hash_array[hashId];
+		hash_array[hashId] = spanBitmap;
+
+		mem_used += spanBitmap->mem_size;
+	}
+
+	//------ put it at the front of the lru list -------//
+
+	spanBitmap->lru_prev = NULL;
+	spanBitmap->lru_next = lru_first;
+
+	if( lru_first )
+		lru_first->lru_prev = spanBitmap;
+	else
+		lru_last = spanBitmap;
+
+	lru_first = spanBitmap;
+
+	return spanBitmap;
+}
+//--------- End of function SpriteSpanCache::get_span_bitmap ---------//
+
+
+//-------- Begin of function SpriteSpanCache::decode --------//
+//
+// Decode a compressed bitmap into spans. The bitmap is scanned twice,
+// first to count the spans and pixels, then to fill in the arrays.
+//
+// The compressed format is the one handled by IMGbltTransDecompress():
+// a pixel below MIN_TRANSPARENT_CODE is drawn, MANY_TRANSPARENT_CODE is
+// followed by the no. of transparent pixels and other codes stand for
+// (256-code) transparent pixels. Transparent runs may go on to the next
+// lines.
+//
+SpanBitmap* SpriteSpanCache::decode(char* bitmapPtr)
+{
+	uint8_t* bitmapBuf = (uint8_t*) bitmapPtr;
+
+	int bitmapWidth  = bitmapBuf[0] + (bitmapBuf[1]<<8);
+	int bitmapHeight = bitmapBuf[2] + (bitmapBuf[3]<<8);
+	int spanCount=0, pixelCount=0;
+
+	SpanBitmap* spanBitmap = NULL;
+
+	for( int pass=0 ; pass<2 ; pass++ )
+	{
+		if( pass==1 )
+		{
+			int memSize = sizeof(SpanBitmap) + sizeof(int) * (bitmapHeight+1) +
+							  sizeof(SpriteSpan) * spanCount + pixelCount;
+
+			spanBitmap = (SpanBitmap*) mem_add( memSize );
+
+			spanBitmap->bitmap_ptr 	  = bitmapPtr;
+			spanBitmap->mem_size   	  = memSize;
+			spanBitmap->width		  	  = bitmapWidth;
+			spanBitmap->height	  	  = bitmapHeight;
+			spanBitmap->row_span_array = (int*) (spanBitmap+1);
+			spanBitmap->span_array	  = (SpriteSpan*) (spanBitmap->row_span_array + bitmapHeight+1);
+			spanBitmap->pixel_array	  = (uint8_t*) (spanBitmap->span_array + spanCount);
+
+			spanCount  = 0;
+			pixelCount = 0;
+		}
+
+		int srcOffset = 4;		// skip the width and height
+		int pixelsToSkip = 0;
+
+		for( int y=0 ; y<bitmapHeight ; y++ )
+		{
+			if( spanBitmap )
+				spanBitmap->row_span_array[y] = spanCount;
+
+			int x=0;
+
+			while( x<bitmapWidth )
+			{
+				if( pixelsToSkip )
+				{
+					if( pixelsToSkip >= bitmapWidth-x )		// the transparent run goes on to the next line
+					{
+						pixelsToSkip -= bitmapWidth-x;
+						break;
+					}
+
+					x += pixelsToSkip;
+					pixelsToSkip = 0;
+				}
+
+				int code = bitmapBuf[srcOffset];
+
+				if( code < MIN_TRANSPARENT_CODE )
+				{
+					//------- a run of opaque pixels -------//
+
+					int spanX = x;
+
+					while( x<bitmapWidth && bitmapBuf[srcOffset] < MIN_TRANSPARENT_CODE )
+					{
+						if( spanBitmap )
+							spanBitmap->pixel_array[pixelCount+x-spanX] = bitmapBuf[srcOffset];
+
+						srcOffset++;
+						x++;
+					}
+
+					if( spanBitmap )
+					{
+						SpriteSpan* spanPtr = spanBitmap->span_array + spanCount;
+
+						spanPtr->x	  = spanX;
+						spanPtr->len  = x-spanX;
+						spanPtr->pixel_offset = pixelCount;
+					}
+
+					spanCount++;
+					pixelCount += x-spanX;
+				}
+				else
+				{
+					srcOffset++;
+
+					if( code == MANY_TRANSPARENT_CODE )
+						pixelsToSkip = bitmapBuf[srcOffset++];
+					else
+						pixelsToSkip = 256-code;
+				}
+			}
+		}
+
+		if( spanBitmap )
+			spanBitmap->row_span_array[bitmapHeight] = spanCount;
+	}
+
+	return spanBitmap;
+}
+//--------- End of function SpriteSpanCache::decode ---------//
+
+
+//-------- Begin of function SpriteSpanCache::del_span_bitmap --------//
+
+void SpriteSpanCache::del_span_bitmap(SpanBitmap* spanBitmap)
+{
+	//------- unlink it from the hash bucket -------//
+
+	SpanBitmap** linkPtr = hash_array + get_hash(spanBitmap->bitmap_ptr);
+
+	while( *linkPtr != spanBitmap )
+		linkPtr = &(*linkPtr)->hash_next;
+
+	*linkPtr = spanBitmap->hash_next;
+
+	//-------- unlink it from the lru list ---------//
+
+	if( spanBitmap->lru_prev )
+		spanBitmap->lru_prev->lru_next = spanBitmap->lru_next;
+	else
+		lru_first = spanBitmap->lru_next;
+
+	if( spanBitmap->lru_next )
+		spanBitmap->lru_next->lru_prev = spanBitmap->lru_prev;
+	else
+		lru_last = spanBitmap->lru_prev;
+
+	mem_used -= spanBitmap->mem_size;
+
+	mem_del( spanBitmap );
+}
+//--------- End of function SpriteSpanCache::del_span_bitmap ---------//
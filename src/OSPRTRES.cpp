@@ -26,6 +26,7 @@
 #include <OWORLD.h>
 #include <OGAMESET.h>
 #include <OSPRTRES.h>
+#include <OSPRSPAN.h>
 #include <OWEATHER.h>
 
 
@@ -358,7 +359,10 @@ void SpriteInfo::free_bitmap_res()
 	err_when( loaded_count < 0 );
 
 	if( loaded_count==0 )		// if this bitmap is still needed by other sprites
+	{
+		sprite_span_cache.deinit();		// its address may be reused by other bitmaps
 		res_bitmap.deinit();
+	}
 }
 //-------- End of function SpriteInfo::free_bitmap_res -------//
 
@@ -55,7 +55,15 @@
 #include <OUNIT.h>
 #include <OSITE.h>
 #include <OSPATH.h>
+#include <OSPHPA.h>
+#include <OSPFLOW.h>
+#include <OSPCACHE.h>
+#include <OUNITGRD.h>
+#include <OLINKGRD.h>
+#include <OLOCSUM.h>
 #include <OSPREUSE.h>
+#include <OSPRSPAN.h>
+#include <OBANDRND.h>
 #include <OSPY.h>
 #include <OSYS.h>
 #include <OREMOTE.h>
@@ -67,6 +75,8 @@
 #include <OF_BASE.h>
 #include <OTOWN.h>
 #include <OBULLET.h>
+#include <OBENCH.h>
+#include <OPROFILE.h>
 #include <ONATION.h>
 #include <OFLAME.h>
 #include <OPOWER.h>
@@ -489,6 +499,14 @@ void Sys::deinit_objects()
 
    seek_path.deinit();
    seek_path_reuse.deinit();
+   seek_path_hpa.deinit();
+   flow_field.deinit();
+   seek_path_cache.deinit();
+   unit_grid.deinit();
+   link_grid.deinit();
+   loc_sum.deinit();
+   sprite_span_cache.deinit();
+   band_render.deinit();
    group_select.deinit();
 
    for(int i = 0; i < FLAME_GROW_STEP; ++i)
@@ -554,6 +572,14 @@ void Sys::run(int isLoadedGame)
    #endif
    //-*********** simulate aat ************-//
 
+   //--- in a headless benchmark or replay run, process frames without pacing or display ---//
+
+   if( bench.active_flag )
+   {
+      run_bench(bench.frame_limit);
+      return;
+   }
+
    sys_flag  = SYS_RUN;
    view_mode = MODE_NORMAL;
 
@@ -602,6 +628,49 @@ void Sys::run(int isLoadedGame)
 //--------- End of function Sys::run --------//
 
 
+//-------- Begin of function Sys::run_bench --------//
+//
+// Process frames of the loaded game as fast as possible, without
+// pacing or display. Called by Bench::run() and, for replays, by
+// Sys::run().
+//
+// <int> frameCount - no. of frames to process, 0 to run until the
+//                    replay ends
+//
+void Sys::run_bench(int frameCount)
+{
+   sys_flag  = SYS_RUN;
+   view_mode = MODE_NORMAL;
+
+   power.enable();      // the replayed messages are processed in nation order only when power is enabled
+
+   misc.unlock_seed();
+
+   for( int i=0 ; frameCount==0 || i<frameCount ; i++ )
+   {
+      if( signal_exit_flag )
+         break;
+
+      bench.begin_frame();
+
+      if( remote.is_replay() )
+         remote.process_receive_queue();
+
+      process();
+
+      bench.end_frame();
+
+      //------ record objects' crc, as Sys::main_loop() does -------//
+
+      if( remote.is_replay() && (remote.sync_test_level & 2) && (frame_count % (remote.get_process_frame_delay()+3)) == 0 )
+         crc_store.record_all();
+   }
+
+   sys_flag = SYS_PREGAME;
+}
+//--------- End of function Sys::run_bench --------//
+
+
 //-------- Begin of static function test_lzw --------//
 //
 static void test_lzw()
@@ -813,48 +882,31 @@ void Sys::main_loop(int isLoadedGame)
 
          if( config.frame_speed>0 )              // 0-frozen
          {
-            if( remote.is_enable() )      // && is_sync_frame )
-            {
-               remote.poll_msg();
-               misc.unlock_seed();
-               rc = is_mp_sync(&unreadyPlayerFlag);         // if all players are synchronized
-               misc.lock_seed();
-            }
-            else
-               rc = should_next_frame();
+            rc = is_next_frame_due(&unreadyPlayerFlag);
 
-            if( rc )
-            {
-               LOG_BEGIN;
-               misc.unlock_seed();
+            //---------------------------------------------------//
+            // Process the frames that are due before displaying.
+            // If the game is behind, because of fast forward or
+            // because a multiplayer game is catching up after a
+            // stall, several frames are processed and only the
+            // last one is displayed, so that the display doesn't
+            // limit the game speed.
+            //---------------------------------------------------//
 
-               if( remote.is_replay() )
-                  remote.process_receive_queue();
+            int frameProcessedCount = 0;
 
-#ifdef DEBUG_LONG_LOG
-               if( remote.is_enable() )
-               {
-                  long_log->printf("begin process frame %d\n", frame_count);
-               }
-#endif
-
-               process(); // also calls 'disp_frame()'
-
-               if(remote.is_enable() )
-                  misc.lock_seed();    // such that random seed is unchanged outside sys::process()
-               LOG_END;
+            while( rc )
+            {
+               process_frame();
 
-               // -------- compare objects' crc --------- //
-               // ###### patch begin Gilbert 20/1 ######//
-               if( (remote.is_enable() || remote.is_replay()) && (remote.sync_test_level & 2) && (frame_count % (remote.get_process_frame_delay()+3)) == 0 )
+               if( ++frameProcessedCount >= MAX_FRAMES_PER_DISP || signal_exit_flag ||
+                   misc.get_time()-markTime >= MAX_FRAME_PROCESS_TIME )
                {
-                  // cannot compare every frame, as PROCESS_FRAME_DELAY >= 1
-                  crc_store.record_all();
-                  if( !remote.is_replay() )
-                     crc_store.send_all();
+                  break;
                }
-               // ###### patch end Gilbert 20/1 ######//
 
+               if( !is_next_frame_due(&unreadyPlayerFlag) )
+                  break;
             }
          }
 
@@ -862,6 +914,18 @@ void Sys::main_loop(int isLoadedGame)
          // ------- display gradually, keep on displaying --------- //
          if( rc )
          {
+            Sprite::draw_fraction = 0;
+
+            LOG_MSG("begin sys.disp_frame");
+            PROFILE_BEGIN("sys.disp_frame");
+            misc.lock_seed();
+            if( cmd_line.enable_if )
+               disp_frame();
+            if( !remote.is_enable() )
+               misc.unlock_seed();     // random seed is locked outside sys::process() in a multiplayer game
+            PROFILE_END();
+            LOG_MSG("end sys.disp_frame");
+
             lastDispFrameTime = misc.get_time();
 				// ####### patch begin Gilbert 17/11 ######//
 				// reset firstUnreadyTime
@@ -878,15 +942,25 @@ void Sys::main_loop(int isLoadedGame)
 
             // although it's not time for new frame, check
             // if we still need to redraw the screen
+            // last condition: redraw the moving sprites part of the way to their next
+            // positions when the display rate is higher than the game speed
+            int interpolateFlag = config_adv.vga_frame_interpolation && !remote.is_enable() &&
+               config.frame_speed > 0 && config.frame_speed < 99 && next_frame_time &&
+               markTime-lastDispFrameTime >= MIN_DISP_INTERVAL;
+
             if( config.frame_speed == 0 || markTime-lastDispFrameTime >= uint32_t(1000/config.frame_speed)
-					|| zoom_need_redraw || map_need_redraw
+					|| zoom_need_redraw || map_need_redraw || interpolateFlag
 					)
             {
                // second condition (markTime-lastDispFrameTime >= DWORD(1000/config.frame_speed) )
                // may happen in multiplayer, where 'should_next_frame' would pass (what means it's time
                // to process new frame according to config.frame_speed), but 'is_mp_sync' still failed.
+               Sprite::draw_fraction = interpolateFlag ? get_frame_fraction(markTime) : 0;
+
                if( cmd_line.enable_if )
                   disp_frame();
+
+               Sprite::draw_fraction = 0;
                lastDispFrameTime = markTime;
 
 					// ####### patch begin Gilbert 17/11 ######//
@@ -936,47 +1010,6 @@ void Sys::main_loop(int isLoadedGame)
          }
 #endif
 
-         if(rc)
-         {
-            //-*********** syn game test ***********-//
-            //-------------------------------------------------------------//
-            // record random seed for comparison
-            //-------------------------------------------------------------//
-            #ifdef DEBUG
-               if(debug_seed_status_flag==DEBUG_SYN_LOAD_AND_COMPARE_ONCE ||
-                  debug_seed_status_flag==DEBUG_SYN_AUTO_LOAD)
-                  sp_compare_seed();
-               else if(debug_seed_status_flag==DEBUG_SYN_AUTO_SAVE)
-                  sp_record_seed();
-            #endif
-            //-*********** syn game test ***********-//
-
-            //------ auto save -------//
-
-            auto_save();
-         }
-
-         //------ detect save game triggered by remote player ------//
-
-         if( mp_save_flag && mp_save_frame == frame_count )
-         {
-            mp_clear_request_save();            // clear request first before save game
-
-            if( nation_array.player_recno )     // only save when the player is still in the game
-            {
-               SaveGameProvider::save_game(remote.save_file_name);
-
-               // ####### begin Gilbert 24/10 ######//
-               //static String str;
-               //str  = "The current game has been saved to ";
-               //str += remote.save_file_name;
-               //str += ".";
-               //box.msg( str );
-               news_array.multi_save_game();
-               // ####### end Gilbert 24/10 ######//
-            }
-         }
-
          vga_front.unlock_buf();
    }
 
@@ -1004,6 +1037,116 @@ void Sys::main_loop(int isLoadedGame)
 //--------- End of function Sys::main_loop --------//
 
 
+//-------- Begin of function Sys::is_next_frame_due --------//
+//
+// Return whether it is time to process the next frame: the next frame
+// time has been reached in a single player game, or all players are
+// synchronized in a multiplayer game.
+//
+// <int*> unreadyPlayerFlag - bit flags of the players who are not ready yet
+//
+int Sys::is_next_frame_due(int *unreadyPlayerFlag)
+{
+   if( remote.is_enable() )      // && is_sync_frame )
+   {
+      remote.poll_msg();
+      misc.unlock_seed();
+      int rc = is_mp_sync(unreadyPlayerFlag);         // if all players are synchronized
+      misc.lock_seed();
+      return rc;
+   }
+   else
+      return should_next_frame();
+}
+//--------- End of function Sys::is_next_frame_due --------//
+
+
+//-------- Begin of function Sys::process_frame --------//
+//
+// Process one game frame in the main loop, without displaying it.
+//
+void Sys::process_frame()
+{
+   LOG_BEGIN;
+   misc.unlock_seed();
+
+   if( remote.is_replay() )
+      remote.process_receive_queue();
+
+#ifdef DEBUG_LONG_LOG
+   if( remote.is_enable() )
+   {
+      long_log->printf("begin process frame %d\n", frame_count);
+   }
+#endif
+
+   process();
+
+   if(remote.is_enable() )
+      misc.lock_seed();    // such that random seed is unchanged outside sys::process()
+   LOG_END;
+
+   // -------- compare objects' crc --------- //
+   // ###### patch begin Gilbert 20/1 ######//
+   if( (remote.is_enable() || remote.is_replay()) && (remote.sync_test_level & 2) && (frame_count % (remote.get_process_frame_delay()+3)) == 0 )
+   {
+      // cannot compare every frame, as PROCESS_FRAME_DELAY >= 1
+      crc_store.record_all();
+      if( !remote.is_replay() )
+         crc_store.send_all();
+   }
+   // ###### patch end Gilbert 20/1 ######//
+
+   //-*********** syn game test ***********-//
+   //-------------------------------------------------------------//
+   // record random seed for comparison
+   //-------------------------------------------------------------//
+   #ifdef DEBUG
+      if(debug_seed_status_flag==DEBUG_SYN_LOAD_AND_COMPARE_ONCE ||
+         debug_seed_status_flag==DEBUG_SYN_AUTO_LOAD)
+         sp_compare_seed();
+      else if(debug_seed_status_flag==DEBUG_SYN_AUTO_SAVE)
+         sp_record_seed();
+   #endif
+   //-*********** syn game test ***********-//
+
+   //------ auto save -------//
+
+   auto_save();
+
+   //------ detect save game triggered by remote player ------//
+
+   detect_mp_save();
+}
+//--------- End of function Sys::process_frame --------//
+
+
+//-------- Begin of function Sys::detect_mp_save --------//
+//
+void Sys::detect_mp_save()
+{
+   if( mp_save_flag && mp_save_frame == frame_count )
+   {
+      mp_clear_request_save();            // clear request first before save game
+
+      if( nation_array.player_recno )     // only save when the player is still in the game
+      {
+         SaveGameProvider::save_game(remote.save_file_name);
+
+         // ####### begin Gilbert 24/10 ######//
+         //static String str;
+         //str  = "The current game has been saved to ";
+         //str += remote.save_file_name;
+         //str += ".";
+         //box.msg( str );
+         news_array.multi_save_game();
+         // ####### end Gilbert 24/10 ######//
+      }
+   }
+}
+//--------- End of function Sys::detect_mp_save --------//
+
+
 //-------- Begin of function Sys::auto_save --------//
 //
 void Sys::auto_save()
@@ -1499,14 +1642,50 @@ int Sys::should_next_frame()
    }
 
    //--- Time between frames = 1000 milliseconds / frames per second ---//
+   //
+   // Keep a fixed time step: the next frame is due one frame time after
+   // this frame was due, so the frames delayed by a slow display are
+   // caught up by Sys::main_loop(). If the game is too far behind, start
+   // timing from now instead.
+   //
+   //---------------------------------------------------------------------//
+
+   uint32_t frameTime = 1000 / config.frame_speed;
 
-   next_frame_time = curTime + 1000 / config.frame_speed;
+   if( next_frame_time && curTime-next_frame_time < frameTime * MAX_FRAMES_PER_DISP )
+      next_frame_time += frameTime;
+   else
+      next_frame_time = curTime + frameTime;
 
    return 1;
 }
 //--------- End of function Sys::should_next_frame ---------//
 
 
+//-------- Begin of function Sys::get_frame_fraction --------//
+//
+// Return how far the time has gone from the last frame to the next
+// frame, in 1/256 of the frame time. It is used for interpolating the
+// display positions of moving sprites.
+//
+// <uint32_t> curTime - the current time
+//
+int Sys::get_frame_fraction(uint32_t curTime)
+{
+   if( config.frame_speed <= 0 || !next_frame_time )
+      return 0;
+
+   int frameTime  = 1000 / config.frame_speed;
+   int remainTime = (int) (next_frame_time - curTime);
+
+   if( remainTime <= 0 || remainTime > frameTime )
+      return 0;
+
+   return (frameTime-remainTime) * 256 / frameTime;
+}
+//--------- End of function Sys::get_frame_fraction --------//
+
+
 //-------- Begin of function Sys::process_key --------//
 //
 void Sys::process_key(unsigned scanCode, unsigned skeyState)
@@ -1804,6 +1983,20 @@ void Sys::detect_function_key(unsigned scanCode, unsigned skeyState)
       case KEY_F11:
          capture_screen();
          break;
+
+      case KEY_F12:
+         if( profiler.enable_flag && cmd_line.profile_file )
+         {
+            String str;
+
+            if( profiler.dump_trace(cmd_line.profile_file) )
+               snprintf( str, MAX_STR_LEN+1, _("The profiler trace has been written to file %s."), cmd_line.profile_file );
+            else
+               snprintf( str, MAX_STR_LEN+1, _("Unable to write the profiler trace to file %s."), cmd_line.profile_file );
+
+            box.msg( str );
+         }
+         break;
       }
    }
 }
@@ -36,6 +36,7 @@
 #include <OTUTOR.h>
 #include <ONEWS.h>
 #include <OBULLET.h>
+#include <OPROFILE.h>
 #include <OREBEL.h>
 #include <OREMOTE.h>
 #include <OSPY.h>
@@ -122,6 +123,8 @@ void Sys::detect()
 //
 void Sys::process()
 {
+	PROFILE_SCOPE("Sys::process");
+
 	//------- update frame count and is_sync_frame --------//
 
 	frame_count++;
@@ -131,130 +134,173 @@ void Sys::process()
 
 	LOG_MSG(misc.get_random_seed());
 	LOG_MSG("begin unit_array.process()");
+	PROFILE_BEGIN("unit_array.process");
 	unit_array.process();
 	seek_path.reset_total_node_avail();	// reset node for seek_path
+	PROFILE_END();
 	LOG_MSG("end unit_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin firm_array.process()");
+	PROFILE_BEGIN("firm_array.process");
 	firm_array.process();
+	PROFILE_END();
 	LOG_MSG("end firm_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin town_array.process()");
+	PROFILE_BEGIN("town_array.process");
 	town_array.process();
+	PROFILE_END();
 	LOG_MSG("end town_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin nation_array.process()");
+	PROFILE_BEGIN("nation_array.process");
 	nation_array.process();
+	PROFILE_END();
 	LOG_MSG("end nation_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin bullet_array.process()");
+	PROFILE_BEGIN("bullet_array.process");
 	bullet_array.process();
+	PROFILE_END();
 	LOG_MSG("end bullet_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin world.process()");
+	PROFILE_BEGIN("world.process");
 	world.process();
+	PROFILE_END();
 	LOG_MSG("end world.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin tornado_array.process()");
+	PROFILE_BEGIN("tornado_array.process");
 	tornado_array.process();
-	LOG_MSG("begin tornado_array.process()");
+	PROFILE_END();
+	LOG_MSG("end tornado_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin snow_ground_array.process()");
+	PROFILE_BEGIN("snow_ground_array.process");
 	snow_ground_array.process();
+	PROFILE_END();
 	LOG_MSG("end snow_ground_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin rock_array.process()");
+	PROFILE_BEGIN("rock_array.process");
 	rock_array.process();
+	PROFILE_END();
 	LOG_MSG("end rock_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin dirt_array.process()");
+	PROFILE_BEGIN("dirt_array.process");
 	dirt_array.process();
+	PROFILE_END();
 	LOG_MSG("end dirt_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin effect_array.process()");
+	PROFILE_BEGIN("effect_array.process");
 	effect_array.process();
+	PROFILE_END();
 	LOG_MSG("end effect_array.process()");
 	LOG_MSG(misc.get_random_seed());
 
 	LOG_MSG("begin war_point_array.process()");
+	PROFILE_BEGIN("war_point_array.process");
 	war_point_array.process();
+	PROFILE_END();
 	LOG_MSG("end war_point_array.process()");
 
 	LOG_MSG("begin firm_die.process()");
+	PROFILE_BEGIN("firm_die.process");
 	firm_die_array.process();
+	PROFILE_END();
 	LOG_MSG("end firm_die.process()");
 
 	//------ check if it's time for the next day ------//
 
 	if( ++day_frame_count > FRAMES_PER_DAY )
 	{
+		PROFILE_BEGIN("next_day");
+
 		LOG_MSG("begin info.next_day()");
+		PROFILE_BEGIN("info.next_day");
 		info.next_day();
+		PROFILE_END();
 		LOG_MSG("end info.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin world.next_day()");
+		PROFILE_BEGIN("world.next_day");
 		world.next_day();
+		PROFILE_END();
 		LOG_MSG("end world.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin site_array.next_day()");
+		PROFILE_BEGIN("site_array.next_day");
 		site_array.next_day();
+		PROFILE_END();
 		LOG_MSG("end site_array.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin rebel_array.next_day()");
+		PROFILE_BEGIN("rebel_array.next_day");
 		rebel_array.next_day();
+		PROFILE_END();
 		LOG_MSG("end rebel_array.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin spy_array.next_day()");
+		PROFILE_BEGIN("spy_array.next_day");
 		spy_array.next_day();
+		PROFILE_END();
 		LOG_MSG("end spy_array.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin sprite_res.update_speed()");
+		PROFILE_BEGIN("sprite_res.update_speed");
 		if( config.weather_effect)
 			sprite_res.update_speed();
+		PROFILE_END();
 		LOG_MSG("end sprite_res.update_speed()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin raw_res.next_day()");
+		PROFILE_BEGIN("raw_res.next_day");
 		raw_res.next_day();
+		PROFILE_END();
 		LOG_MSG("end raw_res.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin talk_res.next_day()");
+		PROFILE_BEGIN("talk_res.next_day");
 		talk_res.next_day();
+		PROFILE_END();
 		LOG_MSG("end talk_res.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		LOG_MSG("begin region_array.next_day()");
+		PROFILE_BEGIN("region_array.next_day");
 		region_array.next_day();
+		PROFILE_END();
 		LOG_MSG("end region_array.next_day()");
 		LOG_MSG(misc.get_random_seed());
 
 		day_frame_count = 0;
+
+		PROFILE_END();
+
 	}
 
-	//------ display the current frame ------//
+	//------ the frame is displayed by Sys::main_loop() ------//
 
-	LOG_MSG("begin sys.disp_frame");
-	misc.lock_seed();
-	if( cmd_line.enable_if )
-		disp_frame();
-	misc.unlock_seed();
-	LOG_MSG("end sys.disp_frame");
 	LOG_MSG(misc.get_random_seed() );
 
 	//-----------------------------------------//
@@ -978,19 +1024,11 @@ void Sys::disp_zoom()
 	World::view_top_x = zoomMatrix->top_x_loc * ZOOM_LOC_WIDTH;
 	World::view_top_y = zoomMatrix->top_y_loc * ZOOM_LOC_HEIGHT;
 
-	//--------- draw map area ---------//
-
-	if( zoom_need_redraw )		// requested by other modules to redraw the pre-drawn zoom background
-	{
-		long backupSeed = misc.get_random_seed();
-		
-		world.zoom_matrix->draw();
-		zoom_need_redraw = 0;
-	}
+	zoom_need_redraw = 0;
 
 	//-------- disp zoom area --------//
 
-	world.zoom_matrix->disp();
+	world.zoom_matrix->disp();		// the zoom matrix has no background buffer, so disp() draws it
 
 	//---- draw sprite white sites if in debug mode ----//
 
@@ -348,6 +348,7 @@ void TornadoArray::draw_dot()
 	Tornado* tornadoPtr;
 	int	  i, mapX, mapY;
 	int		vgaBufPitch = vga_back.buf_pitch();
+	int		locScale = MAP_LOC_SCALE;
 
 	for(i=1; i <=size() ; i++)
 	{
@@ -356,8 +357,8 @@ void TornadoArray::draw_dot()
 		if( !tornadoPtr )
 			continue;
 
-		mapX = MAP_X1 + tornadoPtr->cur_x_loc();
-		mapY = MAP_Y1 + tornadoPtr->cur_y_loc();
+		mapX = MAP_X1 + tornadoPtr->cur_x_loc()/locScale;
+		mapY = MAP_Y1 + tornadoPtr->cur_y_loc()/locScale;
 
 		// ####### begin Gilbert 13/11 #########//
 		if( mapX < MAP_X1 || mapX > MAP_X2 || mapY < MAP_Y1 || mapY > MAP_Y2 )
@@ -53,6 +53,7 @@
 // ##### end Gilbert 9/10 ######//
 #include <OSERES.h>
 #include <OLOG.h>
+#include <OLINKGRD.h>
 #include <ConfigAdv.h>
 
 static char random_race();
@@ -146,6 +147,8 @@ void Town::init(int nationRecno, int raceId, int xLoc, int yLoc)
 
 	set_world_matrix();
 
+	link_grid.add_town(this);
+
 	setup_link();
 
 	//-------- if this is an AI town ------//
@@ -208,6 +211,8 @@ void Town::deinit()
 
 	release_link();
 
+	link_grid.del_town(this);
+
 	//-- if there is a unit being trained when the town vanishes --//
 
 	if(train_unit_recno)
@@ -3252,8 +3257,12 @@ void Town::setup_link()
 
 	linked_firm_count = 0;
 
-	for( firmRecno=firm_array.size() ; firmRecno>0 ; firmRecno-- )
+	int i, nearCount = link_grid.near_firm( center_x, center_y, EFFECTIVE_FIRM_TOWN_DISTANCE );
+
+	for( i=0 ; i<nearCount ; i++ )
 	{
+		firmRecno = link_grid.near_recno_array[i];
+
 		if( firm_array.is_deleted(firmRecno) )
 			continue;
 
@@ -3333,8 +3342,12 @@ void Town::setup_link()
 	int   townRecno;
 	Town* townPtr;
 
-	for( townRecno=town_array.size() ; townRecno>0 ; townRecno-- )
+	nearCount = link_grid.near_town( center_x, center_y, EFFECTIVE_TOWN_TOWN_DISTANCE );
+
+	for( i=0 ; i<nearCount ; i++ )
 	{
+		townRecno = link_grid.near_recno_array[i];
+
 		if( town_array.is_deleted(townRecno) || townRecno==town_recno )
 			continue;
 
@@ -527,6 +527,9 @@ void TownArray::draw_dot()
 	char			nationColor;
 	char*   	   nationColorArray = nation_array.nation_color_array;
 	int			vgaBufPitch = vga_back.buf_pitch();
+	int			locScale = MAP_LOC_SCALE;
+	int			townWidth  = (STD_TOWN_LOC_WIDTH +locScale-1) / locScale;
+	int			townHeight = (STD_TOWN_LOC_HEIGHT+locScale-1) / locScale;
 
 	// ##### begin Gilbert 16/8 #######//
 	const unsigned int excitedColorCount = 4;
@@ -564,12 +567,12 @@ void TownArray::draw_dot()
 
 		townLayout = town_res.get_layout(townPtr->layout_id);
 
-		writePtr = vgaBufPtr + (MAP_Y1+townPtr->loc_y1)*vgaBufPitch + (MAP_X1+townPtr->loc_x1);
+		writePtr = vgaBufPtr + (MAP_Y1+townPtr->loc_y1/locScale)*vgaBufPitch + (MAP_X1+townPtr->loc_x1/locScale);
 
 		char shadowColor = (char) VGA_GRAY;
-		for( y=STD_TOWN_LOC_HEIGHT ; y>0 ; y--, writePtr+=vgaBufPitch-STD_TOWN_LOC_WIDTH )
+		for( y=townHeight ; y>0 ; y--, writePtr+=vgaBufPitch-townWidth )
 		{
-			for( x=STD_TOWN_LOC_WIDTH ; x>0 ; x--, writePtr++ )
+			for( x=townWidth ; x>0 ; x--, writePtr++ )
 			{
 				if( *writePtr != UNEXPLORED_COLOR )
 					*writePtr = nationColor;
@@ -578,7 +581,7 @@ void TownArray::draw_dot()
 			if( *(writePtr+vgaBufPitch) != UNEXPLORED_COLOR)
 				*(writePtr+vgaBufPitch) = shadowColor;
 		}
-		for( x = STD_TOWN_LOC_WIDTH ; x>0; x--)
+		for( x = townWidth ; x>0; x--)
 		{
 			if( *(++writePtr) != UNEXPLORED_COLOR )
 				*writePtr = shadowColor;
@@ -1560,6 +1560,7 @@ void Unit::change_nation(int newNationRecno)
 	//---------------- update vars ----------------//
 
 	unit_group_id = unit_array.cur_group_id++;      // separate from the current group
+	unit_grid.change_unit_nation(this, newNationRecno);
 	nation_recno  = newNationRecno;
 
 	home_camp_firm_recno  = 0;					// reset it
@@ -2389,7 +2390,7 @@ void Unit::resign(int remoteAction)
 //
 // Return the region id. of this unit.
 //
-uint8_t Unit::region_id()
+uint16_t Unit::region_id()
 {
    if( is_visible() )
    {
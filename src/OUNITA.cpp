@@ -266,6 +266,7 @@ void UnitArray::draw_dot()
 	char*   nationColorArray = nation_array.nation_color_array;
 	char	  nationColor;
 	int		vgaBufPitch = vga_back.buf_pitch();
+	int		locScale = MAP_LOC_SCALE;
 	const unsigned int excitedColorCount = 4;
 	char excitedColorArray[MAX_NATION+1][excitedColorCount];
 	short playerNationRecno = nation_array.player_recno;
@@ -336,10 +337,10 @@ void UnitArray::draw_dot()
 					//-----------------------------------------------------------//
 					if(unitPtr->cur_x_loc()!=unitPtr->go_x_loc() || unitPtr->cur_y_loc()!=unitPtr->go_y_loc())
 					{
-						lineFromX = MAP_X1 + unitPtr->go_x_loc();
-						lineFromY = MAP_Y1 + unitPtr->go_y_loc();
-						lineToX = MAP_X1 + unitPtr->next_x_loc();
-						lineToY = MAP_Y1 + unitPtr->next_y_loc();
+						lineFromX = MAP_X1 + unitPtr->go_x_loc()/locScale;
+						lineFromY = MAP_Y1 + unitPtr->go_y_loc()/locScale;
+						lineToX = MAP_X1 + unitPtr->next_x_loc()/locScale;
+						lineToY = MAP_Y1 + unitPtr->next_y_loc()/locScale;
 						vga_back.line(lineFromX, lineFromY, lineToX, lineToY, lineColor);
 					}
 
@@ -349,10 +350,10 @@ void UnitArray::draw_dot()
 					resultNode2 = resultNode1 + 1;
 					for(j=resultNodeRecno+1; j<=resultNodeCount; j++, resultNode1++, resultNode2++)
 					{
-						lineFromX = MAP_X1 + resultNode2->node_x;
-						lineFromY = MAP_Y1 + resultNode2->node_y;
-						lineToX = MAP_X1 + resultNode1->node_x;
-						lineToY = MAP_Y1 + resultNode1->node_y;
+						lineFromX = MAP_X1 + resultNode2->node_x/locScale;
+						lineFromY = MAP_Y1 + resultNode2->node_y/locScale;
+						lineToX = MAP_X1 + resultNode1->node_x/locScale;
+						lineToY = MAP_Y1 + resultNode1->node_y/locScale;
 						vga_back.line(lineFromX, lineFromY, lineToX, lineToY, lineColor);
 					}
 				}
@@ -363,12 +364,12 @@ void UnitArray::draw_dot()
 				{
 					resultNode1 = unitPtr->way_point_array;
 					resultNode2 = resultNode1+1;
-					lineToX = MAP_X1 + resultNode1->node_x;
-					lineToY = MAP_Y1 + resultNode1->node_y;
+					lineToX = MAP_X1 + resultNode1->node_x/locScale;
+					lineToY = MAP_Y1 + resultNode1->node_y/locScale;
 					for(j=unitPtr->way_point_count-1; j>0; j--, resultNode1++, resultNode2++)
 					{
-						lineFromX = MAP_X1 + resultNode2->node_x;
-						lineFromY = MAP_Y1 + resultNode2->node_y;
+						lineFromX = MAP_X1 + resultNode2->node_x/locScale;
+						lineFromY = MAP_Y1 + resultNode2->node_y/locScale;
 						anim_line.draw_line(&vga_back, lineFromX, lineFromY, lineToX, lineToY, 0, 2);
 						lineToX = lineFromX;
 						lineToY = lineFromY;
@@ -394,8 +395,8 @@ void UnitArray::draw_dot()
 		if( !unitPtr || !unitPtr->is_visible() || unitPtr->is_shealth())
 			continue;
 
-		mapX = MAP_X1 + unitPtr->cur_x_loc();
-		mapY = MAP_Y1 + unitPtr->cur_y_loc();
+		mapX = MAP_X1 + unitPtr->cur_x_loc()/locScale;
+		mapY = MAP_Y1 + unitPtr->cur_y_loc()/locScale;
 
 		if( mapX == MAP_WIDTH-1 )
 			mapX = MAP_WIDTH-2;
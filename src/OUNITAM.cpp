@@ -33,6 +33,7 @@
 #include <OWORLD.h>
 #include <OTERRAIN.h>
 #include <OUNIT.h>
+#include <OSPFLOW.h>
 #include <dbglog.h>
 
 DBGLOG_DEFAULT_CHANNEL(Unit);
@@ -522,6 +523,19 @@ void UnitArray::move_to_now(int destXLoc, int destYLoc, short* selectedUnitArray
 		construct_sorted_array(selectedSizeOneUnitArray, sizeOneSelectedCount);	// distance and sorted_member should be initialized first
 		err_when(x<0 || y<0 || x>=MAX_WORLD_X_LOC || y>=MAX_WORLD_Y_LOC);
 
+		//------------------------------------------------------------------//
+		// for a large group of land units, build a flow field shared by the
+		// whole group instead of reusing the path of the leader
+		//------------------------------------------------------------------//
+		int useFlowField = 0;
+
+		if(mobileType==UNIT_LAND && sizeOneSelectedCount>=FLOW_FIELD_MIN_UNIT)
+		{
+			unitPtr = (Unit*) get_ptr(selectedSizeOneUnitArray[0]);
+			useFlowField = flow_field.build(curGroupId, destX, destY, square_size,
+										unitPtr->ignore_power_nation ? 0 : unitPtr->nation_recno);
+		}
+
 		//------------ process the movement -----------//
 		unprocessCount = sizeOneSelectedCount;//selectedCount;
 		k=0;
@@ -546,7 +560,7 @@ void UnitArray::move_to_now(int destXLoc, int destYLoc, short* selectedUnitArray
 						}while(unitPtr->sprite_info->loc_width>1);
 						
 						err_when(k>sizeOneSelectedCount);
-						if(sizeOneSelectedCount>1)
+						if(sizeOneSelectedCount>1 && !useFlowField)
 						{
 							if(unprocessCount==sizeOneSelectedCount) // the first unit to move
 							{	
@@ -594,7 +608,7 @@ void UnitArray::move_to_now(int destXLoc, int destYLoc, short* selectedUnitArray
 						}while(unitPtr->sprite_info->loc_width>1);
 						err_when(k>sizeOneSelectedCount);
 
-						if(sizeOneSelectedCount>1)
+						if(sizeOneSelectedCount>1 && !useFlowField)
 						{
 							if(unprocessCount==sizeOneSelectedCount) // the first unit to move
 							{
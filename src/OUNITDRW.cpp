@@ -33,6 +33,7 @@
 #include <ONATION.h>
 #include <OUNIT.h>
 #include <OCONFIG.h>
+#include <OSPRSPAN.h>
 
 #ifdef NO_DEBUG_UNIT
 #undef err_when
@@ -59,6 +60,7 @@ void Unit::draw()
 	int needMirror;
 	SpriteFrame* spriteFrame = cur_sprite_frame(&needMirror);
 	update_abs_pos(spriteFrame);
+	interpolate_abs_pos();
 
 	err_when(!sprite_info->res_bitmap.initialized()); 
 
@@ -91,12 +93,12 @@ void Unit::draw()
 	{
 		if( needMirror )	// if this direction needed to be mirrored
 		{
-			vga_back.put_bitmap_area_trans_remap_decompress_hmirror( x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
-				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable );
+			sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
+				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable, 1 );
 		}
 		else
 		{
-			vga_back.put_bitmap_area_trans_remap_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
+			sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
 				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable );
 		}
 	}
@@ -109,12 +111,12 @@ void Unit::draw()
 
 		if( needMirror )  // if this direction needed to be mirrored
 		{
-			vga_back.put_bitmap_trans_remap_decompress_hmirror( x1+ZOOM_X1, y1+ZOOM_Y1,
-												bitmapPtr, colorRemapTable );
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1,
+												bitmapPtr, colorRemapTable, 1 );
 		}
 		else
 		{
-			vga_back.put_bitmap_trans_remap_decompress( x1+ZOOM_X1, y1+ZOOM_Y1,
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1,
 												bitmapPtr, colorRemapTable );
 		}
 	}
@@ -224,6 +226,15 @@ void Unit::draw_selected()
 			dispY1 -= 20;
 	}
 
+	//---- follow the interpolated display position of a moving unit ----//
+
+	int offsetX, offsetY;
+
+	get_draw_offset(&offsetX, &offsetY);
+
+	dispX1 += offsetX;
+	dispY1 += offsetY;
+
 	//----------- set other vars -----------//
 
 	char* dataPtr = sys.common_data_buf;
@@ -365,7 +376,7 @@ void Unit::draw_skill_icon()
 //----------- Begin of function Unit::is_visible ----------//
 int Unit::is_shealth()
 {
-	return config.fog_of_war && world.get_loc(next_x_loc(), next_y_loc())->visibility() < unit_res[unit_id]->shealth;
+	return config.fog_of_war && world.get_visibility(next_x_loc(), next_y_loc()) < unit_res[unit_id]->shealth;
 }
 //----------- End of function Unit::is_visible ----------//
 
@@ -379,6 +390,7 @@ void Unit::draw_outlined()
 	int needMirror;
 	SpriteFrame* spriteFrame = cur_sprite_frame(&needMirror);
 	update_abs_pos(spriteFrame);
+	interpolate_abs_pos();
 
 	err_when(!sprite_info->res_bitmap.initialized()); 
 
@@ -411,12 +423,12 @@ void Unit::draw_outlined()
 	{
 		if( needMirror )	// if this direction needed to be mirrored
 		{
-			vga_back.put_bitmap_area_trans_remap_decompress_hmirror( x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
-				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable );
+			sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
+				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable, 1 );
 		}
 		else
 		{
-			vga_back.put_bitmap_area_trans_remap_decompress( x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
+			sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1, bitmapPtr,
 				MAX(0,x1)-x1, MAX(0,y1)-y1, MIN(ZOOM_WIDTH-1,x2)-x1, MIN(ZOOM_HEIGHT-1,y2)-y1, colorRemapTable );
 		}
 	}
@@ -429,12 +441,12 @@ void Unit::draw_outlined()
 
 		if( needMirror )  // if this direction needed to be mirrored
 		{
-			vga_back.put_bitmap_trans_remap_decompress_hmirror( x1+ZOOM_X1, y1+ZOOM_Y1,
-												bitmapPtr, colorRemapTable );
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1,
+												bitmapPtr, colorRemapTable, 1 );
 		}
 		else
 		{
-			vga_back.put_bitmap_trans_remap_decompress( x1+ZOOM_X1, y1+ZOOM_Y1,
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x1+ZOOM_X1, y1+ZOOM_Y1,
 												bitmapPtr, colorRemapTable );
 		}
 	}
@@ -0,0 +1,311 @@
+/*
+ * Seven Kingdoms: Ancient Adversaries
+ *
+ * Copyright 1997,1998 Enlight Software Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//Filename    : OUNITGRD.CPP
+//Description : Object UnitGrid, coarse grid of unit locations by nation
+
+#include <string.h>
+#include <ALL.h>
+#include <OWORLD.h>
+#include <OUNIT.h>
+#include <OPROFILE.h>
+#include <OUNITGRD.h>
+
+//-------- Begin of function UnitGrid::UnitGrid --------//
+
+UnitGrid::UnitGrid()
+{
+	memset( this, 0, sizeof(UnitGrid) );
+}
+//--------- End of function UnitGrid::UnitGrid ---------//
+
+
+//-------- Begin of function UnitGrid::~UnitGrid --------//
+
+UnitGrid::~UnitGrid()
+{
+	deinit();
+}
+//--------- End of function UnitGrid::~UnitGrid ---------//
+
+
+//-------- Begin of function UnitGrid::init --------//
+//
+// Called by World::assign_map() when a map is generated or loaded. The
+// units and firms may not have been loaded yet, so the counts are only
+// rebuilt when they are next used.
+//
+void UnitGrid::init()
+{
+	deinit();
+
+	cell_x_count = (MAX_WORLD_X_LOC + (1<<UNIT_GRID_CELL_SHIFT) - 1) >> UNIT_GRID_CELL_SHIFT;
+	cell_y_count = (MAX_WORLD_Y_LOC + (1<<UNIT_GRID_CELL_SHIFT) - 1) >> UNIT_GRID_CELL_SHIFT;
+
+	int cellCount = cell_x_count * cell_y_count;
+
+	unit_count_array  = (uint16_t*) mem_add( sizeof(uint16_t) * cellCount * (MAX_NATION+1) );
+	total_count_array = (uint16_t*) mem_add( sizeof(uint16_t) * cellCount );
+	firm_count_array  = (uint16_t*) mem_add( sizeof(uint16_t) * cellCount );
+
+	rebuild_flag = 1;
+}
+//--------- End of function UnitGrid::init ---------//
+
+
+//-------- Begin of function UnitGrid::deinit --------//
+
+void UnitGrid::deinit()
+{
+	if( unit_count_array )
+	{
+		mem_del( unit_count_array );
+		mem_del( total_count_array );
+		mem_del( firm_count_array );
+
+		unit_count_array  = NULL;
+		total_count_array = NULL;
+		firm_count_array  = NULL;
+	}
+}
+//--------- End of function UnitGrid::deinit ---------//
+
+
+//-------- Begin of function UnitGrid::rebuild --------//
+//
+// Count the units and firms on the whole location matrix.
+//
+void UnitGrid::rebuild()
+{
+	PROFILE_SCOPE("UnitGrid::rebuild");
+
+	int cellCount = cell_x_count * cell_y_count;
+
+	memset( unit_count_array, 0, sizeof(uint16_t) * cellCount * (MAX_NATION+1) );
+	memset( total_count_array, 0, sizeof(uint16_t) * cellCount );
+	memset( firm_count_array, 0, sizeof(uint16_t) * cellCount );
+
+	rebuild_flag = 0;
+
+	Unit* unitPtr;
+
+	for( int yLoc=0 ; yLoc<MAX_WORLD_Y_LOC ; yLoc++ )
+	{
+		Location* locPtr = world.get_loc(0, yLoc);
+
+		for( int xLoc=0 ; xLoc<MAX_WORLD_X_LOC ; xLoc++, locPtr++ )
+		{
+			if( locPtr->air_cargo_recno && (unitPtr = (Unit*) unit_array.get_ptr(locPtr->air_cargo_recno)) )
+				add_unit_count( xLoc, yLoc, unitPtr->nation_recno, 1 );
+
+			if( locPtr->is_firm() )
+				firm_count_array[get_cell(xLoc, yLoc)]++;
+
+			else if( !(locPtr->loc_flag & LOCATE_BLOCK_MASK) && locPtr->cargo_recno &&
+						(unitPtr = (Unit*) unit_array.get_ptr(locPtr->cargo_recno)) )
+			{
+				add_unit_count( xLoc, yLoc, unitPtr->nation_recno, 1 );
+			}
+		}
+	}
+}
+//--------- End of function UnitGrid::rebuild ---------//
+
+
+//-------- Begin of function UnitGrid::add_unit_count --------//
+
+void UnitGrid::add_unit_count(int xLoc, int yLoc, int nationRecno, int addCount)
+{
+	int cellId = get_cell(xLoc, yLoc);
+	uint16_t* countPtr = unit_count_array + cellId * (MAX_NATION+1) + nationRecno;
+
+	if( addCount < 0 && (!*countPtr || !total_count_array[cellId]) )
+	{
+		rebuild_flag = 1;			// the counts are out of step with the location matrix
+		return;
+	}
+
+	*countPtr += addCount;
+	total_count_array[cellId] += addCount;
+}
+//--------- End of function UnitGrid::add_unit_count ---------//
+
+
+//-------- Begin of function UnitGrid::set_unit_loc --------//
+//
+// Called by World::set_unit_recno() when the unit on a location changes.
+//
+// <int> xLoc, yLoc    - the location
+// <int> oldUnitRecno  - recno of the unit which was on the location, 0 if none
+// <int> newUnitRecno  - recno of the unit which is now on the location, 0 if none
+//
+void UnitGrid::set_unit_loc(int xLoc, int yLoc, int oldUnitRecno, int newUnitRecno)
+{
+	if( !unit_count_array || rebuild_flag || oldUnitRecno==newUnitRecno )
+		return;
+
+	Unit* unitPtr;
+
+	if( oldUnitRecno )
+	{
+		if( (unitPtr = (Unit*) unit_array.get_ptr(oldUnitRecno)) )
+			add_unit_count( xLoc, yLoc, unitPtr->nation_recno, -1 );
+		else
+			rebuild_flag = 1;
+	}
+
+	if( newUnitRecno )
+	{
+		if( (unitPtr = (Unit*) unit_array.get_ptr(newUnitRecno)) )
+			add_unit_count( xLoc, yLoc, unitPtr->nation_recno, 1 );
+		else
+			rebuild_flag = 1;
+	}
+}
+//--------- End of function UnitGrid::set_unit_loc ---------//
+
+
+//-------- Begin of function UnitGrid::set_firm_loc --------//
+//
+// Called by Location::set_firm() and Location::remove_firm().
+//
+// <Location*> locPtr   - the location
+// <int>       addCount - 1 if a firm is set on it, -1 if it is removed
+//
+void UnitGrid::set_firm_loc(Location* locPtr, int addCount)
+{
+	if( !unit_count_array || rebuild_flag )
+		return;
+
+	Location* locMatrix = world.loc_matrix;
+
+	if( !locMatrix || locPtr < locMatrix || locPtr >= locMatrix + MAX_WORLD_X_LOC*MAX_WORLD_Y_LOC )
+		return;
+
+	int locIndex = int(locPtr - locMatrix);
+	uint16_t* countPtr = firm_count_array + get_cell( locIndex % MAX_WORLD_X_LOC, locIndex / MAX_WORLD_X_LOC );
+
+	if( addCount < 0 && !*countPtr )
+		rebuild_flag = 1;
+	else
+		*countPtr += addCount;
+}
+//--------- End of function UnitGrid::set_firm_loc ---------//
+
+
+//-------- Begin of function UnitGrid::change_unit_nation --------//
+//
+// Called by Unit::change_nation() before the nation of the unit changes.
+// Move the counts of the locations it occupies to the new nation.
+//
+void UnitGrid::change_unit_nation(Unit* unitPtr, int newNationRecno)
+{
+	if( !unit_count_array || rebuild_flag || !unitPtr->is_visible() ||
+		 unitPtr->nation_recno==newNationRecno )
+	{
+		return;
+	}
+
+	int xLoc1 = unitPtr->next_x_loc(), yLoc1 = unitPtr->next_y_loc();
+	int xLoc2 = MIN(xLoc1+unitPtr->sprite_info->loc_width, MAX_WORLD_X_LOC);
+	int yLoc2 = MIN(yLoc1+unitPtr->sprite_info->loc_height, MAX_WORLD_Y_LOC);
+
+	for( int yLoc=yLoc1 ; yLoc<yLoc2 ; yLoc++ )
+	{
+		for( int xLoc=xLoc1 ; xLoc<xLoc2 ; xLoc++ )
+		{
+			if( world.get_unit_recno(xLoc, yLoc, unitPtr->mobile_type) == unitPtr->sprite_recno )
+			{
+				add_unit_count( xLoc, yLoc, unitPtr->nation_recno, -1 );
+				add_unit_count( xLoc, yLoc, newNationRecno, 1 );
+			}
+		}
+	}
+}
+//--------- End of function UnitGrid::change_unit_nation ---------//
+
+
+//-------- Begin of function UnitGrid::has_other_nation_unit --------//
+//
+// Whether there may be a unit not of the given nation in the given area.
+// The area is rounded up to whole cells, so the answer may be 1 when
+// there is no such unit in the area itself, but never 0 when there is.
+//
+int UnitGrid::has_other_nation_unit(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int nationRecno)
+{
+	if( !unit_count_array )
+		return 1;
+
+	if( rebuild_flag )
+		rebuild();
+
+	int cellX1 = MAX(xLoc1, 0) >> UNIT_GRID_CELL_SHIFT;
+	int cellY1 = MAX(yLoc1, 0) >> UNIT_GRID_CELL_SHIFT;
+	int cellX2 = MIN(xLoc2, MAX_WORLD_X_LOC-1) >> UNIT_GRID_CELL_SHIFT;
+	int cellY2 = MIN(yLoc2, MAX_WORLD_Y_LOC-1) >> UNIT_GRID_CELL_SHIFT;
+
+	for( int cellY=cellY1 ; cellY<=cellY2 ; cellY++ )
+	{
+		int cellId = cellY * cell_x_count + cellX1;
+
+		for( int cellX=cellX1 ; cellX<=cellX2 ; cellX++, cellId++ )
+		{
+			if( total_count_array[cellId] > unit_count_array[cellId*(MAX_NATION+1)+nationRecno] )
+				return 1;
+		}
+	}
+
+	return 0;
+}
+//--------- End of function UnitGrid::has_other_nation_unit ---------//
+
+
+//-------- Begin of function UnitGrid::has_firm --------//
+//
+// Whether there may be a firm in the given area, rounded up to whole
+// cells as in has_other_nation_unit().
+//
+int UnitGrid::has_firm(int xLoc1, int yLoc1, int xLoc2, int yLoc2)
+{
+	if( !unit_count_array )
+		return 1;
+
+	if( rebuild_flag )
+		rebuild();
+
+	int cellX1 = MAX(xLoc1, 0) >> UNIT_GRID_CELL_SHIFT;
+	int cellY1 = MAX(yLoc1, 0) >> UNIT_GRID_CELL_SHIFT;
+	int cellX2 = MIN(xLoc2, MAX_WORLD_X_LOC-1) >> UNIT_GRID_CELL_SHIFT;
+	int cellY2 = MIN(yLoc2, MAX_WORLD_Y_LOC-1) >> UNIT_GRID_CELL_SHIFT;
+
+	for( int cellY=cellY1 ; cellY<=cellY2 ; cellY++ )
+	{
+		int cellId = cellY * cell_x_count + cellX1;
+
+		for( int cellX=cellX1 ; cellX<=cellX2 ; cellX++, cellId++ )
+		{
+			if( firm_count_array[cellId] )
+				return 1;
+		}
+	}
+
+	return 0;
+}
+//--------- End of function UnitGrid::has_firm ---------//
@@ -47,6 +47,10 @@
 #undef DEBUG
 #endif
 
+//----------- Define constants -------------//
+
+#define HELP_DISTANCE	15		// an idle unit helps its nation's units attacking a target within this distance
+
 //-------------- define static variables -----------//
 static char		idle_detect_has_unit;
 static char		idle_detect_has_firm;
@@ -673,6 +677,25 @@ int Unit::idle_detect_attack(int startLoc, int dimensionInput, char defenseMode)
 				action_mode2!=ACTION_DEFEND_TOWN_DETECT_TARGET && action_mode2!=ACTION_MONSTER_DEFEND_DETECT_TARGET);
 
 	err_when(incAmount<1 || incAmount>100000);
+
+	//-----------------------------------------------------------------------------------------------//
+	// If there is no unit of other nations in the square or within the help distance, and no firm in
+	// the square, scanning the square would find nothing. Our own units can only be helped when they
+	// attack a target of another nation within the help distance.
+	//-----------------------------------------------------------------------------------------------//
+
+	int halfDimension = dimension>>1;
+
+	if( !unit_grid.has_firm(move_to_x_loc-halfDimension, move_to_y_loc-halfDimension,
+									move_to_x_loc+halfDimension, move_to_y_loc+halfDimension) &&
+		 !unit_grid.has_other_nation_unit(MIN(move_to_x_loc-halfDimension, next_x_loc()-HELP_DISTANCE),
+													 MIN(move_to_y_loc-halfDimension, next_y_loc()-HELP_DISTANCE),
+													 MAX(move_to_x_loc+halfDimension, next_x_loc()+HELP_DISTANCE),
+													 MAX(move_to_y_loc+halfDimension, next_y_loc()+HELP_DISTANCE), nation_recno) )
+	{
+		i = countLimit+1;		// skip the scan
+	}
+
    for(; i<=countLimit; i+=incAmount) // 1 is the self location
    {
       misc.cal_move_around_a_point(i, dimension, dimension, xOffset, yOffset);
@@ -1181,8 +1204,6 @@ int Unit::idle_detect_choose_target(char defenseMode)
 //
 void Unit::idle_detect_helper_attack(short unitRecno)
 {
-	#define HELP_DISTANCE	15
-
    Unit *unitPtr = unit_array[unitRecno];
    if(unitPtr->unit_id == UNIT_CARAVAN)
       return;
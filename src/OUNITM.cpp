@@ -30,6 +30,10 @@
 #include <OU_MARI.h>
 #include <OSPATH.h>
 #include <OSPREUSE.h>
+#include <OSPHPA.h>
+#include <OSPFLOW.h>
+#include <OSPCACHE.h>
+#include <OSPLOG.h>
 #include <OSERES.h>
 #include <OLOG.h>
 #include <OEFFECT.h>
@@ -66,6 +70,7 @@ static short cycle_wait_unit_array_multipler;
 
 
 static char	 move_action_call_flag=0; // avoid calling move_to_my_loc() if this function is called from move_to() chain
+static char	 search_path_incomplete=0; // set by searching() if the path only leads to a way point or the search is suspended
 
 
 //--------- Begin of function Unit::reset_action_para ---------//
@@ -500,6 +505,7 @@ void Unit::move_to(int destX, int destY, int preserveAction, short searchMode, s
 	action_mode2 = ACTION_MOVE;
 	action_para2 = 0;
 	
+	search_path_incomplete = 0;
 	int enoughNode = search(destXLoc, destYLoc, preserveAction, searchMode, miscNo, numOfPath, reuseMode, pathReuseStatus);
 	move_action_call_flag = 0; // clear the flag
 
@@ -509,8 +515,10 @@ void Unit::move_to(int destX, int destY, int preserveAction, short searchMode, s
 	action_mode = ACTION_MOVE;
 	action_para = 0;
 	
-	if(!enoughNode || (searchMode==SEARCH_MODE_REUSE && seek_path_reuse.get_reuse_path_status()==REUSE_PATH_INCOMPLETE_SEARCH))
+	if(!enoughNode || search_path_incomplete ||
+		(searchMode==SEARCH_MODE_REUSE && seek_path_reuse.get_reuse_path_status()==REUSE_PATH_INCOMPLETE_SEARCH))
 	{
+		//--- keep the real destination, the order is repeated by reactivate_idle_action() when the unit becomes idle ---//
 		action_x_loc = action_x_loc2 = destXLoc;
 		action_y_loc = action_y_loc2 = destYLoc;
 	}
@@ -753,8 +761,10 @@ int Unit::searching(int destXLoc, int destYLoc, int preserveAction, short search
 
 	//------------------------ find the shortest path --------------------------//
 	//
-	// Note: seek() will never return PATH_SEEKING as the maxTries==max_node in
-	//       calling seek()
+	// Note: seek() returns PATH_SEEKING if a long land search has used up the
+	//       nodes of this frame. No path is returned and the unit stays idle;
+	//       the search is resumed when reactivate_idle_action() repeats the
+	//       same order in a later frame.
 	//
 	// decide the searching to use according to the unit size
 	// assume the unit size is always 1x1, 2x2, 3x3 and so on
@@ -777,10 +787,79 @@ int Unit::searching(int destXLoc, int destYLoc, int preserveAction, short search
 					{
 						if(mobile_type==UNIT_LAND)
 							select_search_sub_mode(startXLocLoc, startYLocLoc, destXLoc, destYLoc, nation_recno, searchMode);
-						seekResult = seek_path.seek(startXLocLoc, startYLocLoc, destXLoc, destYLoc, unit_group_id,
-															mobile_type, searchMode, miscNo, numOfPath, unit_search_tries);
 
-						result_node_array = seek_path.get_result(result_node_count, result_path_dist);
+						//------------------------------------------------------------------------//
+						// units of a large group move order follow the flow field of the group
+						// until they are close to their formation locations
+						//------------------------------------------------------------------------//
+						if(searchMode==SEARCH_MODE_IN_A_GROUP && mobile_type==UNIT_LAND && sprite_info->loc_width==1 &&
+							(result_node_array = flow_field.get_path(unit_group_id, startXLocLoc, startYLocLoc, destXLoc, destYLoc,
+																				  result_node_count, result_path_dist)) != NULL)
+						{
+							ResultNode* lastNode = result_node_array + result_node_count - 1;
+
+							seekResult = PATH_FOUND;
+							search_path_incomplete = lastNode->node_x!=destXLoc || lastNode->node_y!=destYLoc;
+						}
+						else
+						{
+							//------------------------------------------------------------------------//
+							// for a long distance move, only search to the next way point of the
+							// cluster path. The unit carries on from there when it becomes idle.
+							//------------------------------------------------------------------------//
+							int	seekXLoc=destXLoc, seekYLoc=destYLoc, wayXLoc, wayYLoc;
+							short	seekMode=searchMode, seekMiscNo=miscNo, seekNumOfPath=numOfPath;
+
+							if(searchMode!=SEARCH_MODE_TO_LAND_FOR_SHIP &&
+								seek_path_hpa.get_way_point(startXLocLoc, startYLocLoc, destXLoc, destYLoc, mobile_type, wayXLoc, wayYLoc) &&
+								seek_path.is_territory_passable(wayXLoc, wayYLoc))
+							{
+								seekXLoc = wayXLoc;
+								seekYLoc = wayYLoc;
+
+								if(searchMode>=SEARCH_MODE_TO_FIRM)	// the way point is not the building or target, move there normally
+								{
+									seekMode = SEARCH_MODE_IN_A_GROUP;
+									seekMiscNo = 0;
+									seekNumOfPath = 1;
+								}
+							}
+
+							if(seek_path_log.is_recording())
+							{
+								seek_path_log.record(startXLocLoc, startYLocLoc, seekXLoc, seekYLoc, unit_group_id,
+															mobile_type, seekMode, seekMiscNo, seekNumOfPath, unit_search_tries);
+							}
+
+							int cacheable = SeekPathCache::is_cacheable(seekMode, mobile_type);
+
+							if(cacheable &&
+								(result_node_array = seek_path_cache.get_path(startXLocLoc, startYLocLoc, seekXLoc, seekYLoc, mobile_type,
+																							 seekMode, seekMiscNo, seekNumOfPath, seek_path.get_sub_mode(),
+																							 seek_path.get_nation_passable(), result_node_count, result_path_dist)) != NULL)
+							{
+								seekResult = PATH_FOUND;
+							}
+							else
+							{
+								seek_path.set_resume_owner(sprite_recno);
+								seekResult = seek_path.seek(startXLocLoc, startYLocLoc, seekXLoc, seekYLoc, unit_group_id,
+																	mobile_type, seekMode, seekMiscNo, seekNumOfPath, unit_search_tries);
+								seek_path.set_resume_owner(); // reset resumable searching
+
+								result_node_array = seek_path.get_result(result_node_count, result_path_dist);
+
+								if(cacheable && seekResult==PATH_FOUND && result_node_array)
+								{
+									seek_path_cache.add_path(startXLocLoc, startYLocLoc, seekXLoc, seekYLoc, mobile_type,
+																	 seekMode, seekMiscNo, seekNumOfPath, seek_path.get_sub_mode(),
+																	 seek_path.get_nation_passable(), result_node_array, result_node_count, result_path_dist);
+								}
+							}
+
+							//--- the unit has to carry on when it arrives, unless it cannot move towards the way point at all ---//
+							search_path_incomplete = seekResult==PATH_SEEKING || (result_node_array && (seekXLoc!=destXLoc || seekYLoc!=destYLoc));
+						}
 						seek_path.set_sub_mode(); // reset sub_mode searching
 					}
 					else	// use path_reuse
@@ -811,7 +890,7 @@ int Unit::searching(int destXLoc, int destYLoc, int preserveAction, short search
 	// update ignore_power_nation,seek_path_fail_count
 	//-----------------------------------------------------------------------//
 
-	if(ai_unit)
+	if(ai_unit && seekResult!=PATH_SEEKING)		// the result is not known yet if the search is suspended
 	{
 		//----- set seek_path_fail_count ------//
 
@@ -103,7 +103,7 @@ void Unit::assign_to_ship(int destX, int destY, short shipRecno, int miscNo)
 		{
 			int checkXLoc, checkYLoc;
 			Location *locPtr = world.get_loc(next_x_loc(), next_y_loc());
-			uint8_t regionId = locPtr->region_id;
+			uint16_t regionId = locPtr->region_id;
 			for(int i=2; i<=9; i++)
 			{
 				misc.cal_move_around_a_point(i, 3, 3, xShift, yShift);
@@ -295,7 +295,7 @@ void Unit::ship_to_beach(int destX, int destY, int& finalDestX, int& finalDestY)
 		// get a suitable location in the territory as a reference location
 		//-----------------------------------------------------------------------------//
 		Location *locPtr = world.get_loc(destX, destY);
-		uint8_t regionId = locPtr->region_id;
+		uint16_t regionId = locPtr->region_id;
 		int xStep = curXLoc-destX;
 		int yStep = curYLoc-destY;
 		int absXStep = abs(xStep);
@@ -361,12 +361,12 @@ void Unit::ship_to_beach(int destX, int destY, int& finalDestX, int& finalDestY)
 //
 // <int&>	resultXLoc	-	reference to return final x location the ship move to
 // <int&>	resultYLoc	-	reference to return final y location the ship move to
-// <UCHAR>	regionId		-	region id of the destination location
+// <uint16_t>	regionId		-	region id of the destination location
 //
 // return 1 if normal execution
 // return 0 if calling move_to() instead
 //
-int Unit::ship_to_beach_path_edit(int& resultXLoc, int& resultYLoc, uint8_t regionId)
+int Unit::ship_to_beach_path_edit(int& resultXLoc, int& resultYLoc, uint16_t regionId)
 {
 	int curXLoc = next_x_loc();
 	int curYLoc = next_y_loc();
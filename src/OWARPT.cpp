@@ -33,8 +33,8 @@
 // divide the map into zone, each zone has size WARPOINT_ZONE_SIZE
 
 #define WARPOINT_ZONE_SIZE 8
-#define WARPOINT_ZONE_COLUMN ((MAX_MAP_WIDTH + WARPOINT_ZONE_SIZE -1) / WARPOINT_ZONE_SIZE)
-#define WARPOINT_ZONE_ROW ((MAX_MAP_HEIGHT + WARPOINT_ZONE_SIZE -1) / WARPOINT_ZONE_SIZE)
+#define WARPOINT_ZONE_COLUMN ((MAX_WORLD_LOC_SIZE + WARPOINT_ZONE_SIZE -1) / WARPOINT_ZONE_SIZE)
+#define WARPOINT_ZONE_ROW ((MAX_WORLD_LOC_SIZE + WARPOINT_ZONE_SIZE -1) / WARPOINT_ZONE_SIZE)
 
 #define WARPOINT_STRENGTH 0x100000
 #define WARPOINT_STRENGTH_MAX 0x1000000
@@ -117,23 +117,37 @@ void WarPointArray::draw_dot()
 	unsigned char color = dotColor[draw_phase / 2];
 
 	int x,y;
-	short mapY;
+	short mapX, mapY;
 	unsigned char *writePtr;
 	unsigned char *vgaBufPtr = (unsigned char *)vga_back.buf_ptr();
 	int vgaBufPitch = vga_back.buf_pitch();
 
- 	for( y = 0, mapY=MAP_Y1; y < WARPOINT_ZONE_ROW; ++y, mapY+=WARPOINT_ZONE_SIZE)
+	// the zones cover MAP_LOC_SCALE times fewer pixels on the map of a huge world
+	int locScale = MAP_LOC_SCALE;
+	int crossSize = MAX(WARPOINT_ZONE_SIZE / locScale, 4);
+	int zoneColumn = (MAX_WORLD_X_LOC + WARPOINT_ZONE_SIZE -1) / WARPOINT_ZONE_SIZE;
+	int zoneRow = (MAX_WORLD_Y_LOC + WARPOINT_ZONE_SIZE -1) / WARPOINT_ZONE_SIZE;
+
+ 	for( y = 0; y < zoneRow; ++y )
 	{
+		mapY = MAP_Y1 + y * WARPOINT_ZONE_SIZE / locScale;
+		if( mapY + crossSize - 2 > MAP_Y2 )
+			break;
+
 		WarPoint *warPt = war_point + y * WARPOINT_ZONE_COLUMN;
-		writePtr = vgaBufPtr + vgaBufPitch * mapY + MAP_X1;
-		for( x = 0; x < WARPOINT_ZONE_COLUMN; ++x, ++warPt, writePtr+=WARPOINT_ZONE_SIZE)
+		for( x = 0; x < zoneColumn; ++x, ++warPt )
 		{
+			mapX = MAP_X1 + x * WARPOINT_ZONE_SIZE / locScale;
+			if( mapX + crossSize - 2 > MAP_X2 )
+				break;
+
 			if( warPt->strength > 0 )
 			{
 				// draw a cross, UNEXPLORED_COLOR is not needed to check
+				writePtr = vgaBufPtr + vgaBufPitch * mapY + mapX;
 				unsigned char *map1Ptr = writePtr;
-				unsigned char *map2Ptr = writePtr + WARPOINT_ZONE_SIZE-2;
-				for( int i = 1; i < WARPOINT_ZONE_SIZE; ++i )
+				unsigned char *map2Ptr = writePtr + crossSize-2;
+				for( int i = 1; i < crossSize; ++i )
 				{
 					*map1Ptr = color;
 					*map2Ptr = color;
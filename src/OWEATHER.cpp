@@ -26,7 +26,7 @@
 #include <OWEATHER.h>
 #include <ALL.h>
 #include <math.h>
-#include <OWORLDMT.h>
+#include <OWORLD.h>
 #include <stdlib.h>
 
 //---------- Define constant -----------//
@@ -99,8 +99,8 @@ void Weather::next_day()
 		if ( is_quake() )
 		{
 			// generate quake_x, quake_y
-			quake_x = rand_seed(0x10000) * MAX_MAP_WIDTH / 0x10000;
-			quake_y = rand_seed(0x10000) * MAX_MAP_HEIGHT / 0x10000;
+			quake_x = rand_seed(0x10000) * MAX_WORLD_X_LOC / 0x10000;
+			quake_y = rand_seed(0x10000) * MAX_WORLD_Y_LOC / 0x10000;
 		}
 	}
 	else
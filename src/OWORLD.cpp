@@ -43,6 +43,13 @@
 #include <OSERES.h>
 #include <OREMOTE.h>
 #include <ONEWS.h>
+#include <OPROFILE.h>
+#include <OSPHPA.h>
+#include <OSPFLOW.h>
+#include <OSPATH.h>
+#include <OSPREUSE.h>
+#include <OSPCACHE.h>
+#include <OLINKGRD.h>
 
 
 //------------ Define static class variables ------------//
@@ -55,12 +62,22 @@ int   World::max_x_loc=200, World::max_y_loc=200;
 World::World()
 {
 	loc_matrix = NULL;
+	visit_frame_matrix = NULL;
+	visit_frame_count = 0;
+	walk_matrix = NULL;
+	region_matrix = NULL;
+	fire_loc_matrix = NULL;
+	fire_row_count_array = NULL;
+	fire_loc_count = 0;
 	next_scroll_time = 0;
 	scan_fire_x = 0;
 	scan_fire_y = 0;
 	lightning_signal = 0;
 	plant_count = 0;
 	plant_limit = 0;
+	plant_loc_bits = NULL;
+	plant_bits_pitch = 0;
+	plant_full_scan = 0;
 
    //------- initialize matrix objects -------//
 
@@ -116,6 +133,35 @@ void World::deinit()
       mem_del( loc_matrix );
       loc_matrix  = NULL;
    }
+
+   if( visit_frame_matrix )
+   {
+      mem_del( visit_frame_matrix );
+      visit_frame_matrix = NULL;
+   }
+
+   if( walk_matrix )
+   {
+      mem_del( walk_matrix );
+      mem_del( region_matrix );
+      walk_matrix   = NULL;
+      region_matrix = NULL;
+   }
+
+   if( fire_loc_matrix )
+   {
+      mem_del( fire_loc_matrix );
+      mem_del( fire_row_count_array );
+      fire_loc_matrix      = NULL;
+      fire_row_count_array = NULL;
+      fire_loc_count       = 0;
+   }
+
+   if( plant_loc_bits )
+   {
+      mem_del( plant_loc_bits );
+      plant_loc_bits = NULL;
+   }
 }
 //------------- End of function World::deinit -----------//
 
@@ -132,6 +178,44 @@ void World::assign_map()
    map_matrix-> assign_map(loc_matrix, max_x_loc, max_y_loc );
 	zoom_matrix->assign_map(loc_matrix, max_x_loc, max_y_loc );
 
+	//------ restart the fading of the fog of war ------//
+
+	visit_frame_matrix = (uint32_t*) mem_resize( visit_frame_matrix, max_x_loc * max_y_loc * sizeof(uint32_t) );
+	memset( visit_frame_matrix, 0, max_x_loc * max_y_loc * sizeof(uint32_t) );
+	visit_frame_count = 0;
+
+	//----- copy the hot fields of the locations to their own matrices -----//
+
+	walk_matrix   = (uint8_t*) mem_resize( walk_matrix, max_x_loc * max_y_loc );
+	region_matrix = (uint16_t*) mem_resize( region_matrix, max_x_loc * max_y_loc * sizeof(uint16_t) );
+
+	build_walk_matrix();
+	build_region_matrix();
+
+	//------ find the locations where fire is burning or cooling down ------//
+
+	fire_loc_matrix      = (uint8_t*) mem_resize( fire_loc_matrix, max_x_loc * max_y_loc );
+	fire_row_count_array = (short*) mem_resize( fire_row_count_array, max_y_loc * SCAN_FIRE_DIST * sizeof(short) );
+
+	build_fire_set();
+
+	//------------ register the plants on the map ------------//
+
+	plant_bits_pitch = (max_x_loc + 31) / 32;
+	plant_loc_bits   = (uint32_t*) mem_resize( plant_loc_bits, plant_bits_pitch * max_y_loc * sizeof(uint32_t) );
+
+	build_plant_set();
+
+	//------ rebuild the path seeking clusters for the new map ------//
+
+	seek_path_hpa.init();
+	flow_field.init();
+
+	//--- the units, firms and towns are counted again when the grids are next used ---//
+
+	unit_grid.init();
+	link_grid.init();
+
    //-------- set the zoom area box on map matrix ------//
 
    map_matrix->cur_x_loc = 0;
@@ -142,6 +226,46 @@ void World::assign_map()
 //----------- End of function World::assign_map ----------//
 
 
+//--------- Begin of function World::set_map_size ----------//
+//
+// Set the size of the map to be generated or loaded next. The data
+// structures sized by the last map are released, they are allocated
+// again for the new size by generate_map(), read_file() and assign_map().
+//
+// <int> xLoc, yLoc = the no. of locations across and down the map,
+//                    between MIN_WORLD_LOC_SIZE and MAX_WORLD_LOC_SIZE
+//
+void World::set_map_size(int xLoc, int yLoc)
+{
+	err_when( xLoc < MIN_WORLD_LOC_SIZE || xLoc > MAX_WORLD_LOC_SIZE );
+	err_when( yLoc < MIN_WORLD_LOC_SIZE || yLoc > MAX_WORLD_LOC_SIZE );
+
+	if( xLoc == max_x_loc && yLoc == max_y_loc )
+		return;
+
+	deinit();
+
+	seek_path_hpa.deinit();
+	flow_field.deinit();
+	unit_grid.deinit();
+	link_grid.deinit();
+	loc_sum.deinit();
+	seek_path_cache.clear();
+
+	max_x_loc = xLoc;
+	max_y_loc = yLoc;
+
+	//--- the node matrices of path seeking cover the whole map ---//
+
+	seek_path.deinit();
+	seek_path.init(MAX_BACKGROUND_NODE);
+
+	seek_path_reuse.deinit();
+	seek_path_reuse.init(MAX_BACKGROUND_NODE);
+}
+//----------- End of function World::set_map_size ----------//
+
+
 //----------- Begin of function World::paint ------------//
 //
 // Paint world window and scroll bars
@@ -172,16 +296,22 @@ void World::process()
 {
 	//-------- process wall ----------//
 
+	PROFILE_BEGIN("form_world_wall");
 	form_world_wall();
+	PROFILE_END();
 
 	//-------- process fire -----------//
 
 	// BUGHERE : set Location::flammability for every change in cargo
 
+	PROFILE_BEGIN("spread_fire");
 	world.spread_fire(weather);
+	PROFILE_END();
 
 	// ------- process visibility --------//
+	PROFILE_BEGIN("process_visibility");
 	process_visibility();
+	PROFILE_END();
 
 	//-------- process lightning ------//
 	// ###### begin Gilbert 11/8 ########//
@@ -192,7 +322,7 @@ void World::process()
 	}
 	if( lightning_signal == 106 && config.weather_effect)
 	{
-		lightning_strike(misc.random(MAX_MAP_WIDTH), misc.random(MAX_MAP_HEIGHT), 1);
+		lightning_strike(misc.random(MAX_WORLD_X_LOC), misc.random(MAX_WORLD_Y_LOC), 1);
 	}
 	if(lightning_signal == 100)
 		lightning_signal = 5 + misc.random(10);
@@ -223,7 +353,9 @@ void World::process()
 //
 void World::next_day()
 {
+   PROFILE_BEGIN("plant_ops");
    plant_ops();
+   PROFILE_END();
 
    weather = weather_forecast[0];
 
@@ -490,6 +622,8 @@ void World::explore(int xLoc1, int yLoc1, int xLoc2, int yLoc2)
 	int		tileYOffset;
 	Location	*northWestPtr;
 	char		tilePixel;
+	int		locScale = MAP_LOC_SCALE;
+	char		hiddenPixel;
 
 	for( yLoc=yLoc1 ; yLoc<=yLoc2 ; yLoc++ )
 	{
@@ -502,8 +636,14 @@ void World::explore(int xLoc1, int yLoc1, int xLoc2, int yLoc2)
 				locPtr->explored_on();
 
 				//-------- draw pixel ----------//
-
-				writePtr = imageBuf+MAP_WIDTH*yLoc+xLoc;
+				//
+				// The map of a huge world only shows one location
+				// out of each square of MAP_LOC_SCALE x MAP_LOC_SCALE.
+				//
+				if( xLoc % locScale == 0 && yLoc % locScale == 0 )
+					writePtr = imageBuf+MAP_WIDTH*(yLoc/locScale)+xLoc/locScale;
+				else
+					writePtr = &hiddenPixel;
 
 				switch( world.map_matrix->map_mode )
 				{
@@ -516,9 +656,9 @@ void World::explore(int xLoc1, int yLoc1, int xLoc2, int yLoc2)
 
 						else
 						{
-							tileYOffset = (yLoc & TERRAIN_TILE_Y_MASK) * TERRAIN_TILE_WIDTH;
+							tileYOffset = ((yLoc/locScale) & TERRAIN_TILE_Y_MASK) * TERRAIN_TILE_WIDTH;
 
-							tilePixel = terrain_res.get_map_tile(locPtr->terrain_id)[tileYOffset + (xLoc & TERRAIN_TILE_X_MASK)];
+							tilePixel = terrain_res.get_map_tile(locPtr->terrain_id)[tileYOffset + ((xLoc/locScale) & TERRAIN_TILE_X_MASK)];
 
 							if( xLoc == 0 || yLoc == 0)
 							{
@@ -752,18 +892,50 @@ inline int World::check_unit_space(int xLoc1, int yLoc1, int xLoc2, int yLoc2, i
 	if(yLoc2<0 || yLoc2>=MAX_WORLD_Y_LOC)
 		return 0;
 
-	Location* locPtr = world.get_loc(xLoc1, yLoc1);
+	//----- count the blocked locations of land units in loc_sum -----//
+
+	if( mobileType==UNIT_LAND && loc_sum.tree_array[LOC_SUM_LAND_UNIT] )
+		return !loc_sum.count( buildFlag ? LOC_SUM_LAND_BUILD : LOC_SUM_LAND_UNIT, xLoc1, yLoc1, xLoc2, yLoc2 );
+
+	//--- the bits a location must have, and the bits it must not have ---//
+
+	uint8_t needBits, checkBits;
+
+	switch( mobileType )
+	{
+		case UNIT_LAND:
+			needBits  = WALK_MATRIX_LAND;
+			checkBits = WALK_MATRIX_LAND | WALK_MATRIX_CARGO;
+			break;
+
+		case UNIT_SEA:
+			needBits  = WALK_MATRIX_SEA;
+			checkBits = WALK_MATRIX_SEA | WALK_MATRIX_CARGO;
+			break;
+
+		case UNIT_AIR:
+			needBits  = 0;
+			checkBits = WALK_MATRIX_AIR_CARGO;
+			break;
+
+		default:
+			return 0;
+	}
+
+	if( buildFlag )		// if build a firm/town, there must not be any sites in the area
+		checkBits |= WALK_MATRIX_POWER_OFF | WALK_MATRIX_SITE;
+
+	uint8_t* walkBits;
 	int x, y;
 	int canBuildFlag = 1;
 
 	for(y=yLoc1; y<=yLoc2; y++)
 	{
-		locPtr = world.get_loc(xLoc1, y);
+		walkBits = world.get_walk_bits(xLoc1, y);
 
-		for(x=xLoc1; x<=xLoc2; x++, locPtr++)
+		for(x=xLoc1; x<=xLoc2; x++, walkBits++)
 		{
-			if( !locPtr->can_move(mobileType) ||
-				 ( buildFlag && (locPtr->is_power_off() || locPtr->has_site()) ) ) 		// if build a firm/town, there must not be any sites in the area
+			if( (*walkBits & checkBits) != needBits )
 			{
 				canBuildFlag=0;
 				break;
@@ -1066,22 +1238,29 @@ int World::locate_space_random(int& xLoc1, int& yLoc1, int xLoc2, int yLoc2,
 
 		xTemp = xLoc+spaceLocWidth-1;
 
-		for( y=yLoc+spaceLocHeight-1; y>=yLoc; y-- )
+		if( !buildSite && teraMask==1 && loc_sum.tree_array[LOC_SUM_BUILD_FIRM] )
 		{
-			locPtr = world.get_loc(xTemp, y);
-
-			for(x=xTemp; x>=xLoc; x--, locPtr-- )
+			canBuildFlag = loc_sum.is_free(LOC_SUM_BUILD_FIRM, xLoc, yLoc, xTemp, yLoc+spaceLocHeight-1);
+		}
+		else
+		{
+			for( y=yLoc+spaceLocHeight-1; y>=yLoc; y-- )
 			{
-				if( ( buildSite ? !locPtr->can_build_site(teraMask) : !locPtr->can_build_firm(teraMask) ) ||
-					 locPtr->is_power_off() )
+				locPtr = world.get_loc(xTemp, y);
+
+				for(x=xTemp; x>=xLoc; x--, locPtr-- )
 				{
-					canBuildFlag=0;
-					break;
+					if( ( buildSite ? !locPtr->can_build_site(teraMask) : !locPtr->can_build_firm(teraMask) ) ||
+						 locPtr->is_power_off() )
+					{
+						canBuildFlag=0;
+						break;
+					}
 				}
-			}
 
-			if(!canBuildFlag)
-				break;
+				if(!canBuildFlag)
+					break;
+			}
 		}
 
 		if( !canBuildFlag )
@@ -1142,6 +1321,18 @@ int World::can_build_firm(int xLoc1, int yLoc1, int firmId, short unitRecno)
 	case 2:		// sea firm
 	case 3:		// land or sea firm
 		teraMask = firmInfo->tera_type;
+
+		//--- the whole area of a land firm can be checked in loc_sum ---//
+
+		if( teraMask==1 && yLoc2<max_y_loc && loc_sum.tree_array[LOC_SUM_BUILD_TOWN] )
+		{
+			if( loc_sum.is_free( firmId==FIRM_MINE ? LOC_SUM_BUILD_FIRM : LOC_SUM_BUILD_TOWN, xLoc1, yLoc1, xLoc2, yLoc2 ) )
+				return 1;
+
+			if( unitRecno == -1 )		// no builder standing on the area to take into account
+				return 0;
+		}
+
 		for( yLoc=yLoc1 ; yLoc<=yLoc2 ; yLoc++ )
 		{
 			locPtr = get_loc(xLoc1, yLoc);
@@ -1226,6 +1417,9 @@ int World::can_build_town(int xLoc1, int yLoc1, short unitRecno)
 	if(xLoc2>=max_x_loc || yLoc2>=max_y_loc)
 		return 0;
 
+	if( loc_sum.is_free(LOC_SUM_BUILD_TOWN, xLoc1, yLoc1, xLoc2, yLoc2) )
+		return 1;
+
 	Location* locPtr;
 
 	for( yLoc=yLoc1 ; yLoc<=yLoc2 ; yLoc++ )
@@ -1503,6 +1697,7 @@ void World::set_power(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int nationRecn
 	int	plateauResult = (get_loc((xLoc1+xLoc2)/2, (yLoc1+yLoc2)/2)->is_plateau()==1);
 
 	int   	 xLoc, yLoc, centerY, t;
+	int		 powerChanged = 0;
 	Location* locPtr = loc_matrix;
 
 	xLoc1 = MAX( 0, xLoc1 - EFFECTIVE_POWER_DISTANCE+1);
@@ -1533,9 +1728,13 @@ void World::set_power(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int nationRecn
 			{
 				locPtr->power_nation_recno = nationRecno;
 				sys.map_need_redraw = 1;						// request redrawing the map next time
+				powerChanged = 1;
 			}
 		}
 	}
+
+	if( powerChanged )
+		seek_path_cache.invalidate_power(xLoc1, yLoc1, xLoc2, yLoc2);
 }
 //--------- End of function World::set_power ---------//
 
@@ -1566,6 +1765,7 @@ void World::restore_power(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int townRe
 	//------- reset power_nation_recno first ------//
 
 	int   	 xLoc, yLoc, centerY, t;
+	int		 powerChanged = 0;
 	Location* locPtr = loc_matrix;
 
 	xLoc1 = MAX( 0, xLoc1 - EFFECTIVE_POWER_DISTANCE+1);
@@ -1587,10 +1787,14 @@ void World::restore_power(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int townRe
 			{
 				locPtr->power_nation_recno = 0;
 				sys.map_need_redraw = 1;						// request redrawing the map next time
+				powerChanged = 1;
 			}
 		}
 	}
 
+	if( powerChanged )
+		seek_path_cache.invalidate_power(xLoc1, yLoc1, xLoc2, yLoc2);
+
 	//--- if some power areas are freed up, see if neighbor towns/firms should take up these power areas ----//
 
 	if( sys.map_need_redraw )	// when calls set_all_power(), the nation_recno of the calling firm must be reset
@@ -1968,7 +2172,7 @@ void World::visit(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int range, int ext
 			Location *locPtr = get_loc(left, yLoc);
 			for( int xLoc=left ; xLoc<=right ; xLoc++, locPtr++ )
 			{
-				locPtr->set_visited();
+				set_visited(locPtr);
 			}
 		}
 
@@ -2010,7 +2214,7 @@ void World::visit_shell(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int visitLev
 	{
 		Location *locPtr = get_loc( left, yLoc1);
 		for( int x = left; x <= right; ++x, ++locPtr)
-			locPtr->set_visited(visitLevel);
+			set_visited(locPtr, visitLevel);
 	}
 
 	// ------- bottom side ---------//
@@ -2018,7 +2222,7 @@ void World::visit_shell(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int visitLev
 	{
 		Location *locPtr = get_loc( left, yLoc2);
 		for( int x = left; x <= right; ++x, ++locPtr)
-			locPtr->set_visited(visitLevel);
+			set_visited(locPtr, visitLevel);
 	}
 
 	// ------- left side -----------//
@@ -2026,7 +2230,7 @@ void World::visit_shell(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int visitLev
 	{
 		for( int y = top; y <= bottom; ++y)
 		{
-			get_loc(xLoc1,y)->set_visited(visitLevel);
+			set_visited(get_loc(xLoc1,y), visitLevel);
 		}
 	}
 
@@ -2035,7 +2239,7 @@ void World::visit_shell(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int visitLev
 	{
 		for( int y = top; y <= bottom; ++y)
 		{
-			get_loc(xLoc2,y)->set_visited(visitLevel);
+			set_visited(get_loc(xLoc2,y), visitLevel);
 		}
 	}
 
@@ -2044,63 +2248,73 @@ void World::visit_shell(int xLoc1, int yLoc1, int xLoc2, int yLoc2, int visitLev
 
 
 //------- Begin of function World::process_visibility -----------//
-
+//
+// The visit levels of locations are not dropped here. Only the frame
+// count of the fog of war is advanced, and the visibility of a location
+// is calculated from it when it is read. See World::get_visibility().
+//
 void World::process_visibility()
 {
 	if( config.fog_of_war )
+		visit_frame_count++;
+}
+//------- End of function World::process_visibility -----------//
+
+
+//------- Begin of function World::settle_visibility -----------//
+//
+// Store the current visit level of every location in Location::visit_level,
+// so that the location matrix can be saved.
+//
+void World::settle_visibility()
+{
+	int locCount = max_x_loc * max_y_loc;
+
+	for( int i=0 ; i<locCount ; i++ )
 	{
-		// ###### begin Gilbert 13/10 ########//
-#ifndef USE_ASM
-		for( int y = 0; y < max_y_loc; ++y)
-		{
-			Location *locPtr = get_loc(0,y);
-			for( int x = 0; x < max_x_loc; ++x, ++locPtr)
-			{
-				locPtr->dec_visibility();
-			}
-		}
-#else
-		int count = max_x_loc * max_y_loc;
-		const int sizeOfLoc = sizeof(Location);
-		unsigned char *locVisitLevel = &get_loc(0,0)->visit_level;
-		unsigned char decVisitLevel = EXPLORED_VISIBILITY*2+1;
-#ifdef _MSC_VER
-		_asm
-		{
-			mov	ecx, count
-			mov	ebx, locVisitLevel
-			mov	edx, sizeOfLoc
-			mov	ah, decVisitLevel
-process_visit_level_1:
-			mov	al,[ebx]
-			cmp	al,ah			// if(al > EXPLORED_VISIBILITY*2) al--;
-			cmc
-			sbb	al,0
-			mov	[ebx],al
-			add	ebx, edx
-			loop	process_visit_level_1
-		}
-#else
-		__asm__ __volatile__ (
-			"movb %0, %%ah\n"
-		"process_visit_level_1:\n\t"
-			"movb (%%ebx), %%al\n\t"
-			"cmpb %%ah, %%al\n\t"
-			"cmc\n\t"
-			"sbbb $0, %%al\n\t"
-			"movb %%al, (%%ebx)\n\t"
-			"addl %%edx, %%ebx\n\t"
-			"loop process_visit_level_1\n\t"
-			: 
-			: "m"(decVisitLevel), "b"(locVisitLevel), "c"(count), "d"(sizeOfLoc)
-			: "%eax"
-		);
-#endif
-#endif
-		// ###### end Gilbert 13/10 ########//
+		loc_matrix[i].visit_level = loc_matrix[i].cur_visit_level(visit_frame_count - visit_frame_matrix[i]);
+		visit_frame_matrix[i] = visit_frame_count;
 	}
 }
-//------- End of function World::process_visibility -----------//
+//------- End of function World::settle_visibility -----------//
+
+
+//------- Begin of function World::build_walk_matrix -----------//
+//
+// Walkability and occupancy are read by the tight loops of unit placement
+// and path seeking. They are copied to walk_matrix, one byte a location,
+// so that those loops don't have to read whole Location records. The
+// counts of blocked locations in loc_sum are built from it.
+//
+void World::build_walk_matrix()
+{
+	Location* locPtr = loc_matrix;
+	int		 locCount = max_x_loc * max_y_loc;
+
+	for( int i=0 ; i<locCount ; i++, locPtr++ )
+		walk_matrix[i] = calc_walk_bits(locPtr);
+
+	loc_sum.init( walk_matrix, max_x_loc, max_y_loc );
+}
+//------- End of function World::build_walk_matrix -----------//
+
+
+//------- Begin of function World::build_region_matrix -----------//
+//
+// Copy the region ids to region_matrix. Called when the map is assigned
+// and after set_region_id().
+//
+void World::build_region_matrix()
+{
+	if( !region_matrix )
+		return;
+
+	int locCount = max_x_loc * max_y_loc;
+
+	for( int i=0 ; i<locCount ; i++ )
+		region_matrix[i] = loc_matrix[i].region_id;
+}
+//------- End of function World::build_region_matrix -----------//
 
 
 //--------- Begin of function World::disp_next --------//
@@ -2365,12 +2579,12 @@ Location* World::get_loc(int xLoc, int yLoc)
 
 //--------- Begin of function World::get_region_id --------//
 //
-uint8_t World::get_region_id(int xLoc, int yLoc)
+uint16_t World::get_region_id(int xLoc, int yLoc)
 {
 	err_when( xLoc<0 || xLoc>=MAX_WORLD_X_LOC );
 	err_when( yLoc<0 || yLoc>=MAX_WORLD_Y_LOC );
 
-	return loc_matrix[MAX_WORLD_X_LOC*yLoc+xLoc].region_id;
+	return region_matrix[MAX_WORLD_X_LOC*yLoc+xLoc];
 }
 //----------- End of function World::get_region_id --------//
 
@@ -65,6 +65,35 @@ void MapMatrix::init_para()
 //---------- End of function MapMatrix::init_para ----------//
 
 
+//---------- Begin of function MapMatrix::assign_map ------------//
+//
+// Maps larger than the map window are drawn with MAP_LOC_SCALE locations
+// to a pixel, the window is resized when the size of the map changes.
+//
+void MapMatrix::assign_map(Location* locMatrix, int maxXLoc, int maxYLoc)
+{
+	if( image_width != MAP_WIDTH || image_height != MAP_HEIGHT )
+	{
+		if( save_image_buf )
+			mem_del( save_image_buf );
+
+		init( MAP_X1, MAP_Y1, MAP_X2, MAP_Y2,
+				MAP_WIDTH, MAP_HEIGHT,
+				MAP_LOC_WIDTH, MAP_LOC_HEIGHT, 1 );
+
+		last_map_mode = -1;		// the new buffer has to be drawn before it is displayed
+	}
+
+	Matrix::assign_map(locMatrix, maxXLoc, maxYLoc);
+
+	//------ the whole map is always displayed ------//
+
+	disp_x_loc = max_x_loc;
+	disp_y_loc = max_y_loc;
+}
+//---------- End of function MapMatrix::assign_map ----------//
+
+
 //--------- Begin of function MapMatrix::paint -----------//
 
 void MapMatrix::paint()
@@ -166,7 +195,8 @@ void MapMatrix::draw_map()
 	char* 	 writePtr  = vga_back.buf_ptr() + vga_back.buf_pitch() * image_y1 + image_x1;
 	int   	 lineRemain = vga_back.buf_pitch() - image_width;
 	int 		 x, y;
-	Location* locPtr = world.loc_matrix;
+	int		 locScale = MAP_LOC_SCALE;
+	Location* locPtr;
 	char*     nationColorArray = nation_array.nation_power_color_array;
 
 	//----------- draw map now ------------//
@@ -184,8 +214,9 @@ void MapMatrix::draw_map()
 		for( y=image_y1 ; y<=image_y2 ; y++, writePtr+=lineRemain )
 		{
 			tileYOffset = (y & TERRAIN_TILE_Y_MASK) * TERRAIN_TILE_WIDTH;
+			locPtr = world.get_loc(0, (y-image_y1)*locScale);
 
-			for( x=image_x1 ; x<=image_x2 ; x++, writePtr++, locPtr++ )
+			for( x=image_x1 ; x<=image_x2 ; x++, writePtr++, locPtr+=locScale )
 			{
 				if( locPtr->explored() )
 				{
@@ -230,7 +261,9 @@ void MapMatrix::draw_map()
 	case MAP_MODE_SPOT:
 		for( y=image_y1 ; y<=image_y2 ; y++, writePtr+=lineRemain )
 		{
-			for( x=image_x1 ; x<=image_x2 ; x++, writePtr++, locPtr++ )
+			locPtr = world.get_loc(0, (y-image_y1)*locScale);
+
+			for( x=image_x1 ; x<=image_x2 ; x++, writePtr++, locPtr+=locScale )
 			{
 				if( locPtr->explored() )
 				{
@@ -257,7 +290,9 @@ void MapMatrix::draw_map()
 	case MAP_MODE_POWER:
 		for( y=image_y1 ; y<=image_y2 ; y++, writePtr+=lineRemain )
 		{
-			for( x=image_x1 ; x<=image_x2 ; x++, writePtr++, locPtr++ )
+			locPtr = world.get_loc(0, (y-image_y1)*locScale);
+
+			for( x=image_x1 ; x<=image_x2 ; x++, writePtr++, locPtr+=locScale )
 			{
 				if( locPtr->explored() )
 				{
@@ -324,10 +359,12 @@ void MapMatrix::draw_square()
 
 	static int squareFrameCount=0, squareFrameStep=1;
 
-	int x1=image_x1+(cur_x_loc-top_x_loc)*loc_width;
-	int y1=image_y1+(cur_y_loc-top_y_loc)*loc_height;
-	int x2=x1+cur_cargo_width *loc_width-1;
-	int y2=y1+cur_cargo_height*loc_height-1;
+	int locScale = MAP_LOC_SCALE;
+
+	int x1=image_x1+(cur_x_loc-top_x_loc)*loc_width/locScale;
+	int y1=image_y1+(cur_y_loc-top_y_loc)*loc_height/locScale;
+	int x2=x1+(cur_cargo_width *loc_width+locScale-1)/locScale-1;
+	int y2=y1+(cur_cargo_height*loc_height+locScale-1)/locScale-1;
 
 	vga_back.rect( x1, y1, x2, y2, 1, VGA_YELLOW + squareFrameCount );
 
@@ -411,8 +448,8 @@ int MapMatrix::detect_area()
 	if( mouse.single_click( image_x1,image_y1,image_x2,image_y2 ) ||
 		 mouse.press_area( image_x1,image_y1,image_x2,image_y2, LEFT_BUTTON ) )
 	{
-		int xLoc = top_x_loc + (mouse.cur_x-image_x1)/loc_width;
-		int yLoc = top_y_loc + (mouse.cur_y-image_y1)/loc_height;
+		int xLoc = top_x_loc + (mouse.cur_x-image_x1)*MAP_LOC_SCALE/loc_width;
+		int yLoc = top_y_loc + (mouse.cur_y-image_y1)*MAP_LOC_SCALE/loc_height;
 
 		//-- if only single click, don't highlight new firm, only new area --//
 
@@ -22,6 +22,8 @@
 //Description : Object ZoomMatrix
 
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include <OVGA.h>
 #include <OSYS.h>
 #include <OFONT.h>
@@ -45,6 +47,8 @@
 #include <OWORLD.h>
 #include <OWEATHER.h>
 #include <OFLAME.h>
+#include <OSPRSPAN.h>
+#include <OBANDRND.h>
 #include <OGODRES.h>
 #include <OU_GOD.h>
 #include <OAUDIO.h>
@@ -281,10 +285,29 @@ ZoomMatrix::ZoomMatrix() : land_disp_sort_array(sizeof(DisplaySort),100),
 	init( ZOOM_X1, ZOOM_Y1, ZOOM_X2, ZOOM_Y2,
 			ZOOM_WIDTH, ZOOM_HEIGHT,
 			ZOOM_LOC_WIDTH, ZOOM_LOC_HEIGHT, 0 );		// 0-don't create a background buffer
+
+	terrain_buf 		  = NULL;
+	terrain_key_array   = NULL;
+	terrain_dirty_array = NULL;
+	terrain_draw_array  = NULL;
+	terrain_x_loc		  = 0;
+	terrain_y_loc		  = 0;
+	terrain_spill_loc   = 0;
+	terrain_valid		  = 0;
+	terrain_disp_power  = 0;
 }
 //---------- End of function ZoomMatrix::ZoomMatrix ----------//
 
 
+//-------- Begin of function ZoomMatrix::~ZoomMatrix ----------//
+
+ZoomMatrix::~ZoomMatrix()
+{
+	deinit_terrain();
+}
+//---------- End of function ZoomMatrix::~ZoomMatrix ----------//
+
+
 //---------- Begin of function ZoomMatrix::init_para ------------//
 void ZoomMatrix::init_para()
 {
@@ -301,6 +324,7 @@ void ZoomMatrix::init_para()
 	init_snow = 0;
 	last_brightness = 0;
 	vibration = -1;
+	terrain_valid = 0;
 }
 //---------- End of function ZoomMatrix::init_para ----------//
 
@@ -309,11 +333,13 @@ void ZoomMatrix::init_para()
 //
 // Draw world map
 //
+// The terrain layer is kept in terrain_buf. Only the locations whose
+// terrain has changed since the last call, and the locations uncovered
+// by scrolling, are drawn again. The others are copied from terrain_buf.
+//
 void ZoomMatrix::draw()
 {
-	int       i=0, x, y, xLoc, yLoc, dispPower;
-	Location* locPtr;
-	char*     nationColorArray = nation_array.nation_power_color_array;
+	int xLoc, yLoc, dispPower;
 
 	int maxXLoc = top_x_loc + disp_x_loc;        // divide by 2 for world_info
 	int maxYLoc = top_y_loc + disp_y_loc;
@@ -325,119 +351,103 @@ void ZoomMatrix::draw()
 
 	sys.yield();
 
-	//----------------------------------------------------//
+	//------- allocate the terrain layer on first use -------//
 
-	int nationRecno, borderColor;
+	int locCount = disp_x_loc * disp_y_loc;
 
-	for( y=image_y1,yLoc=top_y_loc ; yLoc<maxYLoc ; yLoc++, y+=loc_height )
+	if( !terrain_buf )
 	{
-		locPtr = get_loc(top_x_loc,yLoc);
+		terrain_buf 		  = mem_add( sizeof(short)*2 + image_width * image_height );	// 2 <short> for width & height info
+		terrain_key_array   = (ZoomLocKey*) mem_add( sizeof(ZoomLocKey) * locCount );
+		terrain_dirty_array = mem_add( locCount );
+		terrain_draw_array  = mem_add( locCount );
 
-		long snowSeed = (snow_ground_array.snow_pattern << 16) + (yLoc << 8);
+		terrain_valid = 0;
+	}
 
-		for( x=image_x1,xLoc=top_x_loc ; xLoc<maxXLoc ; xLoc++, x+=loc_width, locPtr++ )
-		{
-			if( locPtr->explored() )		// only draw if the location has been explored
-			{
-				//---------- draw terrain bitmap -----------//
+	if( !terrain_spill_loc )
+		terrain_spill_loc = calc_terrain_spill();
 
-				vga_back.put_bitmap_32x32( x, y, terrain_res[locPtr->terrain_id]->bitmap_ptr );
-				char *overlayBitmap = terrain_res[locPtr->terrain_id]->get_bitmap(sys.frame_count /4);
-				if( overlayBitmap)
-					vga_back.put_bitmap_trans_decompress( x, y, overlayBitmap);
+	//---- if the zoom area has scrolled, shift the terrain layer with it ----//
 
-				#ifdef DEBUG
-				if(debug2_enable_flag)
-				{
-					if(locPtr->is_coast())
-					{
-						VgaBuf *activeBufBackup = Vga::active_buf;
-						Vga::active_buf = &vga_back;
-						font_std.put( x+24, y+20, terrain_res[locPtr->terrain_id]->average_type);
-						Vga::active_buf = activeBufBackup;
-					}
-				}
-				#endif
+	if( !terrain_valid )
+	{
+		memset( terrain_dirty_array, 1, locCount );
+	}
+	else
+	{
+		memset( terrain_dirty_array, 0, locCount );
 
-				// --------- draw dirt block --------//
-				if( locPtr->has_dirt() )
-				{
-					dirt_array[locPtr->dirt_recno()]->draw_block(xLoc,yLoc);
-				}
+		if( top_x_loc != terrain_x_loc || top_y_loc != terrain_y_loc )
+			shift_terrain( top_x_loc - terrain_x_loc, top_y_loc - terrain_y_loc );
+	}
 
-				if(terrain_res[locPtr->terrain_id]->can_snow() )
-				{
-					if( config.snow_ground==1 && snow_ground_array.snow_thick > 0)
-					{
-						vga_back.snow_32x32(x,y, snowSeed+xLoc, 0xffff - snow_ground_array.snow_thick);
-					}
+	terrain_x_loc = top_x_loc;
+	terrain_y_loc = top_y_loc;
 
-					if( config.snow_ground==2)
-					{
-						int snowMapId = snow_ground_array.has_snow(xLoc,yLoc);
-						if( snowMapId )
-						{
-							snow_res[snowMapId]->draw_at(xLoc*ZOOM_LOC_WIDTH+ZOOM_LOC_WIDTH/2, yLoc*ZOOM_LOC_HEIGHT+ZOOM_LOC_HEIGHT/2);
-						}
-					}
-				}
+	//------ find the locations whose terrain has changed ------//
+	//
+	// The bitmaps drawn on a changed location may reach the locations
+	// around it, so those have to be drawn again too.
+	//
+	//-----------------------------------------------------------//
 
-				// --------- draw hill square --------//
-				if( locPtr->has_hill() )
-				{
-					if( locPtr->hill_id2())
-						hill_res[locPtr->hill_id2()]->draw(xLoc,yLoc,1);
-					hill_res[locPtr->hill_id1()]->draw(xLoc, yLoc,1);
-				}
+	ZoomLocKey  locKey;
+	ZoomLocKey* keyPtr = terrain_key_array;
+	char*			changePtr = terrain_draw_array;
+	int			i, j, changeCount = 0;
 
-				//---------- if in power map mode -----------//
+	memset( terrain_draw_array, 0, locCount );
 
-				if( dispPower && (nationRecno=locPtr->power_nation_recno) > 0 )
-				{
-					vga_back.pixelize_32x32( x, y, nationColorArray[nationRecno] );
+	for( yLoc=top_y_loc ; yLoc<maxYLoc ; yLoc++ )
+	{
+		for( xLoc=top_x_loc ; xLoc<maxXLoc ; xLoc++, keyPtr++, changePtr++ )
+		{
+			get_loc_key( &locKey, xLoc, yLoc, dispPower );
 
-					borderColor = nationColorArray[nationRecno] + 1;
+			if( memcmp(&locKey, keyPtr, sizeof(ZoomLocKey)) )
+			{
+				*keyPtr = locKey;
+				*changePtr = 1;
+				changeCount++;
+			}
+		}
+	}
 
-					if( yLoc==0 || get_loc(xLoc, yLoc-1)->power_nation_recno!=nationRecno )
-						vga_back.bar( x, y, x+31, y, borderColor );
+	if( changeCount > 0 )
+	{
+		int spillLoc = terrain_spill_loc;
 
-					if( yLoc==MAX_WORLD_Y_LOC-1 || get_loc(xLoc, yLoc+1)->power_nation_recno!=nationRecno )
-						vga_back.bar( x, y+31, x+31, y+31, borderColor );
+		for( yLoc=0 ; yLoc<disp_y_loc ; yLoc++ )
+		{
+			for( xLoc=0 ; xLoc<disp_x_loc ; xLoc++ )
+			{
+				if( !terrain_draw_array[yLoc*disp_x_loc+xLoc] )
+					continue;
 
-					if( xLoc==0 || get_loc(xLoc-1, yLoc)->power_nation_recno!=nationRecno )
-						vga_back.bar( x, y, x, y+31, borderColor );
+				int xLoc1 = MAX(xLoc-spillLoc, 0), xLoc2 = MIN(xLoc+spillLoc, disp_x_loc-1);
+				int yLoc1 = MAX(yLoc-spillLoc, 0), yLoc2 = MIN(yLoc+spillLoc, disp_y_loc-1);
 
-					if( xLoc==MAX_WORLD_X_LOC-1 || get_loc(xLoc+1, yLoc)->power_nation_recno!=nationRecno )
-						vga_back.bar( x+31, y, x+31, y+31, borderColor );
-				}
+				for( j=yLoc1 ; j<=yLoc2 ; j++ )
+					memset( terrain_dirty_array + j*disp_x_loc + xLoc1, 1, xLoc2-xLoc1+1 );
+			}
+		}
+	}
 
-				//--------- draw raw material icon ---------//
+	int dirtyCount = 0;
 
-				if( locPtr->has_site() && locPtr->walkable(3) )		// don't display if a building/object has already been built on the location
-					site_array[locPtr->site_recno()]->draw(x, y);
+	for( i=0 ; i<locCount ; i++ )
+		dirtyCount += terrain_dirty_array[i];
 
-				//----- draw grids, for debugging only -----//
+	//------ draw the changed locations -------//
 
-				#ifdef DEBUG
-					if(debug2_enable_flag)
-					{
-						vga_back.bar( x, y, x+31, y, V_WHITE );
-						vga_back.bar( x, y, x, y+31, V_WHITE );
+	if( dirtyCount > 0 )
+		draw_dirty_loc(dispPower, dirtyCount == locCount);
 
-						// display x, y location
-						if(!(xLoc%5) && !(yLoc%5))
-						{
-							VgaBuf *activeBufBackup = Vga::active_buf;
-							Vga::active_buf = &vga_back;
-							font_std.put( x+4, y+3, xLoc );
-							font_std.put( x+4, y+15, yLoc );
-							Vga::active_buf = activeBufBackup;
-						}
-					}
-				#endif
-			}
-		}
-	}
+	if( dirtyCount < locCount )		// the whole area has been drawn if all locations are dirty
+		vga_back.put_bitmap_dw( image_x1, image_y1, terrain_buf );
+
+	terrain_valid = 1;
 
    sys.yield();
 
@@ -452,6 +462,496 @@ void ZoomMatrix::draw()
 //------------ End of function ZoomMatrix::draw ------------//
 
 
+//---------- Begin of function ZoomMatrix::deinit_terrain ------------//
+
+void ZoomMatrix::deinit_terrain()
+{
+	if( terrain_buf )
+	{
+		mem_del( terrain_buf );
+		mem_del( terrain_key_array );
+		mem_del( terrain_dirty_array );
+		mem_del( terrain_draw_array );
+
+		terrain_buf 		  = NULL;
+		terrain_key_array   = NULL;
+		terrain_dirty_array = NULL;
+		terrain_draw_array  = NULL;
+	}
+
+	terrain_valid = 0;
+}
+//------------ End of function ZoomMatrix::deinit_terrain ------------//
+
+
+//---------- Begin of function ZoomMatrix::draw_loc ------------//
+//
+// Draw the terrain layer of a location. Only the given rows of the zoom
+// area are drawn on. If the location is outside them, only the parts
+// of the hill, dirt and snow bitmaps which reach them are drawn.
+//
+// <int> x, y           - where the location is on the screen
+// <int> xLoc, yLoc     - the location
+// <int> dispPower      - whether the power regions are displayed
+// <int> clipY1, clipY2 - the rows of the zoom area to draw on
+//
+void ZoomMatrix::draw_loc(int x, int y, int xLoc, int yLoc, int dispPower, int clipY1, int clipY2)
+{
+	Location* locPtr = get_loc(xLoc, yLoc);
+
+	if( !locPtr->explored() )		// only draw if the location has been explored
+		return;
+
+	char* nationColorArray = nation_array.nation_power_color_array;
+	int   nationRecno, borderColor;
+	long  snowSeed = (snow_ground_array.snow_pattern << 16) + (yLoc << 8);
+	int   inClip = y-image_y1 >= clipY1 && y-image_y1 <= clipY2;		// the bands are whole rows of locations
+
+	//---------- draw terrain bitmap -----------//
+
+	if( inClip )
+	{
+		vga_back.put_bitmap_32x32( x, y, terrain_res[locPtr->terrain_id]->bitmap_ptr );
+		char *overlayBitmap = terrain_res[locPtr->terrain_id]->get_bitmap(sys.frame_count /4);
+		if( overlayBitmap)
+		{
+#ifdef IMG_REENTRANT
+			vga_back.put_bitmap_trans_decompress( x, y, overlayBitmap);		// sprite_span_cache cannot be used by the worker threads of band_render
+#else
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, overlayBitmap);
+#endif
+		}
+	}
+
+	#ifdef DEBUG
+	if(debug2_enable_flag && inClip)
+	{
+		if(locPtr->is_coast())
+		{
+			VgaBuf *activeBufBackup = Vga::active_buf;
+			Vga::active_buf = &vga_back;
+			font_std.put( x+24, y+20, terrain_res[locPtr->terrain_id]->average_type);
+			Vga::active_buf = activeBufBackup;
+		}
+	}
+	#endif
+
+	// --------- draw dirt block --------//
+	if( locPtr->has_dirt() )
+	{
+		dirt_array[locPtr->dirt_recno()]->draw_block(xLoc,yLoc,clipY1,clipY2);
+	}
+
+	if(terrain_res[locPtr->terrain_id]->can_snow() )
+	{
+		if( config.snow_ground==1 && snow_ground_array.snow_thick > 0 && inClip)
+		{
+			vga_back.snow_32x32(x,y, snowSeed+xLoc, 0xffff - snow_ground_array.snow_thick);
+		}
+
+		if( config.snow_ground==2)
+		{
+			int snowMapId = snow_ground_array.has_snow(xLoc,yLoc);
+			if( snowMapId )
+			{
+				snow_res[snowMapId]->draw_at(xLoc*ZOOM_LOC_WIDTH+ZOOM_LOC_WIDTH/2, yLoc*ZOOM_LOC_HEIGHT+ZOOM_LOC_HEIGHT/2, clipY1, clipY2);
+			}
+		}
+	}
+
+	// --------- draw hill square --------//
+	if( locPtr->has_hill() )
+	{
+		if( locPtr->hill_id2())
+			hill_res[locPtr->hill_id2()]->draw(xLoc,yLoc,1,clipY1,clipY2);
+		hill_res[locPtr->hill_id1()]->draw(xLoc, yLoc,1,clipY1,clipY2);
+	}
+
+	if( !inClip )
+		return;
+
+	//---------- if in power map mode -----------//
+
+	if( dispPower && (nationRecno=locPtr->power_nation_recno) > 0 )
+	{
+		vga_back.pixelize_32x32( x, y, nationColorArray[nationRecno] );
+
+		borderColor = nationColorArray[nationRecno] + 1;
+
+		if( yLoc==0 || get_loc(xLoc, yLoc-1)->power_nation_recno!=nationRecno )
+			vga_back.bar( x, y, x+31, y, borderColor );
+
+		if( yLoc==MAX_WORLD_Y_LOC-1 || get_loc(xLoc, yLoc+1)->power_nation_recno!=nationRecno )
+			vga_back.bar( x, y+31, x+31, y+31, borderColor );
+
+		if( xLoc==0 || get_loc(xLoc-1, yLoc)->power_nation_recno!=nationRecno )
+			vga_back.bar( x, y, x, y+31, borderColor );
+
+		if( xLoc==MAX_WORLD_X_LOC-1 || get_loc(xLoc+1, yLoc)->power_nation_recno!=nationRecno )
+			vga_back.bar( x+31, y, x+31, y+31, borderColor );
+	}
+
+	//--------- draw raw material icon ---------//
+
+	if( locPtr->has_site() && locPtr->walkable(3) )		// don't display if a building/object has already been built on the location
+		site_array[locPtr->site_recno()]->draw(x, y);
+
+	//----- draw grids, for debugging only -----//
+
+	#ifdef DEBUG
+		if(debug2_enable_flag)
+		{
+			vga_back.bar( x, y, x+31, y, V_WHITE );
+			vga_back.bar( x, y, x, y+31, V_WHITE );
+
+			// display x, y location
+			if(!(xLoc%5) && !(yLoc%5))
+			{
+				VgaBuf *activeBufBackup = Vga::active_buf;
+				Vga::active_buf = &vga_back;
+				font_std.put( x+4, y+3, xLoc );
+				font_std.put( x+4, y+15, yLoc );
+				Vga::active_buf = activeBufBackup;
+			}
+		}
+	#endif
+}
+//------------ End of function ZoomMatrix::draw_loc ------------//
+
+
+//---------- Begin of function ZoomMatrix::draw_dirty_loc ------------//
+//
+// Draw the locations marked in terrain_dirty_array again and update
+// terrain_buf with them.
+//
+// The hill, dirt and snow bitmaps drawn on a location may reach up to
+// terrain_spill_loc locations away. All locations within that distance
+// of a marked one are drawn in the usual order, so the marked ones come
+// out the same as when the whole area is drawn. Only the marked
+// locations are then copied to terrain_buf.
+//
+// <int> dispPower - whether the power regions are displayed
+// <int> allDirty  - whether all locations are marked
+//
+void ZoomMatrix::draw_dirty_loc(int dispPower, int allDirty)
+{
+	int spillLoc = terrain_spill_loc;
+	int xLoc, yLoc, i;
+
+	//------ mark the locations to be drawn -------//
+
+	if( allDirty )
+	{
+		memset( terrain_draw_array, 1, disp_x_loc * disp_y_loc );
+	}
+	else
+	{
+		memset( terrain_draw_array, 0, disp_x_loc * disp_y_loc );
+
+		for( yLoc=0 ; yLoc<disp_y_loc ; yLoc++ )
+		{
+			for( xLoc=0 ; xLoc<disp_x_loc ; xLoc++ )
+			{
+				if( !terrain_dirty_array[yLoc*disp_x_loc+xLoc] )
+					continue;
+
+				int xLoc1 = MAX(xLoc-spillLoc, 0), xLoc2 = MIN(xLoc+spillLoc, disp_x_loc-1);
+				int yLoc1 = MAX(yLoc-spillLoc, 0), yLoc2 = MIN(yLoc+spillLoc, disp_y_loc-1);
+
+				for( i=yLoc1 ; i<=yLoc2 ; i++ )
+					memset( terrain_draw_array + i*disp_x_loc + xLoc1, 1, xLoc2-xLoc1+1 );
+			}
+		}
+	}
+
+	//------ draw them in bands of rows -------//
+
+	terrain_disp_power = dispPower;
+
+#ifdef IMG_REENTRANT
+	#ifdef DEBUG
+	if( debug2_enable_flag )		// the debug text is drawn with font_std, which is not reentrant
+	{
+		draw_terrain( 0, disp_y_loc-1 );
+		return;
+	}
+	#endif
+
+	band_render.run( draw_terrain_band, this, disp_y_loc );
+#else
+	draw_terrain( 0, disp_y_loc-1 );
+#endif
+}
+//------------ End of function ZoomMatrix::draw_dirty_loc ------------//
+
+
+//---------- Begin of function ZoomMatrix::draw_terrain_band ------------//
+//
+void ZoomMatrix::draw_terrain_band(void* zoomMatrix, int row1, int row2)
+{
+	((ZoomMatrix*) zoomMatrix)->draw_terrain(row1, row2);
+}
+//------------ End of function ZoomMatrix::draw_terrain_band ------------//
+
+
+//---------- Begin of function ZoomMatrix::draw_terrain ------------//
+//
+// Draw the locations marked in terrain_draw_array on the given rows of
+// the zoom area, and copy the ones marked in terrain_dirty_array to
+// terrain_buf. It may be called from a worker thread of band_render, so
+// it only writes to those rows of vga_back and terrain_buf.
+//
+// The locations up to terrain_spill_loc rows above and below are drawn
+// too, in the usual order and clipped to the rows, as their hill, dirt
+// and snow bitmaps may reach them.
+//
+// <int> row1, row2 - the first and last rows, 0 for the top row of the zoom area
+//
+void ZoomMatrix::draw_terrain(int row1, int row2)
+{
+	int clipY1 = row1 * loc_height;
+	int clipY2 = (row2+1) * loc_height - 1;
+	int drawRow1 = MAX(row1-terrain_spill_loc, 0);
+	int drawRow2 = MIN(row2+terrain_spill_loc, disp_y_loc-1);
+	int x, y, xLoc, yLoc, i;
+
+	//-------- draw them in the usual order --------//
+
+	char* drawPtr = terrain_draw_array + drawRow1*disp_x_loc;
+
+	for( y=image_y1+drawRow1*loc_height,yLoc=top_y_loc+drawRow1 ; yLoc<=top_y_loc+drawRow2 ; yLoc++, y+=loc_height )
+	{
+		for( x=image_x1,xLoc=top_x_loc ; xLoc<top_x_loc+disp_x_loc ; xLoc++, x+=loc_width, drawPtr++ )
+		{
+			if( *drawPtr )
+				draw_loc( x, y, xLoc, yLoc, terrain_disp_power, clipY1, clipY2 );
+		}
+	}
+
+	//----- copy the changed locations to terrain_buf -----//
+
+	char* dirtyPtr = terrain_dirty_array + row1*disp_x_loc;
+	char* bufPtr = terrain_buf + sizeof(short)*2;
+
+	for( yLoc=row1 ; yLoc<=row2 ; yLoc++ )
+	{
+		for( xLoc=0 ; xLoc<disp_x_loc ; xLoc++, dirtyPtr++ )
+		{
+			if( !*dirtyPtr )
+				continue;
+
+			char* srcPtr  = vga_back.buf_ptr( image_x1+xLoc*loc_width, image_y1+yLoc*loc_height );
+			char* destPtr = bufPtr + yLoc*loc_height*image_width + xLoc*loc_width;
+
+			for( i=0 ; i<loc_height ; i++, srcPtr+=vga_back.buf_pitch(), destPtr+=image_width )
+				memcpy( destPtr, srcPtr, loc_width );
+		}
+	}
+}
+//------------ End of function ZoomMatrix::draw_terrain ------------//
+
+
+//---------- Begin of function ZoomMatrix::shift_terrain ------------//
+//
+// Shift terrain_buf and terrain_key_array after the zoom area has
+// scrolled, and mark the locations to be drawn again in
+// terrain_dirty_array.
+//
+// <int> xShift, yShift - the no. of locations scrolled
+//
+void ZoomMatrix::shift_terrain(int xShift, int yShift)
+{
+	if( abs(xShift) >= disp_x_loc || abs(yShift) >= disp_y_loc )
+	{
+		memset( terrain_dirty_array, 1, disp_x_loc * disp_y_loc );
+		return;
+	}
+
+	//------- shift the bitmap and the keys -------//
+
+	int copyLocWidth  = disp_x_loc - abs(xShift);
+	int copyLocHeight = disp_y_loc - abs(yShift);
+	int srcXLoc  = MAX(xShift, 0), destXLoc = MAX(-xShift, 0);
+	int srcYLoc  = MAX(yShift, 0), destYLoc = MAX(-yShift, 0);
+	int forwardFlag = yShift > 0 || (yShift==0 && xShift > 0);		// moving the lines up or left, copy from the first line
+	int i, line;
+
+	char* bufPtr = terrain_buf + sizeof(short)*2;
+
+	for( i=0 ; i<copyLocHeight*loc_height ; i++ )
+	{
+		line = forwardFlag ? i : copyLocHeight*loc_height-1-i;
+
+		memmove( bufPtr + (destYLoc*loc_height+line)*image_width + destXLoc*loc_width,
+					bufPtr + (srcYLoc*loc_height+line)*image_width + srcXLoc*loc_width, copyLocWidth*loc_width );
+	}
+
+	for( i=0 ; i<copyLocHeight ; i++ )
+	{
+		line = forwardFlag ? i : copyLocHeight-1-i;
+
+		memmove( terrain_key_array + (destYLoc+line)*disp_x_loc + destXLoc,
+					terrain_key_array + (srcYLoc+line)*disp_x_loc + srcXLoc, sizeof(ZoomLocKey)*copyLocWidth );
+	}
+
+	//-------------------------------------------------//
+	//
+	// Draw again the uncovered locations, and the locations close
+	// enough to them or to the opposite edge to have had bitmaps of
+	// locations outside the zoom area drawn, or not drawn, on them.
+	//
+	//-------------------------------------------------//
+
+	int spillLoc = terrain_spill_loc;
+	int xLoc, yLoc, dirtyFlag;
+
+	for( yLoc=0 ; yLoc<disp_y_loc ; yLoc++ )
+	{
+		for( xLoc=0 ; xLoc<disp_x_loc ; xLoc++ )
+		{
+			dirtyFlag = 0;
+
+			if( xShift > 0 )
+				dirtyFlag = xLoc < spillLoc || xLoc >= disp_x_loc-xShift-spillLoc;
+			else if( xShift < 0 )
+				dirtyFlag = xLoc < -xShift+spillLoc || xLoc >= disp_x_loc-spillLoc;
+
+			if( yShift > 0 )
+				dirtyFlag |= yLoc < spillLoc || yLoc >= disp_y_loc-yShift-spillLoc;
+			else if( yShift < 0 )
+				dirtyFlag |= yLoc < -yShift+spillLoc || yLoc >= disp_y_loc-spillLoc;
+
+			if( dirtyFlag )
+				terrain_dirty_array[yLoc*disp_x_loc+xLoc] = 1;
+		}
+	}
+}
+//------------ End of function ZoomMatrix::shift_terrain ------------//
+
+
+//---------- Begin of function ZoomMatrix::get_loc_key ------------//
+//
+// Get what the terrain layer of a location is drawn from, see draw_loc().
+//
+void ZoomMatrix::get_loc_key(ZoomLocKey* keyPtr, int xLoc, int yLoc, int dispPower)
+{
+	Location* locPtr = get_loc(xLoc, yLoc);
+
+	memset( keyPtr, 0, sizeof(ZoomLocKey) );		// the padding is compared too
+
+	if( !locPtr->explored() )
+		return;
+
+	keyPtr->explored		 = 1;
+	keyPtr->terrain_id	 = locPtr->terrain_id;
+	keyPtr->overlay_bitmap = terrain_res[locPtr->terrain_id]->get_bitmap(sys.frame_count /4);
+
+	if( locPtr->has_dirt() )
+	{
+		Rock* dirtPtr = dirt_array[locPtr->dirt_recno()];
+
+		keyPtr->dirt_recno		= locPtr->dirt_recno();
+		keyPtr->dirt_rock_recno = dirtPtr->rock_recno;
+		keyPtr->dirt_x_loc		= dirtPtr->loc_x;
+		keyPtr->dirt_y_loc		= dirtPtr->loc_y;
+		keyPtr->dirt_frame		= dirtPtr->cur_frame;
+	}
+
+	if( terrain_res[locPtr->terrain_id]->can_snow() )
+	{
+		if( config.snow_ground==1 && snow_ground_array.snow_thick > 0 )
+			keyPtr->snow_thick = snow_ground_array.snow_thick;
+
+		if( config.snow_ground==2 )
+			keyPtr->snow_map_id = snow_ground_array.has_snow(xLoc,yLoc);
+
+		keyPtr->snow_pattern = snow_ground_array.snow_pattern;
+	}
+
+	if( locPtr->has_hill() )
+	{
+		keyPtr->hill_id1 = locPtr->hill_id1();
+		keyPtr->hill_id2 = locPtr->hill_id2();
+	}
+
+	int nationRecno;
+
+	if( dispPower && (nationRecno=locPtr->power_nation_recno) > 0 )
+	{
+		keyPtr->power_nation_recno = nationRecno;
+
+		if( yLoc==0 || get_loc(xLoc, yLoc-1)->power_nation_recno!=nationRecno )
+			keyPtr->power_border |= 1;
+
+		if( yLoc==MAX_WORLD_Y_LOC-1 || get_loc(xLoc, yLoc+1)->power_nation_recno!=nationRecno )
+			keyPtr->power_border |= 2;
+
+		if( xLoc==0 || get_loc(xLoc-1, yLoc)->power_nation_recno!=nationRecno )
+			keyPtr->power_border |= 4;
+
+		if( xLoc==MAX_WORLD_X_LOC-1 || get_loc(xLoc+1, yLoc)->power_nation_recno!=nationRecno )
+			keyPtr->power_border |= 8;
+	}
+
+	if( locPtr->has_site() && locPtr->walkable(3) )
+	{
+		Site* sitePtr = site_array[locPtr->site_recno()];
+
+		keyPtr->site_recno	  = locPtr->site_recno();
+		keyPtr->site_type 	  = sitePtr->site_type;
+		keyPtr->site_object_id = sitePtr->object_id;
+	}
+
+	#ifdef DEBUG
+		keyPtr->debug_flag = debug2_enable_flag;
+	#endif
+}
+//------------ End of function ZoomMatrix::get_loc_key ------------//
+
+
+//---------- Begin of function ZoomMatrix::calc_terrain_spill ------------//
+//
+// Return how many locations away the hill, dirt and snow bitmaps drawn
+// on a location can reach, at least 1.
+//
+int ZoomMatrix::calc_terrain_spill()
+{
+	int spillPixel = 0;
+	int i;
+
+	for( i=1 ; i<=hill_res.hill_block_count ; i++ )
+	{
+		HillBlockInfo* hillInfo = hill_res[i];
+
+		spillPixel = MAX( spillPixel, -hillInfo->offset_x );
+		spillPixel = MAX( spillPixel, -hillInfo->offset_y );
+		spillPixel = MAX( spillPixel, hillInfo->offset_x + hillInfo->bitmap_width() - ZOOM_LOC_WIDTH );
+		spillPixel = MAX( spillPixel, hillInfo->offset_y + hillInfo->bitmap_height() - ZOOM_LOC_HEIGHT );
+	}
+
+	for( i=1 ; i<=rock_res.rock_bitmap_count ; i++ )
+	{
+		RockBitmapInfo* rockBitmap = rock_res.get_bitmap_info(i);
+
+		spillPixel = MAX( spillPixel, rockBitmap->width() - ZOOM_LOC_WIDTH );
+		spillPixel = MAX( spillPixel, rockBitmap->height() - ZOOM_LOC_HEIGHT );
+	}
+
+	for( i=1 ; i<=snow_res.snow_info_count ; i++ )		// snow bitmaps are drawn from the center of the location
+	{
+		SnowInfo* snowInfo = snow_res[i];
+
+		spillPixel = MAX( spillPixel, -ZOOM_LOC_WIDTH/2 - snowInfo->offset_x );
+		spillPixel = MAX( spillPixel, -ZOOM_LOC_HEIGHT/2 - snowInfo->offset_y );
+		spillPixel = MAX( spillPixel, snowInfo->offset_x + snowInfo->bitmap_width() - ZOOM_LOC_WIDTH/2 );
+		spillPixel = MAX( spillPixel, snowInfo->offset_y + snowInfo->bitmap_height() - ZOOM_LOC_HEIGHT/2 );
+	}
+
+	return MAX( 1, (spillPixel + ZOOM_LOC_WIDTH - 1) / ZOOM_LOC_WIDTH );
+}
+//------------ End of function ZoomMatrix::calc_terrain_spill ------------//
+
+
 //---------- Begin of function ZoomMatrix::draw_white_site ------------//
 //
 void ZoomMatrix::draw_white_site()
@@ -1059,19 +1559,49 @@ void ZoomMatrix::put_center_text(int x, int y, const char* str)
 
 //---------- Begin of function ZoomMatrix::blacken_unexplored -----------//
 //
+// The rows of the zoom area are blackened in bands by band_render.
+//
 void ZoomMatrix::blacken_unexplored()
+{
+#ifdef IMG_REENTRANT
+	band_render.run( blacken_unexplored_band, this, disp_y_loc );
+#else
+	blacken_unexplored( 0, disp_y_loc-1 );
+#endif
+}
+//----------- End of function ZoomMatrix::blacken_unexplored ------------//
+
+
+//---------- Begin of function ZoomMatrix::blacken_unexplored_band -----------//
+//
+void ZoomMatrix::blacken_unexplored_band(void* zoomMatrix, int row1, int row2)
+{
+	((ZoomMatrix*) zoomMatrix)->blacken_unexplored(row1, row2);
+}
+//----------- End of function ZoomMatrix::blacken_unexplored_band ------------//
+
+
+//---------- Begin of function ZoomMatrix::blacken_unexplored -----------//
+//
+// Blacken the unexplored area in the given rows of the zoom area. It
+// may be called from a worker thread of band_render, so it only writes
+// to those rows of vga_back.
+//
+// <int> row1, row2 - the first and last rows, 0 for the top row of the zoom area
+//
+void ZoomMatrix::blacken_unexplored(int row1, int row2)
 {
 	//----------- black out unexplored area -------------//
 
 	int leftLoc = top_x_loc;
-	int topLoc = top_y_loc;
+	int topLoc = top_y_loc + row1;
 	int rightLoc = leftLoc + disp_x_loc - 1;
-	int bottomLoc = topLoc + disp_y_loc - 1;
+	int bottomLoc = top_y_loc + row2;
 	int scrnY, scrnX;		// screen coordinate
 	int x, y;				// x,y Location
 	Location *thisRowLoc, *northRowLoc, *southRowLoc;
 
-	scrnY = ZOOM_Y1;
+	scrnY = ZOOM_Y1 + row1 * ZOOM_LOC_HEIGHT;
 	for( y = topLoc; y <= bottomLoc; ++y, scrnY += ZOOM_LOC_HEIGHT)
 	{
 		thisRowLoc = get_loc(leftLoc, y);
@@ -1137,12 +1667,41 @@ void ZoomMatrix::blacken_unexplored()
 
 //---------- Begin of function ZoomMatrix::blacken_fog_of_war -----------//
 //
+// The rows of the zoom area are blackened in bands by band_render.
+//
 void ZoomMatrix::blacken_fog_of_war()
+{
+#ifdef IMG_REENTRANT
+	band_render.run( blacken_fog_of_war_band, this, disp_y_loc );
+#else
+	blacken_fog_of_war( 0, disp_y_loc-1 );
+#endif
+}
+//---------- End of function ZoomMatrix::blacken_fog_of_war -----------//
+
+
+//---------- Begin of function ZoomMatrix::blacken_fog_of_war_band -----------//
+//
+void ZoomMatrix::blacken_fog_of_war_band(void* zoomMatrix, int row1, int row2)
+{
+	((ZoomMatrix*) zoomMatrix)->blacken_fog_of_war(row1, row2);
+}
+//---------- End of function ZoomMatrix::blacken_fog_of_war_band -----------//
+
+
+//---------- Begin of function ZoomMatrix::blacken_fog_of_war -----------//
+//
+// Darken the fogged area in the given rows of the zoom area, see
+// blacken_unexplored(int,int).
+//
+// <int> row1, row2 - the first and last rows, 0 for the top row of the zoom area
+//
+void ZoomMatrix::blacken_fog_of_war(int row1, int row2)
 {
 	int leftLoc = top_x_loc;
-	int topLoc = top_y_loc;
+	int topLoc = top_y_loc + row1;
 	int rightLoc = leftLoc + disp_x_loc - 1;
-	int bottomLoc = topLoc + disp_y_loc - 1;
+	int bottomLoc = top_y_loc + row2;
 	int scrnY, scrnX;		// screen coordinate
 	int x, y;				// x,y Location
 	Location *thisRowLoc, *northRowLoc, *southRowLoc;
@@ -1150,7 +1709,7 @@ void ZoomMatrix::blacken_fog_of_war()
 	if( config.fog_mask_method == 1)
 	{
 		// use fast method
-		scrnY = ZOOM_Y1;
+		scrnY = ZOOM_Y1 + row1 * ZOOM_LOC_HEIGHT;
 		for( y = topLoc; y <= bottomLoc; ++y, scrnY += ZOOM_LOC_HEIGHT)
 		{
 			thisRowLoc = get_loc(leftLoc,y);
@@ -1163,7 +1722,7 @@ void ZoomMatrix::blacken_fog_of_war()
 				}
 				else
 				{
-					unsigned char v = thisRowLoc->visibility();
+					unsigned char v = world.get_visibility(thisRowLoc);
 					if( v < MAX_VISIT_LEVEL-7)
 					{
 						// more visible draw 1/4 tone
@@ -1178,7 +1737,7 @@ void ZoomMatrix::blacken_fog_of_war()
 	else
 	{
 		// use slow method
-		scrnY = ZOOM_Y1;
+		scrnY = ZOOM_Y1 + row1 * ZOOM_LOC_HEIGHT;
 		for( y = topLoc; y <= bottomLoc; ++y, scrnY += ZOOM_LOC_HEIGHT)
 		{
 			thisRowLoc = get_loc(leftLoc, y);
@@ -1190,15 +1749,15 @@ void ZoomMatrix::blacken_fog_of_war()
 			unsigned char northRow[3];
 			unsigned char thisRow[3];
 			unsigned char southRow[3];
-			northRow[0] = northRowLoc->visibility();
-			thisRow[0] = thisRowLoc->visibility();
-			southRow[0] = southRowLoc->visibility();
+			northRow[0] = world.get_visibility(northRowLoc);
+			thisRow[0] = world.get_visibility(thisRowLoc);
+			southRow[0] = world.get_visibility(southRowLoc);
 
 			if( leftLoc > 0)
 			{
-				northRow[1] = (northRowLoc-1)->visibility();
-				thisRow[1] = (thisRowLoc-1)->visibility();
-				southRow[1] = (southRowLoc-1)->visibility();
+				northRow[1] = world.get_visibility(northRowLoc-1);
+				thisRow[1] = world.get_visibility(thisRowLoc-1);
+				southRow[1] = world.get_visibility(southRowLoc-1);
 			}
 			else
 			{
@@ -1219,9 +1778,9 @@ void ZoomMatrix::blacken_fog_of_war()
 				// shift in east squares of each row
 				if( x+1 < max_x_loc)
 				{
-					northRow[0] = (++northRowLoc)->visibility();
-					thisRow[0] = (++thisRowLoc)->visibility();
-					southRow[0] = (++southRowLoc)->visibility();
+					northRow[0] = world.get_visibility(++northRowLoc);
+					thisRow[0] = world.get_visibility(++thisRowLoc);
+					southRow[0] = world.get_visibility(++southRowLoc);
 				}
 				// if on the east of the map, simply replicate the eastest square
 
@@ -1943,7 +2502,7 @@ void ZoomMatrix::put_bitmap_clip(int x, int y, char* bitmapPtr, int compressedFl
 	{
 		if( compressedFlag )
 		{
-			vga_back.put_bitmap_area_trans_decompress( x, y, bitmapPtr,
+			sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, bitmapPtr,
 				MAX(ZOOM_X1,x)-x, MAX(ZOOM_Y1,y)-y, MIN(ZOOM_X2,x2)-x, MIN(ZOOM_Y2,y2)-y );
 		}
 		else
@@ -1958,7 +2517,7 @@ void ZoomMatrix::put_bitmap_clip(int x, int y, char* bitmapPtr, int compressedFl
 	else
 	{
 		if( compressedFlag )
-			vga_back.put_bitmap_trans_decompress( x, y, bitmapPtr );
+			sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, bitmapPtr );
 		else
 			vga_back.put_bitmap_trans( x, y, bitmapPtr );
 	}
@@ -2037,12 +2596,12 @@ void ZoomMatrix::put_bitmap_remap_clip(int x, int y, char* bitmapPtr, char* colo
 		{
 			if( colorRemapTable )
 			{
-				vga_back.put_bitmap_area_trans_remap_decompress( x, y, bitmapPtr,
+				sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, bitmapPtr,
 					MAX(ZOOM_X1,x)-x, MAX(ZOOM_Y1,y)-y, MIN(ZOOM_X2,x2)-x, MIN(ZOOM_Y2,y2)-y, colorRemapTable );
 			}
 			else
 			{
-				vga_back.put_bitmap_area_trans_decompress( x, y, bitmapPtr,
+				sprite_span_cache.put_bitmap_area( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, bitmapPtr,
 					MAX(ZOOM_X1,x)-x, MAX(ZOOM_Y1,y)-y, MIN(ZOOM_X2,x2)-x, MIN(ZOOM_Y2,y2)-y );
 			}
 		}
@@ -2068,9 +2627,9 @@ void ZoomMatrix::put_bitmap_remap_clip(int x, int y, char* bitmapPtr, char* colo
 		if( compressedFlag )
 		{
 			if( colorRemapTable )
-				vga_back.put_bitmap_trans_remap_decompress( x, y, bitmapPtr, colorRemapTable );
+				sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, bitmapPtr, colorRemapTable );
 			else
-				vga_back.put_bitmap_trans_decompress( x, y, bitmapPtr );
+				sprite_span_cache.put_bitmap( vga_back.buf_ptr(), vga_back.buf_pitch(), x, y, bitmapPtr );
 		}
 		else
 		{
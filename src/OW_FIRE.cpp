@@ -116,10 +116,37 @@ void World::init_fire()
 // ----------- end of function World::init_fire ---------- //
 
 
+// ----------- begin of function World::build_fire_set ---------- //
+//
+// Find all the locations which are not idle. Called when the map is
+// assigned, after that the set is kept by update_fire_loc().
+//
+void World::build_fire_set()
+{
+	memset( fire_loc_matrix, 0, max_x_loc * max_y_loc );
+	memset( fire_row_count_array, 0, max_y_loc * SCAN_FIRE_DIST * sizeof(short) );
+	fire_loc_count = 0;
+
+	Location *locPtr = loc_matrix;
+
+	for( int c = max_x_loc*max_y_loc; c >0; --c, ++locPtr)
+		update_fire_loc(locPtr);
+}
+// ----------- end of function World::build_fire_set ---------- //
+
+
 // ----------- begin of function World::spread_fire ---------- //
+//
+// An idle location is left unchanged by the update below and doesn't call
+// misc.random(), so only the locations in fire_loc_matrix are visited. They
+// are visited in the same order as the full scan, so that the result and
+// the random seed are the same as when every location is updated.
+//
 void World::spread_fire(Weather &w)
 {
-	
+	if( !fire_loc_count )
+		return;
+
 	char fireValue;
 	int x,y;
 	Location *locPtr;
@@ -137,9 +164,15 @@ void World::spread_fire(Weather &w)
 	// -------------update fire_level-----------
 	for( y = scan_fire_y; y < max_y_loc; y += SCAN_FIRE_DIST)
 	{
+		if( !fire_row_count_array[y*SCAN_FIRE_DIST + scan_fire_x] )
+			continue;
+
 		locPtr = get_loc(scan_fire_x,y);
 		for( x = scan_fire_x; x < max_x_loc; x += SCAN_FIRE_DIST, locPtr+=SCAN_FIRE_DIST)
 		{
+			if( !fire_loc_matrix[locPtr-loc_matrix] )
+				continue;
+
 			char oldFireValue = fireValue = locPtr->fire_str();
 			char flammability = locPtr->fire_src();
 
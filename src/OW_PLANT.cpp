@@ -31,6 +31,7 @@
 #include <ALL.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 //------------ Define constant ---------------//
@@ -61,6 +62,71 @@ void World::plant_ops()
 }
 //----------- End of function World::plant_ops -----------//
 
+
+//------------ begin of function World::build_plant_set ------------//
+//
+// Register the plants on the map in plant_loc_bits. Called when the map
+// is assigned, after that the bits are kept by update_plant_loc().
+//
+void World::build_plant_set()
+{
+	memset( plant_loc_bits, 0, plant_bits_pitch * max_y_loc * sizeof(uint32_t) );
+
+	Location *locPtr = loc_matrix;
+
+	for( int c = max_x_loc*max_y_loc; c >0; --c, ++locPtr)
+	{
+		if( locPtr->is_plant() )
+			update_plant_loc(locPtr, 1);
+	}
+}
+//------------ end of function World::build_plant_set ------------//
+
+
+//------------ begin of function World::next_plant_x ------------//
+//
+// The sampling functions below only call misc.random() on the locations
+// with plants. Skip the sampled locations of a row which have no plant,
+// so that the same locations are processed in the same order as when
+// every sampled location is looked at.
+//
+// <int> xLoc        - the first sampled location of the row to check
+// <int> yLoc        - the row
+// <int> scanDensity - the distance between the sampled locations
+//
+// return : <int> the x location of the next sampled location which may
+//                have a plant, max_x_loc or over if there is none
+//
+int World::next_plant_x(int xLoc, int yLoc, int scanDensity)
+{
+	if( !plant_loc_bits || plant_full_scan )
+		return xLoc;
+
+	uint32_t* rowBits = plant_loc_bits + yLoc * plant_bits_pitch;
+
+	while( xLoc < max_x_loc )
+	{
+		uint32_t word = rowBits[xLoc >> 5];
+
+		if( !word )
+		{
+			// jump to the first sampled location of the next word
+
+			int nextWordX = ((xLoc >> 5) + 1) << 5;
+			xLoc += (nextWordX - xLoc + scanDensity - 1) / scanDensity * scanDensity;
+			continue;
+		}
+
+		if( word & (1u << (xLoc & 31)) )
+			break;
+
+		xLoc += scanDensity;
+	}
+
+	return xLoc;
+}
+//------------ end of function World::next_plant_x ------------//
+
 //------------ begin of function World::plant_grow ------------//
 //
 // pGrow = prabability of grow, range from 0 to 100
@@ -72,7 +138,7 @@ void World::plant_grow(int pGrow, int scanDensity)
 	int yBase = misc.random(scanDensity);
 	int xBase = misc.random(scanDensity);
 	for( int y = yBase; y < max_y_loc; y += scanDensity)
-		for( int x = xBase; x < max_x_loc; x += scanDensity)
+		for( int x = next_plant_x(xBase, y, scanDensity); x < max_x_loc; x = next_plant_x(x+scanDensity, y, scanDensity))
 		{
 			Location *l = get_loc(x,y);
 			short bitmapId, basePlantId;
@@ -110,7 +176,7 @@ void World::plant_reprod(int pReprod, int scanDensity)
 	int xBase = misc.random(scanDensity);
 	for( int y = yBase; y < max_y_loc; y += scanDensity)
 	{
-		for( int x = xBase; x < max_x_loc; x += scanDensity)
+		for( int x = next_plant_x(xBase, y, scanDensity); x < max_x_loc; x = next_plant_x(x+scanDensity, y, scanDensity))
 		{
 			Location *l = get_loc(x,y);
 			short bitmapId, basePlantId, plantGrade;
@@ -279,7 +345,7 @@ void World::plant_death(int scanDensity)
 	int xBase = misc.random(scanDensity);
 	for( int y = yBase; y < max_y_loc; y += scanDensity)
 	{
-		for( int x = xBase; x < max_x_loc; x += scanDensity)
+		for( int x = next_plant_x(xBase, y, scanDensity); x < max_x_loc; x = next_plant_x(x+scanDensity, y, scanDensity))
 		{
 			Location *locPtr = get_loc(x,y);
 			if( locPtr->is_plant() )
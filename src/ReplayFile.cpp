@@ -21,6 +21,7 @@
 //Filename    : ReplayFile.cpp
 //Description : Replay File IO
 
+#include <stdio.h>
 #include <string.h>
 
 #include <ReplayFile.h>
@@ -31,6 +32,7 @@
 #include <OREMOTEQ.h>
 #include <version.h>
 #include <ConfigAdv.h>
+#include <CmdLine.h>
 #include <OBOX.h>
 #include <gettext.h>
 
@@ -112,7 +114,10 @@ int ReplayFile::open_read(const char* filePath, NewNationPara *mpGame, int *mpPl
 	file_version = file.file_get_long();
 	if( file_version > replay_version )
 	{
-		box.msg(_("The selected replay file uses an unsupported format."));
+		if( cmd_line.enable_if )
+			box.msg(_("The selected replay file uses an unsupported format."));
+		else
+			printf("%s\n", _("The selected replay file uses an unsupported format."));
 		goto out;
 	}
 	if( !file.file_read(&version, sizeof(GameVer)) )
@@ -123,7 +128,10 @@ int ReplayFile::open_read(const char* filePath, NewNationPara *mpGame, int *mpPl
 	{
 		String msg;
 		sprintf(msg, _("Replay version %u.%u.%u.%u.%u mismatches with current game version %u.%u.%u.%u.%u"), version.ver1, version.ver2, version.ver3, version.flags, ver_cksum, current_version.ver1, current_version.ver2, current_version.ver3, current_version.flags, config_adv.checksum);
-		box.msg(msg);
+		if( cmd_line.enable_if )
+			box.msg(msg);
+		else
+			printf("%s\n", (char*) msg);
 	}
 	if( file_version > 0 )
 		frame_delay = file.file_get_long();
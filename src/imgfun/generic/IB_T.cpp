@@ -28,6 +28,10 @@
 #include <IMGFUN.h>
 #include <COLCODE.h>
 
+#ifdef IMG_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 
 //-------- BEGIN OF FUNCTION IMGbltTrans ----------
 //
@@ -62,7 +66,24 @@ void IMGcall IMGbltTrans(char* imageBuf, int pitch, int x, int y, char* bitmapPt
 
 	for ( int j=0; j<height; ++j, destline+=pitch, srcline+=width )
 	{
-		for ( int i=0; i<width; ++i )
+		int i=0;
+
+#ifdef IMG_USE_SSE2
+		// 16 pixels at a time, keep the destination where the source is transparent
+		const __m128i transCode = _mm_set1_epi8((char)TRANSPARENT_CODE);
+
+		for ( ; i+16<=width && !IMGreferenceFlag; i+=16 )
+		{
+			__m128i src = _mm_loadu_si128((const __m128i*)(bitmapPtr + srcline + i));
+			__m128i dest = _mm_loadu_si128((const __m128i*)(imageBuf + destline + i));
+			__m128i transMask = _mm_cmpeq_epi8(src, transCode);
+
+			dest = _mm_or_si128(_mm_and_si128(transMask, dest), _mm_andnot_si128(transMask, src));
+			_mm_storeu_si128((__m128i*)(imageBuf + destline + i), dest);
+		}
+#endif
+
+		for ( ; i<width; ++i )
 		{
 			al = ((unsigned char*)bitmapPtr)[ srcline + i ];
 			if (al != TRANSPARENT_CODE)
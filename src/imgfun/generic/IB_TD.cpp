@@ -25,6 +25,7 @@
  */
 
 
+#include <string.h>
 #include <IMGFUN.h>
 #include <COLCODE.h>
 
@@ -92,12 +93,30 @@ void IMGcall IMGbltTransDecompress(char* imageBuf, int pitch, int desX, int desY
 				i += pixelsToSkip;
 				pixelsToSkip = 0;
 			}
-			al = ((unsigned char*)bitmapBuf)[ esi++ ];		// load source byte
+			al = ((unsigned char*)bitmapBuf)[ esi ];		// load source byte
 			if (al < MIN_TRANSPARENT_CODE)
 			{
-				imageBuf[ destline + i ] = al;	// normal pixel
+				if (IMGreferenceFlag)
+				{
+					imageBuf[ destline + i ] = al;	// normal pixel
+					++esi;
+					continue;
+				}
+
+				// copy the whole run of normal pixels in this line at once
+				int runLen = 1;
+				while( i+runLen < width &&
+						 ((unsigned char*)bitmapBuf)[ esi+runLen ] < MIN_TRANSPARENT_CODE )
+				{
+					++runLen;
+				}
+				memcpy( imageBuf + destline + i, bitmapBuf + esi, runLen );
+				esi += runLen;
+				i += runLen-1;
+				continue;
 			}
-			else if (al == MANY_TRANSPARENT_CODE)
+			++esi;
+			if (al == MANY_TRANSPARENT_CODE)
 			{
 				pixelsToSkip = ((unsigned char*)bitmapBuf)[ esi++ ] -1;		// skip many pixels
 			}
@@ -27,6 +27,10 @@
 #include <IMGFUN.h>
 #include <COLCODE.h>
 
+#ifdef IMG_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 
 //----------- BEGIN OF FUNCTION IMBbltTransRemap ------------
 //
@@ -63,6 +67,19 @@ void IMGcall IMGbltTransRemap(char* imageBuf, int pitch, int x, int y, char* bit
 	{
 		for ( int i=0; i<bitmapWidth; ++i )
 		{
+#ifdef IMG_USE_SSE2
+			// skip 16 transparent pixels at once, the remapping itself is a table lookup per pixel
+			if ( (i&15)==0 && i+16<=bitmapWidth && !IMGreferenceFlag )
+			{
+				__m128i src = _mm_loadu_si128((const __m128i*)(bitmapBuf + esi + i));
+
+				if ( _mm_movemask_epi8(_mm_cmpeq_epi8(src, _mm_set1_epi8((char)TRANSPARENT_CODE))) == 0xFFFF )
+				{
+					i += 15;
+					continue;
+				}
+			}
+#endif
 			if ( ((unsigned char*)bitmapBuf)[esi + i] != TRANSPARENT_CODE)
 			{
 				imageBuf[destline + i] = colorTable[ bitmapBuf[esi+i] ];